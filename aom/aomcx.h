@@ -1166,7 +1166,49 @@ enum aome_enc_control_id {
   /*!\brief Codec control function to set reference frame config:
    * the ref_idx and the refresh flags for each buffer slot.
    */
-  AV1E_SET_SVC_REF_FRAME_CONFIG = 152
+  AV1E_SET_SVC_REF_FRAME_CONFIG = 152,
+
+  /*!\brief Codec control function to set the wall-clock time budget of each
+   * frame, in microseconds.
+   *
+   * When non-zero, the encoder measures the time it spends on each frame and
+   * tightens its speed features beyond those of the cpu-used setting while it
+   * runs over the budget, or relaxes them back when it runs well under it.
+   * The time is checked after each superblock row when a single thread codes
+   * the frame, otherwise between frames. 0 (default) disables the budget.
+   */
+  AV1E_SET_FRAME_TIME_BUDGET = 153,
+
+  /*!\brief Codec control function to get how the encoder kept to the frame
+   * time budget, aom_time_budget_stats_t* parameter.
+   */
+  AV1E_GET_TIME_BUDGET_STATS = 154,
+
+  /*!\brief Codec control function to pass the coding decisions a previous
+   * encode of the source made, aom_block_hint_map_t* parameter.
+   *
+   * A transcoder can take the block sizes, reference frames and motion vectors
+   * of the stream it decodes (see av1/decoder/inspection.h) and pass them
+   * before each frame. The hints apply to the next frame passed to
+   * aom_codec_encode() and are scaled to the coded resolution. They prune the
+   * partition search and seed the motion search. The reference frames are
+   * matched by name, so the motion vectors are only of use when the hinted
+   * stream was coded with the same GOP structure. The hints are copied. A map
+   * with NULL hints clears them.
+   */
+  AV1E_SET_BLOCK_HINTS = 155,
+
+  /*!\brief Codec control function to pass the analysis of the source made
+   * ahead of the encoder, aom_analysis_hints_t* parameter.
+   *
+   * The hints apply to the next frame passed to aom_codec_encode(). A scene
+   * cut forces a key frame. The motion vectors seed the motion search of the
+   * first pass and of the encode, extrapolated to the distance of each
+   * reference. The partition depths replace the variance analysis of the
+   * real-time mode partitioning, used from cpu-used 6. Either array may be
+   * NULL. The hints are copied.
+   */
+  AV1E_SET_ANALYSIS_HINTS = 156
 };
 
 /*!\brief aom 1-D scaling mode
@@ -1289,6 +1331,71 @@ typedef struct aom_svc_ref_frame_config {
   int refresh[8]; /**< Refresh flag for each of the 8 slots. */
 } aom_svc_ref_frame_config_t;
 
+/*!brief Statistics of the frame time budget, see AV1E_SET_FRAME_TIME_BUDGET */
+typedef struct aom_time_budget_stats {
+  unsigned int frames;             /**< Frames coded with a budget */
+  unsigned int frames_over_budget; /**< Frames that took longer */
+  /*! Times the speed features were tightened, in the middle of a frame or
+   * between frames */
+  unsigned int escalations;
+  /*! Those of the escalations made in the middle of a frame */
+  unsigned int mid_frame_escalations;
+  unsigned int relaxations; /**< Times the speed features were relaxed */
+  int level; /**< Current tightening, 0 for the cpu-used setting alone */
+  int64_t max_frame_time; /**< Longest frame, in microseconds */
+} aom_time_budget_stats_t;
+
+/*!brief Coding decisions of a 4x4 block, see AV1E_SET_BLOCK_HINTS */
+typedef struct aom_block_hint {
+  int16_t mv_row; /**< Motion vector of the first reference, in 1/8 pel */
+  int16_t mv_col; /**< Motion vector of the first reference, in 1/8 pel */
+  /*! First reference frame, 0 for intra or 1 (LAST_FRAME) to 7
+   * (ALTREF_FRAME) */
+  int8_t ref_frame;
+  uint8_t block_width;  /**< Width of the coded block, in pixels */
+  uint8_t block_height; /**< Height of the coded block, in pixels */
+} aom_block_hint_t;
+
+/*!brief Coding decisions of a frame, see AV1E_SET_BLOCK_HINTS */
+typedef struct aom_block_hint_map {
+  /*! rows * cols hints, in raster order */
+  aom_block_hint_t *hints;
+  unsigned int rows;   /**< Number of 4x4 block rows, (height + 3) / 4 */
+  unsigned int cols;   /**< Number of 4x4 block columns, (width + 3) / 4 */
+  unsigned int width;  /**< Width of the hinted frame */
+  unsigned int height; /**< Height of the hinted frame */
+} aom_block_hint_map_t;
+
+/*!brief Motion vector of a 16x16 block, see AV1E_SET_ANALYSIS_HINTS */
+typedef struct aom_analysis_mv {
+  int16_t row; /**< Vertical motion to the previous frame, in 1/8 pel */
+  int16_t col; /**< Horizontal motion to the previous frame, in 1/8 pel */
+} aom_analysis_mv_t;
+
+/*!brief Row of the motion vector of a block the analysis has none for */
+#define AOM_ANALYSIS_NO_MV INT16_MIN
+
+/*!brief Depth of a 64x64 block the analysis has none for */
+#define AOM_ANALYSIS_NO_DEPTH 255
+
+/*!brief Analysis of a source frame, see AV1E_SET_ANALYSIS_HINTS */
+typedef struct aom_analysis_hints {
+  /*! mv_rows * mv_cols motion vectors of the 16x16 blocks, in raster order,
+   * or NULL */
+  aom_analysis_mv_t *mvs;
+  unsigned int mv_rows; /**< Number of 16x16 block rows, (height + 15) / 16 */
+  unsigned int mv_cols; /**< Number of 16x16 block columns, (width + 15) / 16 */
+  /*! depth_rows * depth_cols partition depths of the 64x64 blocks, in raster
+   * order, or NULL. 0 codes a 64x64 block whole and 3 splits it down to 8x8
+   * blocks. */
+  uint8_t *depths;
+  /*! Number of 64x64 block rows, (height + 63) / 64 */
+  unsigned int depth_rows;
+  /*! Number of 64x64 block columns, (width + 63) / 64 */
+  unsigned int depth_cols;
+  int scene_cut; /**< Nonzero if the frame starts a new scene */
+} aom_analysis_hints_t;
+
 /*!\cond */
 /*!\brief Encoder control function parameter type
  *
@@ -1648,6 +1755,18 @@ AOM_CTRL_USE_TYPE(AV1E_SET_SVC_PARAMS, aom_svc_params_t *)
 AOM_CTRL_USE_TYPE(AV1E_SET_SVC_REF_FRAME_CONFIG, aom_svc_ref_frame_config_t *)
 #define AOME_CTRL_AV1E_SET_SVC_REF_FRAME_CONFIG
 
+AOM_CTRL_USE_TYPE(AV1E_SET_FRAME_TIME_BUDGET, unsigned int)
+#define AOM_CTRL_AV1E_SET_FRAME_TIME_BUDGET
+
+AOM_CTRL_USE_TYPE(AV1E_GET_TIME_BUDGET_STATS, aom_time_budget_stats_t *)
+#define AOM_CTRL_AV1E_GET_TIME_BUDGET_STATS
+
+AOM_CTRL_USE_TYPE(AV1E_SET_BLOCK_HINTS, aom_block_hint_map_t *)
+#define AOM_CTRL_AV1E_SET_BLOCK_HINTS
+
+AOM_CTRL_USE_TYPE(AV1E_SET_ANALYSIS_HINTS, aom_analysis_hints_t *)
+#define AOM_CTRL_AV1E_SET_ANALYSIS_HINTS
+
 /*!\endcond */
 /*! @} - end defgroup aom_encoder */
 #ifdef __cplusplus
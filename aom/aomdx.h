@@ -252,6 +252,41 @@ enum aom_dec_control_id {
    */
   AV1D_SET_SKIP_FILM_GRAIN,
 
+  /** control function to enable the low-memory decoding mode. The argument
+   * is an unsigned int. When nonzero, the decoder uses the smallest frame
+   * border the stream's superblock size allows, returns the memory of frame
+   * buffers that are no longer referenced to the system and frees the row-MT
+   * block buffers after every frame. This trades some speed for a smaller
+   * footprint. Takes effect for frames decoded after the call. The default
+   * value is 0. The internal frame buffers are only freed when no external
+   * frame buffer functions are set.
+   */
+  AV1D_SET_LOW_MEMORY,
+
+  /** control function to get the peak number of bytes held by the decoder's
+   * frame buffers and per-frame working buffers since the decoder instance
+   * was created. The argument is a pointer to a uint64_t.
+   */
+  AV1D_GET_PEAK_MEM_USAGE,
+
+  /** control function to set a downscaling factor for the output frames.
+   * The argument is an unsigned int and must be 1 (no downscaling, the
+   * default), 2, 4 or 8. The decoded frames, after all in-loop filters and
+   * super-resolution, are downscaled by this factor in each dimension before
+   * they are returned by aom_codec_get_frame(); the reference frames are not
+   * affected. Intended for generating thumbnails and previews. Has no effect
+   * in large scale tile mode.
+   */
+  AV1D_SET_OUTPUT_DOWNSCALE,
+
+  /** control function to only decode temporal units that contain a key
+   * frame. The argument is an int. When nonzero, aom_codec_decode() inspects
+   * the OBU headers of each temporal unit and returns AOM_CODEC_OK without
+   * decoding or outputting anything if no key frame is found. Not supported
+   * for Annex-B bitstreams. The default value is 0.
+   */
+  AV1D_SET_KEYFRAMES_ONLY,
+
   AOM_DECODER_CTRL_ID_MAX,
 };
 
@@ -305,6 +340,14 @@ AOM_CTRL_USE_TYPE(AV1D_SET_ROW_MT, unsigned int)
 #define AOM_CTRL_AV1D_SET_ROW_MT
 AOM_CTRL_USE_TYPE(AV1D_SET_SKIP_FILM_GRAIN, int)
 #define AOM_CTRL_AV1D_SET_SKIP_FILM_GRAIN
+AOM_CTRL_USE_TYPE(AV1D_SET_LOW_MEMORY, unsigned int)
+#define AOM_CTRL_AV1D_SET_LOW_MEMORY
+AOM_CTRL_USE_TYPE(AV1D_GET_PEAK_MEM_USAGE, uint64_t *)
+#define AOM_CTRL_AV1D_GET_PEAK_MEM_USAGE
+AOM_CTRL_USE_TYPE(AV1D_SET_OUTPUT_DOWNSCALE, unsigned int)
+#define AOM_CTRL_AV1D_SET_OUTPUT_DOWNSCALE
+AOM_CTRL_USE_TYPE(AV1D_SET_KEYFRAMES_ONLY, int)
+#define AOM_CTRL_AV1D_SET_KEYFRAMES_ONLY
 AOM_CTRL_USE_TYPE(AV1D_SET_IS_ANNEXB, unsigned int)
 #define AOM_CTRL_AV1D_SET_IS_ANNEXB
 AOM_CTRL_USE_TYPE(AV1D_SET_OPERATING_POINT, int)
@@ -109,6 +109,7 @@ list(APPEND AOM_DSP_COMMON_INTRIN_AVX2
             "${AOM_ROOT}/aom_dsp/x86/convolve_avx2.h"
             "${AOM_ROOT}/aom_dsp/x86/fft_avx2.c"
             "${AOM_ROOT}/aom_dsp/x86/highbd_convolve_avx2.c"
+            "${AOM_ROOT}/aom_dsp/x86/highbd_intrapred_avx2.c"
             "${AOM_ROOT}/aom_dsp/x86/highbd_loopfilter_avx2.c"
             "${AOM_ROOT}/aom_dsp/x86/intrapred_avx2.c"
             "${AOM_ROOT}/aom_dsp/x86/blend_a64_mask_avx2.c"
@@ -118,6 +119,7 @@ list(APPEND AOM_DSP_COMMON_INTRIN_AVX2
 if(NOT CONFIG_AV1_HIGHBITDEPTH)
   list(REMOVE_ITEM AOM_DSP_COMMON_INTRIN_AVX2
                    "${AOM_ROOT}/aom_dsp/x86/highbd_convolve_avx2.c"
+                   "${AOM_ROOT}/aom_dsp/x86/highbd_intrapred_avx2.c"
                    "${AOM_ROOT}/aom_dsp/x86/highbd_loopfilter_avx2.c")
 endif()
 
@@ -247,6 +249,14 @@ if(CONFIG_AV1_ENCODER)
               "${AOM_ROOT}/aom_dsp/x86/obmc_variance_avx2.c"
               "${AOM_ROOT}/aom_dsp/x86/blk_sse_sum_avx2.c"
               "${AOM_ROOT}/aom_dsp/x86/sum_squares_avx2.c")
+  if(NOT CONFIG_AV1_HIGHBITDEPTH)
+    list(REMOVE_ITEM AOM_DSP_ENCODER_INTRIN_AVX2
+                     "${AOM_ROOT}/aom_dsp/x86/highbd_variance_avx2.c")
+  endif()
+
+  list(APPEND AOM_DSP_ENCODER_INTRIN_AVX512
+              "${AOM_ROOT}/aom_dsp/x86/sad4d_avx512.c"
+              "${AOM_ROOT}/aom_dsp/x86/variance_avx512.c")
 
   list(APPEND AOM_DSP_ENCODER_AVX_ASM_X86_64
               "${AOM_ROOT}/aom_dsp/x86/quantize_avx_x86_64.asm")
@@ -288,6 +298,8 @@ if(CONFIG_AV1_ENCODER)
     list(APPEND AOM_DSP_ENCODER_SOURCES "${AOM_ROOT}/aom_dsp/fastssim.c"
                 "${AOM_ROOT}/aom_dsp/psnrhvs.c" "${AOM_ROOT}/aom_dsp/ssim.c"
                 "${AOM_ROOT}/aom_dsp/ssim.h")
+    list(APPEND AOM_DSP_ENCODER_INTRIN_AVX2
+                "${AOM_ROOT}/aom_dsp/x86/ssim_avx2.c")
   endif()
 endif()
 
@@ -373,6 +385,12 @@ function(setup_aom_dsp_targets)
     endif()
   endif()
 
+  if(HAVE_AVX512 AND CONFIG_AV1_ENCODER)
+    add_intrinsics_object_library("${AOM_AVX512_INTRIN_FLAGS}" "avx512"
+                                  "aom_dsp_encoder"
+                                  "AOM_DSP_ENCODER_INTRIN_AVX512" "aom")
+  endif()
+
   if(HAVE_NEON)
     add_intrinsics_object_library("${AOM_NEON_INTRIN_FLAG}" "neon"
                                   "aom_dsp_common" "AOM_DSP_COMMON_INTRIN_NEON"
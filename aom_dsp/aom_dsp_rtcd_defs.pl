@@ -348,6 +348,15 @@ if (aom_config("CONFIG_AV1_HIGHBITDEPTH") eq "yes") {
   specialize qw/aom_highbd_dc_left_predictor_32x32 sse2/;
   specialize qw/aom_highbd_dc_top_predictor_32x32 sse2/;
   specialize qw/aom_highbd_dc_128_predictor_32x32 sse2/;
+
+  # AVX2 versions of all the predictors of blocks at least 16 pixels wide.
+  foreach (@tx_sizes) {
+    ($w, $h) = @$_;
+    next if ($w < 16);
+    foreach $pred_name (@pred_names) {
+      specialize "aom_highbd_${pred_name}_predictor_${w}x${h}", "avx2";
+    }
+  }
 }
 #
 # Sub Pixel Filters
@@ -577,9 +586,9 @@ if (aom_config("CONFIG_AV1_HIGHBITDEPTH") eq "yes") {
   add_proto qw/void aom_highbd_blend_a64_hmask/, "uint8_t *dst, uint32_t dst_stride, const uint8_t *src0, uint32_t src0_stride, const uint8_t *src1, uint32_t src1_stride, const uint8_t *mask, int w, int h, int bd";
   add_proto qw/void aom_highbd_blend_a64_vmask/, "uint8_t *dst, uint32_t dst_stride, const uint8_t *src0, uint32_t src0_stride, const uint8_t *src1, uint32_t src1_stride, const uint8_t *mask, int w, int h, int bd";
   add_proto qw/void aom_highbd_blend_a64_d16_mask/, "uint8_t *dst, uint32_t dst_stride, const CONV_BUF_TYPE *src0, uint32_t src0_stride, const CONV_BUF_TYPE *src1, uint32_t src1_stride, const uint8_t *mask, uint32_t mask_stride, int w, int h, int subw, int subh, ConvolveParams *conv_params, const int bd";
-  specialize "aom_highbd_blend_a64_mask", qw/sse4_1/;
-  specialize "aom_highbd_blend_a64_hmask", qw/sse4_1/;
-  specialize "aom_highbd_blend_a64_vmask", qw/sse4_1/;
+  specialize "aom_highbd_blend_a64_mask", qw/sse4_1 avx2/;
+  specialize "aom_highbd_blend_a64_hmask", qw/sse4_1 avx2/;
+  specialize "aom_highbd_blend_a64_vmask", qw/sse4_1 avx2/;
   specialize "aom_highbd_blend_a64_d16_mask", qw/sse4_1 avx2/;
 }
 
@@ -841,6 +850,13 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   specialize qw/aom_sad32x8x4d  sse2/;
   specialize qw/aom_sad64x16x4d sse2/;
 
+  # AVX-512 versions of the blocks at least 64 pixels wide.
+  foreach (@block_sizes) {
+    ($w, $h) = @$_;
+    next if ($w < 64);
+    specialize "aom_sad${w}x${h}x4d", "avx512";
+  }
+
   #
   # Multi-block SAD, comparing a reference to N independent blocks
   #
@@ -934,13 +950,14 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   #
   if (aom_config("CONFIG_INTERNAL_STATS") eq "yes") {
     add_proto qw/void aom_ssim_parms_8x8/, "const uint8_t *s, int sp, const uint8_t *r, int rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr";
-    specialize qw/aom_ssim_parms_8x8/, "$sse2_x86_64";
+    specialize qw/aom_ssim_parms_8x8 avx2/, "$sse2_x86_64";
 
     add_proto qw/void aom_ssim_parms_16x16/, "const uint8_t *s, int sp, const uint8_t *r, int rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr";
-    specialize qw/aom_ssim_parms_16x16/, "$sse2_x86_64";
+    specialize qw/aom_ssim_parms_16x16 avx2/, "$sse2_x86_64";
 
     if (aom_config("CONFIG_AV1_HIGHBITDEPTH") eq "yes") {
       add_proto qw/void aom_highbd_ssim_parms_8x8/, "const uint16_t *s, int sp, const uint16_t *r, int rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr";
+      specialize qw/aom_highbd_ssim_parms_8x8 avx2/;
     }
   }
 }  # CONFIG_AV1_ENCODER
@@ -1124,6 +1141,14 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   specialize qw/aom_sub_pixel_avg_variance16x64 sse2 ssse3/;
   specialize qw/aom_sub_pixel_avg_variance64x16 sse2 ssse3/;
 
+  # AVX-512 versions of the blocks at least 64 pixels wide.
+  foreach (@block_sizes) {
+    ($w, $h) = @$_;
+    next if ($w < 64);
+    specialize "aom_variance${w}x${h}", "avx512";
+    specialize "aom_sub_pixel_variance${w}x${h}", "avx512";
+  }
+
   specialize qw/aom_dist_wtd_sub_pixel_avg_variance64x64 ssse3/;
   specialize qw/aom_dist_wtd_sub_pixel_avg_variance64x32 ssse3/;
   specialize qw/aom_dist_wtd_sub_pixel_avg_variance32x64 ssse3/;
@@ -1436,9 +1461,10 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
     specialize qw/aom_highbd_12_mse8x8 sse2/;
 
     add_proto qw/void aom_highbd_comp_avg_pred/, "uint8_t *comp_pred8, const uint8_t *pred8, int width, int height, const uint8_t *ref8, int ref_stride";
+    specialize qw/aom_highbd_comp_avg_pred avx2/;
 
     add_proto qw/void aom_highbd_dist_wtd_comp_avg_pred/, "uint8_t *comp_pred8, const uint8_t *pred8, int width, int height, const uint8_t *ref8, int ref_stride, const DIST_WTD_COMP_PARAMS *jcp_param";
-    specialize qw/aom_highbd_dist_wtd_comp_avg_pred sse2/;
+    specialize qw/aom_highbd_dist_wtd_comp_avg_pred sse2 avx2/;
   }
     #
     # Subpixel Variance
@@ -138,6 +138,27 @@ static void fs_downsample_level(fs_ctx *_ctx, int _l) {
   }
 }
 
+/*Sums the 2x2 neighbourhoods of a pair of source rows. Since w is
+ (_w + 1) >> 1, the right column of a neighbourhood never needs clamping,
+ which lets these loops vectorize.*/
+static void fs_downsample_row(uint32_t *dst, const uint8_t *src0,
+                              const uint8_t *src1, int w) {
+  int i;
+  for (i = 0; i < w; i++) {
+    dst[i] = src0[2 * i] + src0[2 * i + 1] + src1[2 * i] + src1[2 * i + 1];
+  }
+}
+
+static void fs_downsample_row_hbd(uint32_t *dst, const uint16_t *src0,
+                                  const uint16_t *src1, int w,
+                                  uint32_t shift) {
+  int i;
+  for (i = 0; i < w; i++) {
+    dst[i] = (src0[2 * i] >> shift) + (src0[2 * i + 1] >> shift) +
+             (src1[2 * i] >> shift) + (src1[2 * i + 1] >> shift);
+  }
+}
+
 static void fs_downsample_level0(fs_ctx *_ctx, const uint8_t *_src1,
                                  int _s1ystride, const uint8_t *_src2,
                                  int _s2ystride, int _w, int _h, uint32_t shift,
@@ -146,41 +167,30 @@ static void fs_downsample_level0(fs_ctx *_ctx, const uint8_t *_src1,
   uint32_t *dst2;
   int w;
   int h;
-  int i;
   int j;
   w = _ctx->level[0].w;
   h = _ctx->level[0].h;
   dst1 = _ctx->level[0].im1;
   dst2 = _ctx->level[0].im2;
+  assert(w == (_w + 1) >> 1);
+  (void)_w;
   for (j = 0; j < h; j++) {
     int j0;
     int j1;
     j0 = 2 * j;
     j1 = FS_MINI(j0 + 1, _h);
-    for (i = 0; i < w; i++) {
-      int i0;
-      int i1;
-      i0 = 2 * i;
-      i1 = FS_MINI(i0 + 1, _w);
-      if (!buf_is_hbd) {
-        dst1[j * w + i] =
-            _src1[j0 * _s1ystride + i0] + _src1[j0 * _s1ystride + i1] +
-            _src1[j1 * _s1ystride + i0] + _src1[j1 * _s1ystride + i1];
-        dst2[j * w + i] =
-            _src2[j0 * _s2ystride + i0] + _src2[j0 * _s2ystride + i1] +
-            _src2[j1 * _s2ystride + i0] + _src2[j1 * _s2ystride + i1];
-      } else {
-        uint16_t *src1s = CONVERT_TO_SHORTPTR(_src1);
-        uint16_t *src2s = CONVERT_TO_SHORTPTR(_src2);
-        dst1[j * w + i] = (src1s[j0 * _s1ystride + i0] >> shift) +
-                          (src1s[j0 * _s1ystride + i1] >> shift) +
-                          (src1s[j1 * _s1ystride + i0] >> shift) +
-                          (src1s[j1 * _s1ystride + i1] >> shift);
-        dst2[j * w + i] = (src2s[j0 * _s2ystride + i0] >> shift) +
-                          (src2s[j0 * _s2ystride + i1] >> shift) +
-                          (src2s[j1 * _s2ystride + i0] >> shift) +
-                          (src2s[j1 * _s2ystride + i1] >> shift);
-      }
+    if (!buf_is_hbd) {
+      fs_downsample_row(dst1 + j * w, _src1 + j0 * _s1ystride,
+                        _src1 + j1 * _s1ystride, w);
+      fs_downsample_row(dst2 + j * w, _src2 + j0 * _s2ystride,
+                        _src2 + j1 * _s2ystride, w);
+    } else {
+      const uint16_t *src1s = CONVERT_TO_SHORTPTR(_src1);
+      const uint16_t *src2s = CONVERT_TO_SHORTPTR(_src2);
+      fs_downsample_row_hbd(dst1 + j * w, src1s + j0 * _s1ystride,
+                            src1s + j1 * _s1ystride, w, shift);
+      fs_downsample_row_hbd(dst2 + j * w, src2s + j0 * _s2ystride,
+                            src2s + j1 * _s2ystride, w, shift);
     }
   }
 }
@@ -336,19 +346,21 @@ static void fs_calc_structure(fs_ctx *_ctx, int _l, int bit_depth) {
   c2 = ssim_c2 * (1 << 4 * _l) * 16 * 104;
   for (j = 0; j < h + 4; j++) {
     if (j < h - 1) {
+      const uint32_t *im1_0 = im1 + j * w;
+      const uint32_t *im1_1 = im1_0 + w;
+      const uint32_t *im2_0 = im2 + j * w;
+      const uint32_t *im2_1 = im2_0 + w;
+      unsigned *gx_row = gx_buf + (j & 7) * stride + 4;
+      unsigned *gy_row = gy_buf + (j & 7) * stride + 4;
       for (i = 0; i < w - 1; i++) {
         unsigned g1;
         unsigned g2;
-        unsigned gx;
-        unsigned gy;
-        g1 = abs((int)im1[(j + 1) * w + i + 1] - (int)im1[j * w + i]);
-        g2 = abs((int)im1[(j + 1) * w + i] - (int)im1[j * w + i + 1]);
-        gx = 4 * FS_MAXI(g1, g2) + FS_MINI(g1, g2);
-        g1 = abs((int)im2[(j + 1) * w + i + 1] - (int)im2[j * w + i]);
-        g2 = abs((int)im2[(j + 1) * w + i] - (int)im2[j * w + i + 1]);
-        gy = 4 * FS_MAXI(g1, g2) + FS_MINI(g1, g2);
-        gx_buf[(j & 7) * stride + i + 4] = gx;
-        gy_buf[(j & 7) * stride + i + 4] = gy;
+        g1 = abs((int)im1_1[i + 1] - (int)im1_0[i]);
+        g2 = abs((int)im1_1[i] - (int)im1_0[i + 1]);
+        gx_row[i] = 4 * FS_MAXI(g1, g2) + FS_MINI(g1, g2);
+        g1 = abs((int)im2_1[i + 1] - (int)im2_0[i]);
+        g2 = abs((int)im2_1[i] - (int)im2_0[i + 1]);
+        gy_row[i] = 4 * FS_MAXI(g1, g2) + FS_MINI(g1, g2);
       }
     } else {
       memset(gx_buf + (j & 7) * stride, 0, stride * sizeof(*gx_buf));
@@ -1371,4 +1371,141 @@ void aom_highbd_blend_a64_d16_mask_avx2(
                                     subh, conv_params, bd);
   }
 }
+
+//////////////////////////////////////////////////////////////////////////////
+// aom_highbd_blend_a64_mask_avx2()
+//////////////////////////////////////////////////////////////////////////////
+
+// Blends 16 pixels with the 16 mask values in m. The products are computed in
+// 32 bits, which is enough for 12-bit pixels.
+static INLINE void highbd_blend_a64_mask_w16_avx2(uint16_t *dst,
+                                                  const uint16_t *src0,
+                                                  const uint16_t *src1,
+                                                  const __m256i m) {
+  const __m256i v_maxval = _mm256_set1_epi16(AOM_BLEND_A64_MAX_ALPHA);
+  const __m256i v_round =
+      _mm256_set1_epi32(1 << (AOM_BLEND_A64_ROUND_BITS - 1));
+  const __m256i s0 = yy_loadu_256(src0);
+  const __m256i s1 = yy_loadu_256(src1);
+  const __m256i m_inv = _mm256_sub_epi16(v_maxval, m);
+
+  const __m256i sum_lo =
+      _mm256_madd_epi16(_mm256_unpacklo_epi16(s0, s1),
+                        _mm256_unpacklo_epi16(m, m_inv));
+  const __m256i sum_hi =
+      _mm256_madd_epi16(_mm256_unpackhi_epi16(s0, s1),
+                        _mm256_unpackhi_epi16(m, m_inv));
+  const __m256i res_lo = _mm256_srli_epi32(_mm256_add_epi32(sum_lo, v_round),
+                                           AOM_BLEND_A64_ROUND_BITS);
+  const __m256i res_hi = _mm256_srli_epi32(_mm256_add_epi32(sum_hi, v_round),
+                                           AOM_BLEND_A64_ROUND_BITS);
+  yy_storeu_256(dst, _mm256_packus_epi32(res_lo, res_hi));
+}
+
+// Returns the 16 mask values of a row, averaging the subsampled mask as the C
+// version does.
+static INLINE __m256i highbd_blend_a64_mask_load_avx2(const uint8_t *mask,
+                                                      uint32_t mask_stride,
+                                                      int subw, int subh) {
+  const __m256i v_one_b = _mm256_set1_epi8(1);
+  if (subw == 0 && subh == 0) {
+    return _mm256_cvtepu8_epi16(xx_loadu_128(mask));
+  } else if (subw == 1 && subh == 1) {
+    const __m256i m0 = _mm256_maddubs_epi16(yy_loadu_256(mask), v_one_b);
+    const __m256i m1 =
+        _mm256_maddubs_epi16(yy_loadu_256(mask + mask_stride), v_one_b);
+    return yy_roundn_epu16(_mm256_add_epi16(m0, m1), 2);
+  } else if (subw == 1 && subh == 0) {
+    return yy_roundn_epu16(_mm256_maddubs_epi16(yy_loadu_256(mask), v_one_b),
+                           1);
+  } else {
+    return _mm256_avg_epu16(
+        _mm256_cvtepu8_epi16(xx_loadu_128(mask)),
+        _mm256_cvtepu8_epi16(xx_loadu_128(mask + mask_stride)));
+  }
+}
+
+void aom_highbd_blend_a64_mask_avx2(uint8_t *dst_8, uint32_t dst_stride,
+                                    const uint8_t *src0_8, uint32_t src0_stride,
+                                    const uint8_t *src1_8, uint32_t src1_stride,
+                                    const uint8_t *mask, uint32_t mask_stride,
+                                    int w, int h, int subw, int subh, int bd) {
+  assert(IMPLIES(src0_8 == dst_8, src0_stride == dst_stride));
+  assert(IMPLIES(src1_8 == dst_8, src1_stride == dst_stride));
+
+  assert(h >= 1);
+  assert(w >= 1);
+  assert(IS_POWER_OF_TWO(h));
+  assert(IS_POWER_OF_TWO(w));
+
+  assert(bd == 8 || bd == 10 || bd == 12);
+
+  if (w < 16) {
+    aom_highbd_blend_a64_mask_sse4_1(dst_8, dst_stride, src0_8, src0_stride,
+                                     src1_8, src1_stride, mask, mask_stride, w,
+                                     h, subw, subh, bd);
+    return;
+  }
+
+  uint16_t *dst = CONVERT_TO_SHORTPTR(dst_8);
+  const uint16_t *src0 = CONVERT_TO_SHORTPTR(src0_8);
+  const uint16_t *src1 = CONVERT_TO_SHORTPTR(src1_8);
+  for (int i = 0; i < h; ++i) {
+    for (int j = 0; j < w; j += 16) {
+      const __m256i m = highbd_blend_a64_mask_load_avx2(
+          mask + (j << subw), mask_stride, subw, subh);
+      highbd_blend_a64_mask_w16_avx2(dst + j, src0 + j, src1 + j, m);
+    }
+    dst += dst_stride;
+    src0 += src0_stride;
+    src1 += src1_stride;
+    mask += mask_stride << subh;
+  }
+}
+
+void aom_highbd_blend_a64_hmask_avx2(uint8_t *dst_8, uint32_t dst_stride,
+                                     const uint8_t *src0_8,
+                                     uint32_t src0_stride,
+                                     const uint8_t *src1_8,
+                                     uint32_t src1_stride, const uint8_t *mask,
+                                     int w, int h, int bd) {
+  aom_highbd_blend_a64_mask_avx2(dst_8, dst_stride, src0_8, src0_stride, src1_8,
+                                 src1_stride, mask, 0, w, h, 0, 0, bd);
+}
+
+void aom_highbd_blend_a64_vmask_avx2(uint8_t *dst_8, uint32_t dst_stride,
+                                     const uint8_t *src0_8,
+                                     uint32_t src0_stride,
+                                     const uint8_t *src1_8,
+                                     uint32_t src1_stride, const uint8_t *mask,
+                                     int w, int h, int bd) {
+  assert(IMPLIES(src0_8 == dst_8, src0_stride == dst_stride));
+  assert(IMPLIES(src1_8 == dst_8, src1_stride == dst_stride));
+
+  assert(h >= 1);
+  assert(w >= 1);
+  assert(IS_POWER_OF_TWO(h));
+  assert(IS_POWER_OF_TWO(w));
+
+  assert(bd == 8 || bd == 10 || bd == 12);
+
+  if (w < 16) {
+    aom_highbd_blend_a64_vmask_sse4_1(dst_8, dst_stride, src0_8, src0_stride,
+                                      src1_8, src1_stride, mask, w, h, bd);
+    return;
+  }
+
+  uint16_t *dst = CONVERT_TO_SHORTPTR(dst_8);
+  const uint16_t *src0 = CONVERT_TO_SHORTPTR(src0_8);
+  const uint16_t *src1 = CONVERT_TO_SHORTPTR(src1_8);
+  for (int i = 0; i < h; ++i) {
+    const __m256i m = _mm256_set1_epi16(mask[i]);
+    for (int j = 0; j < w; j += 16) {
+      highbd_blend_a64_mask_w16_avx2(dst + j, src0 + j, src1 + j, m);
+    }
+    dst += dst_stride;
+    src0 += src0_stride;
+    src1 += src1_stride;
+  }
+}
 #endif  // CONFIG_AV1_HIGHBITDEPTH
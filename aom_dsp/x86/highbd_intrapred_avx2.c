@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom_dsp/intrapred_common.h"
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+
+// -----------------------------------------------------------------------------
+// DC, V and H predictors. All the functions below handle blocks at least 16
+// pixels wide, so a row is made of one or more 256-bit vectors.
+
+static INLINE void highbd_store_rows(uint16_t *dst, ptrdiff_t stride, int bw,
+                                     int bh, __m256i row) {
+  for (int r = 0; r < bh; ++r) {
+    for (int c = 0; c < bw; c += 16) yy_storeu_256(dst + c, row);
+    dst += stride;
+  }
+}
+
+// Returns the sum of n pixels, n being 4, 8 or a multiple of 16.
+static INLINE int highbd_sum_pixels(const uint16_t *ref, int n) {
+  const __m256i one = _mm256_set1_epi16(1);
+  __m128i sum;
+  if (n >= 16) {
+    __m256i sum_256 = _mm256_setzero_si256();
+    for (int i = 0; i < n; i += 16) {
+      sum_256 = _mm256_add_epi32(sum_256,
+                                 _mm256_madd_epi16(yy_loadu_256(ref + i), one));
+    }
+    sum = _mm_add_epi32(_mm256_castsi256_si128(sum_256),
+                        _mm256_extracti128_si256(sum_256, 1));
+  } else {
+    const __m128i x = n == 8 ? xx_loadu_128(ref) : xx_loadl_64(ref);
+    sum = _mm_madd_epi16(x, _mm256_castsi256_si128(one));
+  }
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  return _mm_cvtsi128_si32(sum);
+}
+
+static INLINE void highbd_dc_predictor_avx2(uint16_t *dst, ptrdiff_t stride,
+                                            int bw, int bh,
+                                            const uint16_t *above,
+                                            const uint16_t *left) {
+  const int count = bw + bh;
+  const int sum = highbd_sum_pixels(above, bw) + highbd_sum_pixels(left, bh);
+  const int dc = (sum + (count >> 1)) / count;
+  highbd_store_rows(dst, stride, bw, bh, _mm256_set1_epi16(dc));
+}
+
+static INLINE void highbd_dc_top_predictor_avx2(uint16_t *dst,
+                                                ptrdiff_t stride, int bw,
+                                                int bh, const uint16_t *above,
+                                                const uint16_t *left) {
+  (void)left;
+  const int dc = (highbd_sum_pixels(above, bw) + (bw >> 1)) / bw;
+  highbd_store_rows(dst, stride, bw, bh, _mm256_set1_epi16(dc));
+}
+
+static INLINE void highbd_dc_left_predictor_avx2(uint16_t *dst,
+                                                 ptrdiff_t stride, int bw,
+                                                 int bh, const uint16_t *above,
+                                                 const uint16_t *left) {
+  (void)above;
+  const int dc = (highbd_sum_pixels(left, bh) + (bh >> 1)) / bh;
+  highbd_store_rows(dst, stride, bw, bh, _mm256_set1_epi16(dc));
+}
+
+static INLINE void highbd_dc_128_predictor_avx2(uint16_t *dst,
+                                                ptrdiff_t stride, int bw,
+                                                int bh, const uint16_t *above,
+                                                const uint16_t *left, int bd) {
+  (void)above;
+  (void)left;
+  highbd_store_rows(dst, stride, bw, bh, _mm256_set1_epi16(128 << (bd - 8)));
+}
+
+static INLINE void highbd_v_predictor_avx2(uint16_t *dst, ptrdiff_t stride,
+                                           int bw, int bh,
+                                           const uint16_t *above) {
+  __m256i row[4];
+  for (int c = 0; c < bw; c += 16) row[c >> 4] = yy_loadu_256(above + c);
+  for (int r = 0; r < bh; ++r) {
+    for (int c = 0; c < bw; c += 16) yy_storeu_256(dst + c, row[c >> 4]);
+    dst += stride;
+  }
+}
+
+static INLINE void highbd_h_predictor_avx2(uint16_t *dst, ptrdiff_t stride,
+                                           int bw, int bh,
+                                           const uint16_t *left) {
+  for (int r = 0; r < bh; ++r) {
+    const __m256i row = _mm256_set1_epi16(left[r]);
+    for (int c = 0; c < bw; c += 16) yy_storeu_256(dst + c, row);
+    dst += stride;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// PAETH_PRED
+
+// Returns the Paeth prediction of 16 pixels, see paeth_predictor_single().
+// p_left = |top - top_left| only depends on the column and is passed in.
+static INLINE __m256i highbd_paeth_16(__m256i left, __m256i top,
+                                      __m256i top_left, __m256i p_left) {
+  const __m256i p_top = _mm256_abs_epi16(_mm256_sub_epi16(left, top_left));
+  const __m256i p_top_left = _mm256_abs_epi16(_mm256_sub_epi16(
+      _mm256_add_epi16(top, left), _mm256_add_epi16(top_left, top_left)));
+  const __m256i not_left =
+      _mm256_or_si256(_mm256_cmpgt_epi16(p_left, p_top),
+                      _mm256_cmpgt_epi16(p_left, p_top_left));
+  const __m256i top_or_top_left = _mm256_blendv_epi8(
+      top, top_left, _mm256_cmpgt_epi16(p_top, p_top_left));
+  return _mm256_blendv_epi8(left, top_or_top_left, not_left);
+}
+
+static INLINE void highbd_paeth_predictor_avx2(uint16_t *dst, ptrdiff_t stride,
+                                               int bw, int bh,
+                                               const uint16_t *above,
+                                               const uint16_t *left) {
+  const __m256i top_left = _mm256_set1_epi16(above[-1]);
+  for (int c = 0; c < bw; c += 16) {
+    const __m256i top = yy_loadu_256(above + c);
+    const __m256i p_left = _mm256_abs_epi16(_mm256_sub_epi16(top, top_left));
+    uint16_t *d = dst + c;
+    for (int r = 0; r < bh; ++r) {
+      yy_storeu_256(d, highbd_paeth_16(_mm256_set1_epi16(left[r]), top,
+                                       top_left, p_left));
+      d += stride;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// SMOOTH_PRED, SMOOTH_V_PRED and SMOOTH_H_PRED
+//
+// Each prediction is a sum of pixel * weight pairs with weights below 256, so
+// the pixels are interleaved with the pixel they are blended with and
+// multiplied by the interleaved weights with madd. The unpack and pack
+// instructions both work within 128-bit lanes, so the pixel order is kept.
+
+// Returns the weights of row or column i, interleaved with their complement
+// to the scale, for madd.
+static INLINE __m256i highbd_smooth_weight_pair(const uint8_t *weights, int i) {
+  const int scale = 1 << sm_weight_log2_scale;
+  return _mm256_set1_epi32(weights[i] | ((scale - weights[i]) << 16));
+}
+
+// Loads 16 column weights and interleaves them with their complement.
+static INLINE void highbd_smooth_load_weights(const uint8_t *weights,
+                                              __m256i *lo, __m256i *hi) {
+  const __m256i scale = _mm256_set1_epi16(1 << sm_weight_log2_scale);
+  const __m256i w = _mm256_cvtepu8_epi16(xx_loadu_128(weights));
+  const __m256i inv_w = _mm256_sub_epi16(scale, w);
+  *lo = _mm256_unpacklo_epi16(w, inv_w);
+  *hi = _mm256_unpackhi_epi16(w, inv_w);
+}
+
+static INLINE __m256i highbd_smooth_round_pack(__m256i lo, __m256i hi,
+                                               int shift) {
+  const __m256i round = _mm256_set1_epi32(1 << (shift - 1));
+  lo = _mm256_srli_epi32(_mm256_add_epi32(lo, round), shift);
+  hi = _mm256_srli_epi32(_mm256_add_epi32(hi, round), shift);
+  return _mm256_packus_epi32(lo, hi);
+}
+
+static INLINE void highbd_smooth_predictor_avx2(uint16_t *dst,
+                                                ptrdiff_t stride, int bw,
+                                                int bh, const uint16_t *above,
+                                                const uint16_t *left) {
+  const uint8_t *const sm_weights_w = sm_weight_arrays + bw;
+  const uint8_t *const sm_weights_h = sm_weight_arrays + bh;
+  const __m256i below_pred = _mm256_set1_epi16(left[bh - 1]);
+  const int right_pred = above[bw - 1];
+  const int shift = 1 + sm_weight_log2_scale;
+  for (int c = 0; c < bw; c += 16) {
+    const __m256i top = yy_loadu_256(above + c);
+    const __m256i top_below_lo = _mm256_unpacklo_epi16(top, below_pred);
+    const __m256i top_below_hi = _mm256_unpackhi_epi16(top, below_pred);
+    __m256i weights_w_lo, weights_w_hi;
+    highbd_smooth_load_weights(sm_weights_w + c, &weights_w_lo, &weights_w_hi);
+    uint16_t *d = dst + c;
+    for (int r = 0; r < bh; ++r) {
+      const __m256i weights_h = highbd_smooth_weight_pair(sm_weights_h, r);
+      const __m256i left_right =
+          _mm256_set1_epi32(left[r] | (right_pred << 16));
+      const __m256i lo =
+          _mm256_add_epi32(_mm256_madd_epi16(top_below_lo, weights_h),
+                           _mm256_madd_epi16(left_right, weights_w_lo));
+      const __m256i hi =
+          _mm256_add_epi32(_mm256_madd_epi16(top_below_hi, weights_h),
+                           _mm256_madd_epi16(left_right, weights_w_hi));
+      yy_storeu_256(d, highbd_smooth_round_pack(lo, hi, shift));
+      d += stride;
+    }
+  }
+}
+
+static INLINE void highbd_smooth_v_predictor_avx2(uint16_t *dst,
+                                                  ptrdiff_t stride, int bw,
+                                                  int bh,
+                                                  const uint16_t *above,
+                                                  const uint16_t *left) {
+  const uint8_t *const sm_weights = sm_weight_arrays + bh;
+  const __m256i below_pred = _mm256_set1_epi16(left[bh - 1]);
+  for (int c = 0; c < bw; c += 16) {
+    const __m256i top = yy_loadu_256(above + c);
+    const __m256i top_below_lo = _mm256_unpacklo_epi16(top, below_pred);
+    const __m256i top_below_hi = _mm256_unpackhi_epi16(top, below_pred);
+    uint16_t *d = dst + c;
+    for (int r = 0; r < bh; ++r) {
+      const __m256i weights = highbd_smooth_weight_pair(sm_weights, r);
+      const __m256i lo = _mm256_madd_epi16(top_below_lo, weights);
+      const __m256i hi = _mm256_madd_epi16(top_below_hi, weights);
+      yy_storeu_256(d, highbd_smooth_round_pack(lo, hi, sm_weight_log2_scale));
+      d += stride;
+    }
+  }
+}
+
+static INLINE void highbd_smooth_h_predictor_avx2(uint16_t *dst,
+                                                  ptrdiff_t stride, int bw,
+                                                  int bh,
+                                                  const uint16_t *above,
+                                                  const uint16_t *left) {
+  const uint8_t *const sm_weights = sm_weight_arrays + bw;
+  const int right_pred = above[bw - 1];
+  for (int c = 0; c < bw; c += 16) {
+    __m256i weights_lo, weights_hi;
+    highbd_smooth_load_weights(sm_weights + c, &weights_lo, &weights_hi);
+    uint16_t *d = dst + c;
+    for (int r = 0; r < bh; ++r) {
+      const __m256i left_right =
+          _mm256_set1_epi32(left[r] | (right_pred << 16));
+      const __m256i lo = _mm256_madd_epi16(left_right, weights_lo);
+      const __m256i hi = _mm256_madd_epi16(left_right, weights_hi);
+      yy_storeu_256(d, highbd_smooth_round_pack(lo, hi, sm_weight_log2_scale));
+      d += stride;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Block size wrappers.
+
+#define HIGHBD_INTRA_PRED_AVX2(w, h)                                         \
+  void aom_highbd_dc_predictor_##w##x##h##_avx2(                             \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,                \
+      const uint16_t *left, int bd) {                                        \
+    (void)bd;                                                                \
+    highbd_dc_predictor_avx2(dst, stride, w, h, above, left);                \
+  }                                                                          \
+  void aom_highbd_dc_top_predictor_##w##x##h##_avx2(                         \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,                \
+      const uint16_t *left, int bd) {                                        \
+    (void)bd;                                                                \
+    highbd_dc_top_predictor_avx2(dst, stride, w, h, above, left);            \
+  }                                                                          \
+  void aom_highbd_dc_left_predictor_##w##x##h##_avx2(                        \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,                \
+      const uint16_t *left, int bd) {                                        \
+    (void)bd;                                                                \
+    highbd_dc_left_predictor_avx2(dst, stride, w, h, above, left);           \
+  }                                                                          \
+  void aom_highbd_dc_128_predictor_##w##x##h##_avx2(                         \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,                \
+      const uint16_t *left, int bd) {                                        \
+    highbd_dc_128_predictor_avx2(dst, stride, w, h, above, left, bd);        \
+  }                                                                          \
+  void aom_highbd_v_predictor_##w##x##h##_avx2(                              \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,                \
+      const uint16_t *left, int bd) {                                        \
+    (void)left;                                                              \
+    (void)bd;                                                                \
+    highbd_v_predictor_avx2(dst, stride, w, h, above);                       \
+  }                                                                          \
+  void aom_highbd_h_predictor_##w##x##h##_avx2(                              \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,                \
+      const uint16_t *left, int bd) {                                        \
+    (void)above;                                                             \
+    (void)bd;                                                                \
+    highbd_h_predictor_avx2(dst, stride, w, h, left);                        \
+  }                                                                          \
+  void aom_highbd_paeth_predictor_##w##x##h##_avx2(                          \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,                \
+      const uint16_t *left, int bd) {                                        \
+    (void)bd;                                                                \
+    highbd_paeth_predictor_avx2(dst, stride, w, h, above, left);             \
+  }                                                                          \
+  void aom_highbd_smooth_predictor_##w##x##h##_avx2(                         \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,                \
+      const uint16_t *left, int bd) {                                        \
+    (void)bd;                                                                \
+    highbd_smooth_predictor_avx2(dst, stride, w, h, above, left);            \
+  }                                                                          \
+  void aom_highbd_smooth_v_predictor_##w##x##h##_avx2(                       \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,                \
+      const uint16_t *left, int bd) {                                        \
+    (void)bd;                                                                \
+    highbd_smooth_v_predictor_avx2(dst, stride, w, h, above, left);          \
+  }                                                                          \
+  void aom_highbd_smooth_h_predictor_##w##x##h##_avx2(                       \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above,                \
+      const uint16_t *left, int bd) {                                        \
+    (void)bd;                                                                \
+    highbd_smooth_h_predictor_avx2(dst, stride, w, h, above, left);          \
+  }
+
+HIGHBD_INTRA_PRED_AVX2(16, 4)
+HIGHBD_INTRA_PRED_AVX2(16, 8)
+HIGHBD_INTRA_PRED_AVX2(16, 16)
+HIGHBD_INTRA_PRED_AVX2(16, 32)
+HIGHBD_INTRA_PRED_AVX2(16, 64)
+HIGHBD_INTRA_PRED_AVX2(32, 8)
+HIGHBD_INTRA_PRED_AVX2(32, 16)
+HIGHBD_INTRA_PRED_AVX2(32, 32)
+HIGHBD_INTRA_PRED_AVX2(32, 64)
+HIGHBD_INTRA_PRED_AVX2(64, 16)
+HIGHBD_INTRA_PRED_AVX2(64, 32)
+HIGHBD_INTRA_PRED_AVX2(64, 64)
+
+#undef HIGHBD_INTRA_PRED_AVX2
@@ -14,6 +14,10 @@
 
 #include "config/aom_dsp_rtcd.h"
 
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+#include "aom_ports/mem.h"
+
 typedef void (*high_variance_fn_t)(const uint16_t *src, int src_stride,
                                    const uint16_t *ref, int ref_stride,
                                    uint32_t *sse, int *sum);
@@ -138,3 +142,82 @@ VAR_FN(16, 64, 16, 10);
 VAR_FN(64, 16, 16, 10);
 
 #undef VAR_FN
+
+void aom_highbd_comp_avg_pred_avx2(uint8_t *comp_pred8, const uint8_t *pred8,
+                                   int width, int height, const uint8_t *ref8,
+                                   int ref_stride) {
+  uint16_t *pred = CONVERT_TO_SHORTPTR(pred8);
+  uint16_t *ref = CONVERT_TO_SHORTPTR(ref8);
+  uint16_t *comp_pred = CONVERT_TO_SHORTPTR(comp_pred8);
+
+  if (width >= 16) {
+    assert(!(width & 15));
+    for (int i = 0; i < height; ++i) {
+      for (int j = 0; j < width; j += 16) {
+        const __m256i p = yy_loadu_256(pred + j);
+        const __m256i r = yy_loadu_256(ref + j);
+        yy_storeu_256(comp_pred + j, _mm256_avg_epu16(p, r));
+      }
+      comp_pred += width;
+      pred += width;
+      ref += ref_stride;
+    }
+  } else if (width == 8) {
+    for (int i = 0; i < height; ++i) {
+      const __m128i p = xx_loadu_128(pred);
+      const __m128i r = xx_loadu_128(ref);
+      xx_storeu_128(comp_pred, _mm_avg_epu16(p, r));
+      comp_pred += width;
+      pred += width;
+      ref += ref_stride;
+    }
+  } else {
+    // Read 4 pixels two rows at a time
+    assert(width == 4 && !(height & 1));
+    for (int i = 0; i < height; i += 2) {
+      const __m128i p = xx_loadu_128(pred);
+      const __m128i r = _mm_unpacklo_epi64(xx_loadl_64(ref),
+                                           xx_loadl_64(ref + ref_stride));
+      xx_storeu_128(comp_pred, _mm_avg_epu16(p, r));
+      comp_pred += 8;
+      pred += 8;
+      ref += 2 * ref_stride;
+    }
+  }
+}
+
+void aom_highbd_dist_wtd_comp_avg_pred_avx2(
+    uint8_t *comp_pred8, const uint8_t *pred8, int width, int height,
+    const uint8_t *ref8, int ref_stride,
+    const DIST_WTD_COMP_PARAMS *jcp_param) {
+  if (width < 16) {
+    aom_highbd_dist_wtd_comp_avg_pred_sse2(comp_pred8, pred8, width, height,
+                                           ref8, ref_stride, jcp_param);
+    return;
+  }
+  assert(!(width & 15));
+
+  // The weights sum to 1 << DIST_PRECISION_BITS, so the weighted sums of
+  // 12-bit pixels fit in unsigned 16 bits.
+  const __m256i w0 = _mm256_set1_epi16(jcp_param->fwd_offset);
+  const __m256i w1 = _mm256_set1_epi16(jcp_param->bck_offset);
+  const __m256i round = _mm256_set1_epi16((1 << DIST_PRECISION_BITS) >> 1);
+  uint16_t *pred = CONVERT_TO_SHORTPTR(pred8);
+  uint16_t *ref = CONVERT_TO_SHORTPTR(ref8);
+  uint16_t *comp_pred = CONVERT_TO_SHORTPTR(comp_pred8);
+
+  for (int i = 0; i < height; ++i) {
+    for (int j = 0; j < width; j += 16) {
+      const __m256i p = yy_loadu_256(pred + j);
+      const __m256i r = yy_loadu_256(ref + j);
+      const __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(r, w0),
+                                           _mm256_mullo_epi16(p, w1));
+      yy_storeu_256(comp_pred + j,
+                    _mm256_srli_epi16(_mm256_add_epi16(sum, round),
+                                      DIST_PRECISION_BITS));
+    }
+    comp_pred += width;
+    pred += width;
+    ref += ref_stride;
+  }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+#include <immintrin.h>  // AVX512
+
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom/aom_integer.h"
+
+// Computes the SADs of an M pixel wide block (M a multiple of 64) against 4
+// references, one row of 64 pixels per 512-bit register.
+static INLINE void sad_mxnx4d_avx512(int m, int n, const uint8_t *src,
+                                     int src_stride,
+                                     const uint8_t *const ref[4],
+                                     int ref_stride, uint32_t res[4]) {
+  __m512i sum[4] = { _mm512_setzero_si512(), _mm512_setzero_si512(),
+                     _mm512_setzero_si512(), _mm512_setzero_si512() };
+  const uint8_t *ref_ptr[4] = { ref[0], ref[1], ref[2], ref[3] };
+
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < m; j += 64) {
+      const __m512i s = _mm512_loadu_si512((const void *)(src + j));
+      for (int k = 0; k < 4; k++) {
+        const __m512i r = _mm512_loadu_si512((const void *)(ref_ptr[k] + j));
+        // Each 64-bit lane holds the sum of 8 absolute differences.
+        sum[k] = _mm512_add_epi64(sum[k], _mm512_sad_epu8(s, r));
+      }
+    }
+    src += src_stride;
+    for (int k = 0; k < 4; k++) ref_ptr[k] += ref_stride;
+  }
+
+  for (int k = 0; k < 4; k++) {
+    res[k] = (uint32_t)_mm512_reduce_add_epi64(sum[k]);
+  }
+}
+
+#define SAD_MXNX4D_AVX512(m, n)                                         \
+  void aom_sad##m##x##n##x4d_avx512(const uint8_t *src, int src_stride, \
+                                    const uint8_t *const ref[],         \
+                                    int ref_stride, uint32_t *res) {    \
+    sad_mxnx4d_avx512(m, n, src, src_stride, ref, ref_stride, res);     \
+  }
+
+SAD_MXNX4D_AVX512(64, 16)
+SAD_MXNX4D_AVX512(64, 32)
+SAD_MXNX4D_AVX512(64, 64)
+SAD_MXNX4D_AVX512(64, 128)
+SAD_MXNX4D_AVX512(128, 64)
+SAD_MXNX4D_AVX512(128, 128)
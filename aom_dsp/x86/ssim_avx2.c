@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom/aom_integer.h"
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+
+// The sums of the pixels are kept as 16-bit lanes, each of which adds at most
+// 16 8-bit or 4 12-bit pixels. The products are accumulated in 32 bits.
+typedef struct {
+  __m256i sum_s;
+  __m256i sum_r;
+  __m256i sum_sq_s;
+  __m256i sum_sq_r;
+  __m256i sum_sxr;
+} ssim_sums_avx2;
+
+static INLINE void ssim_sums_init(ssim_sums_avx2 *const sums) {
+  sums->sum_s = _mm256_setzero_si256();
+  sums->sum_r = _mm256_setzero_si256();
+  sums->sum_sq_s = _mm256_setzero_si256();
+  sums->sum_sq_r = _mm256_setzero_si256();
+  sums->sum_sxr = _mm256_setzero_si256();
+}
+
+// Accumulates 16 pairs of pixels, given as 16-bit lanes.
+static INLINE void ssim_parms_kernel(const __m256i s, const __m256i r,
+                                     ssim_sums_avx2 *const sums) {
+  sums->sum_s = _mm256_add_epi16(sums->sum_s, s);
+  sums->sum_r = _mm256_add_epi16(sums->sum_r, r);
+  sums->sum_sq_s = _mm256_add_epi32(sums->sum_sq_s, _mm256_madd_epi16(s, s));
+  sums->sum_sq_r = _mm256_add_epi32(sums->sum_sq_r, _mm256_madd_epi16(r, r));
+  sums->sum_sxr = _mm256_add_epi32(sums->sum_sxr, _mm256_madd_epi16(s, r));
+}
+
+static INLINE void ssim_sums_store(const ssim_sums_avx2 *const sums,
+                                   uint32_t *sum_s, uint32_t *sum_r,
+                                   uint32_t *sum_sq_s, uint32_t *sum_sq_r,
+                                   uint32_t *sum_sxr) {
+  const __m256i ones = _mm256_set1_epi16(1);
+  const __m256i s = _mm256_madd_epi16(sums->sum_s, ones);
+  const __m256i r = _mm256_madd_epi16(sums->sum_r, ones);
+  // Reduce the first four sums together: after the two horizontal adds each
+  // 128-bit lane holds the partial sums of s, r, sq_s and sq_r in that order.
+  const __m256i t0 = _mm256_hadd_epi32(s, r);
+  const __m256i t1 = _mm256_hadd_epi32(sums->sum_sq_s, sums->sum_sq_r);
+  const __m256i t2 = _mm256_hadd_epi32(t0, t1);
+  const __m128i t3 = _mm_add_epi32(_mm256_castsi256_si128(t2),
+                                   _mm256_extracti128_si256(t2, 1));
+  const __m128i sxr = _mm_add_epi32(_mm256_castsi256_si128(sums->sum_sxr),
+                                    _mm256_extracti128_si256(sums->sum_sxr, 1));
+  const __m128i sxr2 = _mm_add_epi32(sxr, _mm_srli_si128(sxr, 8));
+  const __m128i sxr1 = _mm_add_epi32(sxr2, _mm_srli_si128(sxr2, 4));
+
+  *sum_s += (uint32_t)_mm_cvtsi128_si32(t3);
+  *sum_r += (uint32_t)_mm_extract_epi32(t3, 1);
+  *sum_sq_s += (uint32_t)_mm_extract_epi32(t3, 2);
+  *sum_sq_r += (uint32_t)_mm_extract_epi32(t3, 3);
+  *sum_sxr += (uint32_t)_mm_cvtsi128_si32(sxr1);
+}
+
+void aom_ssim_parms_8x8_avx2(const uint8_t *s, int sp, const uint8_t *r,
+                             int rp, uint32_t *sum_s, uint32_t *sum_r,
+                             uint32_t *sum_sq_s, uint32_t *sum_sq_r,
+                             uint32_t *sum_sxr) {
+  ssim_sums_avx2 sums;
+  ssim_sums_init(&sums);
+  // Two rows of 8 pixels per iteration.
+  for (int i = 0; i < 8; i += 2) {
+    const __m128i s8 = _mm_unpacklo_epi64(xx_loadl_64(s), xx_loadl_64(s + sp));
+    const __m128i r8 = _mm_unpacklo_epi64(xx_loadl_64(r), xx_loadl_64(r + rp));
+    ssim_parms_kernel(_mm256_cvtepu8_epi16(s8), _mm256_cvtepu8_epi16(r8),
+                      &sums);
+    s += 2 * sp;
+    r += 2 * rp;
+  }
+  ssim_sums_store(&sums, sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr);
+}
+
+void aom_ssim_parms_16x16_avx2(const uint8_t *s, int sp, const uint8_t *r,
+                               int rp, uint32_t *sum_s, uint32_t *sum_r,
+                               uint32_t *sum_sq_s, uint32_t *sum_sq_r,
+                               uint32_t *sum_sxr) {
+  ssim_sums_avx2 sums;
+  ssim_sums_init(&sums);
+  for (int i = 0; i < 16; i++) {
+    ssim_parms_kernel(_mm256_cvtepu8_epi16(xx_loadu_128(s)),
+                      _mm256_cvtepu8_epi16(xx_loadu_128(r)), &sums);
+    s += sp;
+    r += rp;
+  }
+  ssim_sums_store(&sums, sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr);
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+// The pixels are at most 12 bits, so the squares of two of them, added by
+// madd, still fit in a signed 32-bit lane.
+void aom_highbd_ssim_parms_8x8_avx2(const uint16_t *s, int sp,
+                                    const uint16_t *r, int rp, uint32_t *sum_s,
+                                    uint32_t *sum_r, uint32_t *sum_sq_s,
+                                    uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+  ssim_sums_avx2 sums;
+  ssim_sums_init(&sums);
+  for (int i = 0; i < 8; i += 2) {
+    ssim_parms_kernel(yy_loadu2_128(s + sp, s), yy_loadu2_128(r + rp, r),
+                      &sums);
+    s += 2 * sp;
+    r += 2 * rp;
+  }
+  ssim_sums_store(&sums, sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr);
+}
+#endif  // CONFIG_AV1_HIGHBITDEPTH
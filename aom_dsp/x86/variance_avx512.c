@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>  // AVX512
+
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom_dsp/aom_filter.h"
+
+// Accumulates the sum and the sum of squares of the differences between 64
+// pixels, as 32-bit lanes.
+static INLINE void variance_kernel_avx512(const __m512i src, const __m512i ref,
+                                          __m512i *const sse,
+                                          __m512i *const sum) {
+  const __m512i adj_sub = _mm512_set1_epi16((short)0xff01);  // (1,-1)
+  const __m512i ones = _mm512_set1_epi16(1);
+
+  // unpack into pairs of source and reference values
+  const __m512i src_ref0 = _mm512_unpacklo_epi8(src, ref);
+  const __m512i src_ref1 = _mm512_unpackhi_epi8(src, ref);
+
+  // subtract adjacent elements using src*1 + ref*-1
+  const __m512i diff0 = _mm512_maddubs_epi16(src_ref0, adj_sub);
+  const __m512i diff1 = _mm512_maddubs_epi16(src_ref1, adj_sub);
+  const __m512i madd0 = _mm512_madd_epi16(diff0, diff0);
+  const __m512i madd1 = _mm512_madd_epi16(diff1, diff1);
+
+  // add to the running totals
+  const __m512i diff = _mm512_add_epi16(diff0, diff1);
+  *sum = _mm512_add_epi32(*sum, _mm512_madd_epi16(diff, ones));
+  *sse = _mm512_add_epi32(*sse, _mm512_add_epi32(madd0, madd1));
+}
+
+static INLINE unsigned int variance_final_avx512(__m512i vsse, __m512i vsum,
+                                                 int bits,
+                                                 unsigned int *const sse) {
+  const int sum = _mm512_reduce_add_epi32(vsum);
+  *sse = (unsigned int)_mm512_reduce_add_epi32(vsse);
+  return *sse - (unsigned int)(((int64_t)sum * sum) >> bits);
+}
+
+#define AOM_VAR_AVX512(bw, bh, bits)                                          \
+  unsigned int aom_variance##bw##x##bh##_avx512(                              \
+      const uint8_t *src, int src_stride, const uint8_t *ref, int ref_stride, \
+      unsigned int *sse) {                                                    \
+    __m512i vsse = _mm512_setzero_si512();                                    \
+    __m512i vsum = _mm512_setzero_si512();                                    \
+    for (int i = 0; i < bh; i++) {                                            \
+      for (int j = 0; j < bw; j += 64) {                                      \
+        variance_kernel_avx512(_mm512_loadu_si512((const void *)(src + j)),   \
+                               _mm512_loadu_si512((const void *)(ref + j)),   \
+                               &vsse, &vsum);                                 \
+      }                                                                       \
+      src += src_stride;                                                      \
+      ref += ref_stride;                                                      \
+    }                                                                         \
+    return variance_final_avx512(vsse, vsum, bits, sse);                      \
+  }
+
+AOM_VAR_AVX512(64, 16, 10)
+AOM_VAR_AVX512(64, 32, 11)
+AOM_VAR_AVX512(64, 64, 12)
+AOM_VAR_AVX512(64, 128, 13)
+AOM_VAR_AVX512(128, 64, 13)
+AOM_VAR_AVX512(128, 128, 14)
+
+// Applies the 2-tap bilinear filter to the 64 pixel pairs (a[i], b[i]). The
+// filter has to be a non-zero offset, whose taps all fit in a signed byte.
+static INLINE __m512i bil_filter_avx512(const __m512i a, const __m512i b,
+                                        const __m512i filter) {
+  const __m512i round = _mm512_set1_epi16(1 << (FILTER_BITS - 1));
+  const __m512i sum_lo =
+      _mm512_maddubs_epi16(_mm512_unpacklo_epi8(a, b), filter);
+  const __m512i sum_hi =
+      _mm512_maddubs_epi16(_mm512_unpackhi_epi8(a, b), filter);
+  const __m512i res_lo =
+      _mm512_srli_epi16(_mm512_add_epi16(sum_lo, round), FILTER_BITS);
+  const __m512i res_hi =
+      _mm512_srli_epi16(_mm512_add_epi16(sum_hi, round), FILTER_BITS);
+  return _mm512_packus_epi16(res_lo, res_hi);
+}
+
+static INLINE __m512i bil_filter_row_avx512(const uint8_t *src, int x_offset,
+                                            const __m512i filter) {
+  const __m512i a = _mm512_loadu_si512((const void *)src);
+  if (!x_offset) return a;
+  return bil_filter_avx512(a, _mm512_loadu_si512((const void *)(src + 1)),
+                           filter);
+}
+
+static INLINE __m512i bil_filter_taps_avx512(int offset) {
+  const uint8_t *const taps = bilinear_filters_2t[offset];
+  return _mm512_set1_epi16((int16_t)(taps[0] | (taps[1] << 8)));
+}
+
+// Same computation as aom_sub_pixel_variance*_c(), without the intermediate
+// buffers: each column of 64 pixels keeps its last horizontally filtered row
+// in a register and applies the vertical filter as it moves down. The zero
+// offsets, whose 128 tap does not fit in a signed byte, are copies.
+#define AOM_SUB_PIXEL_VAR_AVX512(bw, bh, bits)                                \
+  unsigned int aom_sub_pixel_variance##bw##x##bh##_avx512(                    \
+      const uint8_t *src, int src_stride, int x_offset, int y_offset,         \
+      const uint8_t *dst, int dst_stride, unsigned int *sse) {                \
+    const __m512i hfilter = bil_filter_taps_avx512(x_offset);                 \
+    const __m512i vfilter = bil_filter_taps_avx512(y_offset);                 \
+    __m512i vsse = _mm512_setzero_si512();                                    \
+    __m512i vsum = _mm512_setzero_si512();                                    \
+    for (int j = 0; j < bw; j += 64) {                                        \
+      const uint8_t *s = src + j;                                             \
+      const uint8_t *d = dst + j;                                             \
+      __m512i prev = bil_filter_row_avx512(s, x_offset, hfilter);             \
+      for (int i = 0; i < bh; i++) {                                          \
+        __m512i pred = prev;                                                  \
+        if (y_offset) {                                                       \
+          s += src_stride;                                                    \
+          const __m512i cur = bil_filter_row_avx512(s, x_offset, hfilter);    \
+          pred = bil_filter_avx512(prev, cur, vfilter);                       \
+          prev = cur;                                                         \
+        } else if (i + 1 < bh) {                                              \
+          s += src_stride;                                                    \
+          prev = bil_filter_row_avx512(s, x_offset, hfilter);                 \
+        }                                                                     \
+        variance_kernel_avx512(pred, _mm512_loadu_si512((const void *)d),     \
+                               &vsse, &vsum);                                 \
+        d += dst_stride;                                                      \
+      }                                                                       \
+    }                                                                         \
+    return variance_final_avx512(vsse, vsum, bits, sse);                      \
+  }
+
+AOM_SUB_PIXEL_VAR_AVX512(64, 16, 10)
+AOM_SUB_PIXEL_VAR_AVX512(64, 32, 11)
+AOM_SUB_PIXEL_VAR_AVX512(64, 64, 12)
+AOM_SUB_PIXEL_VAR_AVX512(64, 128, 13)
+AOM_SUB_PIXEL_VAR_AVX512(128, 64, 13)
+AOM_SUB_PIXEL_VAR_AVX512(128, 128, 14)
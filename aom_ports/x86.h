@@ -163,6 +163,7 @@ static INLINE uint64_t xgetbv(void) {
 #define HAS_AVX 0x40
 #define HAS_AVX2 0x80
 #define HAS_SSE4_2 0x100
+#define HAS_AVX512 0x200
 #ifndef BIT
 #define BIT(n) (1 << n)
 #endif
@@ -215,6 +216,14 @@ static INLINE int x86_simd_caps(void) {
         cpuid(7, 0, reg_eax, reg_ebx, reg_ecx, reg_edx);
 
         if (reg_ebx & BIT(5)) flags |= HAS_AVX2;
+
+        // bits 16 (AVX512F), 17 (AVX512DQ), 28 (AVX512CD), 30 (AVX512BW) &
+        // 31 (AVX512VL), with the opmask and ZMM states enabled by the OS.
+        const unsigned int avx512_mask = 0xd0030000;
+        if ((reg_ebx & avx512_mask) == avx512_mask &&
+            (xgetbv() & 0xe6) == 0xe6) {
+          flags |= HAS_AVX512;
+        }
       }
     }
   }
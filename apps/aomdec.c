@@ -106,6 +106,13 @@ static const arg_def_t outallarg = ARG_DEF(
     NULL, "all-layers", 0, "Output all decoded frames of a scalable bitstream");
 static const arg_def_t skipfilmgrain =
     ARG_DEF(NULL, "skip-film-grain", 0, "Skip film grain application");
+static const arg_def_t lowmemoryarg =
+    ARG_DEF(NULL, "low-memory", 0,
+            "Decode with a reduced memory footprint and show peak usage");
+static const arg_def_t downscalearg =
+    ARG_DEF(NULL, "downscale", 1, "Downscale the output by 2, 4 or 8");
+static const arg_def_t keyframesonlyarg =
+    ARG_DEF(NULL, "keyframes-only", 0, "Only decode and output key frames");
 
 static const arg_def_t *all_args[] = {
   &help,           &codecarg,   &use_yv12,      &use_i420,
@@ -114,7 +121,8 @@ static const arg_def_t *all_args[] = {
   &outputfile,     &threadsarg, &verbosearg,    &scalearg,
   &fb_arg,         &md5arg,     &framestatsarg, &continuearg,
   &outbitdeptharg, &isannexb,   &oppointarg,    &outallarg,
-  &skipfilmgrain,  NULL
+  &skipfilmgrain,  &lowmemoryarg, &downscalearg,  &keyframesonlyarg,
+  NULL
 };
 
 #if CONFIG_LIBYUV
@@ -460,6 +468,9 @@ static int main_loop(int argc, const char **argv_) {
   int operating_point = 0;
   int output_all_layers = 0;
   int skip_film_grain = 0;
+  unsigned int low_memory = 0;
+  unsigned int output_downscale = 1;
+  int keyframes_only = 0;
   aom_image_t *scaled_img = NULL;
   aom_image_t *img_shifted = NULL;
   int frame_avail, got_data, flush_decoder = 0;
@@ -576,6 +587,12 @@ static int main_loop(int argc, const char **argv_) {
       output_all_layers = 1;
     } else if (arg_match(&arg, &skipfilmgrain, argi)) {
       skip_film_grain = 1;
+    } else if (arg_match(&arg, &lowmemoryarg, argi)) {
+      low_memory = 1;
+    } else if (arg_match(&arg, &downscalearg, argi)) {
+      output_downscale = arg_parse_uint(&arg);
+    } else if (arg_match(&arg, &keyframesonlyarg, argi)) {
+      keyframes_only = 1;
     } else {
       argj++;
     }
@@ -709,6 +726,25 @@ static int main_loop(int argc, const char **argv_) {
     goto fail;
   }
 
+  if (aom_codec_control(&decoder, AV1D_SET_LOW_MEMORY, low_memory)) {
+    fprintf(stderr, "Failed to set low_memory: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+
+  if (aom_codec_control(&decoder, AV1D_SET_OUTPUT_DOWNSCALE,
+                        output_downscale)) {
+    fprintf(stderr, "Failed to set output_downscale: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+
+  if (aom_codec_control(&decoder, AV1D_SET_KEYFRAMES_ONLY, keyframes_only)) {
+    fprintf(stderr, "Failed to set keyframes_only: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+
   if (arg_skip) fprintf(stderr, "Skipping first %d frames.\n", arg_skip);
   while (arg_skip) {
     if (read_frame(&input, &buf, &bytes_in_buffer, &buffer_size)) break;
@@ -954,6 +990,13 @@ static int main_loop(int argc, const char **argv_) {
     fprintf(stderr, "\n");
   }
 
+  if (low_memory) {
+    uint64_t peak_mem_usage = 0;
+    if (!aom_codec_control(&decoder, AV1D_GET_PEAK_MEM_USAGE, &peak_mem_usage))
+      fprintf(stderr, "Peak decoder memory: %" PRIu64 " bytes\n",
+              peak_mem_usage);
+  }
+
   if (frames_corrupted) {
     fprintf(stderr, "WARNING: %d frames corrupted.\n", frames_corrupted);
   } else {
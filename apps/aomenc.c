@@ -687,6 +687,11 @@ static const arg_def_t set_min_cr =
             "Set minimum compression ratio. Take integer values. Default is 0. "
             "If non-zero, encoder will try to keep the compression ratio of "
             "each frame to be higher than the given value divided by 100.");
+static const arg_def_t frame_time_budget =
+    ARG_DEF(NULL, "frame-time-budget", 1,
+            "Wall-clock time budget of each frame in microseconds. If "
+            "non-zero, the encoder tightens its speed features beyond those "
+            "of cpu-used while it runs over the budget (default: 0)");
 
 static const struct arg_enum_list color_primaries_enum[] = {
   { "bt709", AOM_CICP_CP_BT_709 },
@@ -896,6 +901,7 @@ static const arg_def_t *av1_args[] = { &cpu_used_av1,
                                        &target_seq_level_idx,
                                        &set_tier_mask,
                                        &set_min_cr,
+                                       &frame_time_budget,
                                        &bitdeptharg,
                                        &inbitdeptharg,
                                        &input_chroma_subsampling_x,
@@ -1002,6 +1008,7 @@ static const int av1_arg_ctrl_map[] = { AOME_SET_CPUUSED,
                                         AV1E_SET_TARGET_SEQ_LEVEL_IDX,
                                         AV1E_SET_TIER_MASK,
                                         AV1E_SET_MIN_CR,
+                                        AV1E_SET_FRAME_TIME_BUDGET,
                                         0 };
 #endif  // CONFIG_AV1_ENCODER
 
@@ -2113,6 +2120,23 @@ static void show_psnr(struct stream_state *stream, double peak, int64_t bps) {
   fprintf(stderr, "\n");
 }
 
+static void show_time_budget_stats(struct stream_state *stream) {
+  aom_time_budget_stats_t stats;
+  if (aom_codec_control(&stream->encoder, AV1E_GET_TIME_BUDGET_STATS,
+                        &stats) != AOM_CODEC_OK ||
+      !stats.frames) {
+    return;
+  }
+
+  fprintf(stderr,
+          "Stream %d time budget: %u/%u frames over, %u escalations "
+          "(%u mid-frame), %u relaxations, final level %d, longest frame "
+          "%" PRId64 " us\n",
+          stream->index, stats.frames_over_budget, stats.frames,
+          stats.escalations, stats.mid_frame_escalations, stats.relaxations,
+          stats.level, stats.max_frame_time);
+}
+
 static float usec_to_fps(uint64_t usec, unsigned int frames) {
   return (float)(usec > 0 ? frames * 1000000.0 / (float)usec : 0);
 }
@@ -2626,6 +2650,9 @@ int main(int argc, const char **argv_) {
                 stream->cx_time > 9999999 ? "ms" : "us",
                 usec_to_fps(stream->cx_time, seen_frames));
       }
+      if (global.codec->fourcc == AV1_FOURCC) {
+        FOREACH_STREAM(stream, streams) { show_time_budget_stats(stream); }
+      }
     }
 
     if (global.show_psnr) {
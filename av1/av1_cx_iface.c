@@ -23,6 +23,7 @@
 
 #include "av1/av1_iface_common.h"
 #include "av1/encoder/bitstream.h"
+#include "av1/encoder/block_hints.h"
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/firstpass.h"
 
@@ -147,6 +148,8 @@ struct av1_extracfg {
   unsigned int tier_mask;
   // min_cr / 100 is the target minimum compression ratio for each frame.
   unsigned int min_cr;
+  // Wall-clock time budget of each frame in microseconds, 0 if unlimited.
+  unsigned int frame_time_budget;
   COST_UPDATE_TYPE coeff_cost_upd_freq;
   COST_UPDATE_TYPE mode_cost_upd_freq;
   COST_UPDATE_TYPE mv_cost_upd_freq;
@@ -272,6 +275,7 @@ static struct av1_extracfg default_extra_cfg = {
   },            // target_seq_level_idx
   0,            // tier_mask
   0,            // min_cr
+  0,            // frame_time_budget
   COST_UPD_SB,  // coeff_cost_upd_freq
   COST_UPD_SB,  // mode_cost_upd_freq
   COST_UPD_SB,  // mv_cost_upd_freq
@@ -961,6 +965,7 @@ static aom_codec_err_t set_encoder_config(AV1EncoderConfig *oxcf,
          sizeof(oxcf->target_seq_level_idx));
   oxcf->tier_mask = extra_cfg->tier_mask;
   oxcf->min_cr = extra_cfg->min_cr;
+  oxcf->frame_time_budget = extra_cfg->frame_time_budget;
   return AOM_CODEC_OK;
 }
 
@@ -1735,6 +1740,13 @@ static aom_codec_err_t ctrl_set_min_cr(aom_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static aom_codec_err_t ctrl_set_frame_time_budget(aom_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.frame_time_budget = CAST(AV1E_SET_FRAME_TIME_BUDGET, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
 static aom_codec_err_t encoder_init(aom_codec_ctx_t *ctx,
                                     aom_codec_priv_enc_mr_cfg_t *data) {
   aom_codec_err_t res = AOM_CODEC_OK;
@@ -2197,6 +2209,34 @@ static aom_codec_err_t ctrl_set_active_map(aom_codec_alg_priv_t *ctx,
   }
 }
 
+static aom_codec_err_t ctrl_set_block_hints(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  aom_block_hint_map_t *const map = va_arg(args, aom_block_hint_map_t *);
+
+  if (map) {
+    if (!av1_set_block_hints(ctx->cpi, map))
+      return AOM_CODEC_OK;
+    else
+      return AOM_CODEC_INVALID_PARAM;
+  } else {
+    return AOM_CODEC_INVALID_PARAM;
+  }
+}
+
+static aom_codec_err_t ctrl_set_analysis_hints(aom_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  aom_analysis_hints_t *const hints = va_arg(args, aom_analysis_hints_t *);
+
+  if (hints) {
+    if (!av1_set_analysis_hints(ctx->cpi, hints))
+      return AOM_CODEC_OK;
+    else
+      return AOM_CODEC_INVALID_PARAM;
+  } else {
+    return AOM_CODEC_INVALID_PARAM;
+  }
+}
+
 static aom_codec_err_t ctrl_get_active_map(aom_codec_alg_priv_t *ctx,
                                            va_list args) {
   aom_active_map_t *const map = va_arg(args, aom_active_map_t *);
@@ -2388,6 +2428,14 @@ static aom_codec_err_t ctrl_get_seq_level_idx(aom_codec_alg_priv_t *ctx,
   return av1_get_seq_level_idx(ctx->cpi, arg);
 }
 
+static aom_codec_err_t ctrl_get_time_budget_stats(aom_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  aom_time_budget_stats_t *const arg = va_arg(args, aom_time_budget_stats_t *);
+  if (arg == NULL) return AOM_CODEC_INVALID_PARAM;
+  *arg = ctx->cpi->time_budget.stats;
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1_COPY_REFERENCE, ctrl_copy_reference },
   { AOME_USE_REFERENCE, ctrl_use_reference },
@@ -2511,6 +2559,9 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1E_SET_SVC_LAYER_ID, ctrl_set_layer_id },
   { AV1E_SET_SVC_PARAMS, ctrl_set_svc_params },
   { AV1E_SET_SVC_REF_FRAME_CONFIG, ctrl_set_svc_ref_frame_config },
+  { AV1E_SET_FRAME_TIME_BUDGET, ctrl_set_frame_time_budget },
+  { AV1E_SET_BLOCK_HINTS, ctrl_set_block_hints },
+  { AV1E_SET_ANALYSIS_HINTS, ctrl_set_analysis_hints },
 
   // Getters
   { AOME_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -2522,6 +2573,7 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1E_SET_CHROMA_SUBSAMPLING_X, ctrl_set_chroma_subsampling_x },
   { AV1E_SET_CHROMA_SUBSAMPLING_Y, ctrl_set_chroma_subsampling_y },
   { AV1E_GET_SEQ_LEVEL_IDX, ctrl_get_seq_level_idx },
+  { AV1E_GET_TIME_BUDGET_STATS, ctrl_get_time_budget_stats },
   { -1, NULL },
 };
 
@@ -28,6 +28,7 @@
 #include "av1/common/frame_buffers.h"
 #include "av1/common/enums.h"
 #include "av1/common/obu_util.h"
+#include "av1/common/resize.h"
 
 #include "av1/decoder/decoder.h"
 #include "av1/decoder/decodeframe.h"
@@ -54,6 +55,9 @@ struct aom_codec_alg_priv {
   unsigned int tile_mode;
   unsigned int ext_tile_debug;
   unsigned int row_mt;
+  unsigned int low_memory;
+  unsigned int output_downscale;
+  int keyframes_only;
   EXTERNAL_REFERENCES ext_refs;
   unsigned int is_annexb;
   int operating_point;
@@ -66,6 +70,8 @@ struct aom_codec_alg_priv {
   int num_frame_workers;
   int next_output_worker_id;
 
+  // Output frames downscaled by output_downscale, one per spatial layer.
+  YV12_BUFFER_CONFIG downscaled_frames[MAX_NUM_SPATIAL_LAYERS];
   aom_image_t image_with_grain;
   aom_codec_frame_buffer_t grain_image_frame_buffers[MAX_NUM_SPATIAL_LAYERS];
   size_t num_grain_image_frame_buffers;
@@ -109,6 +115,7 @@ static aom_codec_err_t decoder_init(aom_codec_ctx_t *ctx,
     priv->num_grain_image_frame_buffers = 0;
     // Turn row_mt on by default.
     priv->row_mt = 1;
+    priv->output_downscale = 1;
 
     // Turn on normal tile coding mode by default.
     // 0 is for normal tile coding mode, and 1 is for large scale tile coding
@@ -150,6 +157,9 @@ static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
     av1_free_internal_frame_buffers(&ctx->buffer_pool->int_frame_buffers);
   }
 
+  for (int i = 0; i < MAX_NUM_SPATIAL_LAYERS; i++)
+    aom_free_frame_buffer(&ctx->downscaled_frames[i]);
+
   aom_free(ctx->frame_workers);
   aom_free(ctx->buffer_pool);
   aom_free(ctx);
@@ -369,6 +379,46 @@ static aom_codec_err_t decoder_get_si(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+// Returns 1 if the temporal unit in data contains a frame header of a key
+// frame, or if it can not be parsed (the decoder then reports the error).
+// Only the OBU headers and the first bits of the frame headers are read.
+static int temporal_unit_has_key_frame(const uint8_t *data, size_t data_sz,
+                                       int reduced_still_picture_hdr) {
+  while (data_sz > 0) {
+    ObuHeader obu_header;
+    size_t payload_size = 0;
+    size_t bytes_read = 0;
+    if (aom_read_obu_header_and_size(data, data_sz, 0, &obu_header,
+                                     &payload_size, &bytes_read) !=
+        AOM_CODEC_OK)
+      return 1;
+    data += bytes_read;
+    data_sz -= bytes_read;
+    if (data_sz < payload_size) return 1;
+    if (obu_header.type == OBU_SEQUENCE_HEADER) {
+      if (payload_size < 1) return 1;
+      struct aom_read_bit_buffer rb = { data, data + payload_size, 0, NULL,
+                                        NULL };
+      av1_read_profile(&rb);  // profile
+      aom_rb_read_bit(&rb);   // still_picture
+      reduced_still_picture_hdr = aom_rb_read_bit(&rb);
+    } else if (obu_header.type == OBU_FRAME_HEADER ||
+               obu_header.type == OBU_FRAME) {
+      if (reduced_still_picture_hdr) return 1;
+      if (payload_size < 1) return 1;
+      struct aom_read_bit_buffer rb = { data, data + payload_size, 0, NULL,
+                                        NULL };
+      const int show_existing_frame = aom_rb_read_bit(&rb);
+      if (!show_existing_frame &&
+          (FRAME_TYPE)aom_rb_read_literal(&rb, 2) == KEY_FRAME)
+        return 1;
+    }
+    data += payload_size;
+    data_sz -= payload_size;
+  }
+  return 0;
+}
+
 static void set_error_detail(aom_codec_alg_priv_t *ctx,
                              const char *const error) {
   ctx->base.err_detail = error;
@@ -497,6 +547,7 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
     frame_worker_data->pbi->output_all_layers = ctx->output_all_layers;
     frame_worker_data->pbi->ext_tile_debug = ctx->ext_tile_debug;
     frame_worker_data->pbi->row_mt = ctx->row_mt;
+    frame_worker_data->pbi->low_memory = ctx->low_memory;
 
     worker->hook = frame_worker_hook;
     // The main thread acts as Frame Worker 0.
@@ -554,7 +605,9 @@ static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
   frame_worker_data->pbi->dec_tile_col = ctx->decode_tile_col;
   frame_worker_data->pbi->ext_tile_debug = ctx->ext_tile_debug;
   frame_worker_data->pbi->row_mt = ctx->row_mt;
+  frame_worker_data->pbi->low_memory = ctx->low_memory;
   frame_worker_data->pbi->ext_refs = ctx->ext_refs;
+  ctx->buffer_pool->int_frame_buffers.free_on_release = ctx->low_memory;
 
   frame_worker_data->pbi->common.is_annexb = ctx->is_annexb;
 
@@ -661,6 +714,18 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
   // Reset flushed when receiving a valid frame.
   ctx->flushed = 0;
 
+  if (ctx->keyframes_only && !ctx->is_annexb) {
+    int reduced_still_picture_hdr = 0;
+    if (ctx->frame_workers != NULL) {
+      const FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)ctx->frame_workers->data1;
+      reduced_still_picture_hdr =
+          frame_worker_data->pbi->common.seq_params.reduced_still_picture_hdr;
+    }
+    if (!temporal_unit_has_key_frame(data, data_sz, reduced_still_picture_hdr))
+      return AOM_CODEC_OK;
+  }
+
   // Initialize the decoder workers on the first frame.
   if (ctx->frame_workers == NULL) {
     res = init_decoder(ctx);
@@ -761,6 +826,38 @@ static aom_image_t *add_grain_if_needed(aom_codec_alg_priv_t *ctx,
   return grain_img;
 }
 
+// Downscales the output frame src by ctx->output_downscale into dst, which is
+// (re)allocated as needed. Returns 0 on success.
+static int downscale_output_frame(const aom_codec_alg_priv_t *ctx,
+                                  const YV12_BUFFER_CONFIG *src,
+                                  YV12_BUFFER_CONFIG *dst) {
+  const int factor = (int)ctx->output_downscale;
+  const int width = (src->y_crop_width + factor - 1) / factor;
+  const int height = (src->y_crop_height + factor - 1) / factor;
+  const int use_highbitdepth = (src->flags & YV12_FLAG_HIGHBITDEPTH) != 0;
+
+  // The downscaled frame is never used for prediction, so it needs no border.
+  if (aom_realloc_frame_buffer(dst, width, height, src->subsampling_x,
+                               src->subsampling_y, use_highbitdepth, 0,
+                               ctx->byte_alignment, NULL, NULL, NULL))
+    return -1;
+
+  // Monochrome frames carry neutral grey chroma planes, so always resize all
+  // of them.
+  av1_resize_frame(src, dst, src->bit_depth, MAX_MB_PLANE);
+
+  dst->bit_depth = src->bit_depth;
+  dst->color_primaries = src->color_primaries;
+  dst->transfer_characteristics = src->transfer_characteristics;
+  dst->matrix_coefficients = src->matrix_coefficients;
+  dst->monochrome = src->monochrome;
+  dst->chroma_sample_position = src->chroma_sample_position;
+  dst->color_range = src->color_range;
+  dst->render_width = (src->render_width + factor - 1) / factor;
+  dst->render_height = (src->render_height + factor - 1) / factor;
+  return 0;
+}
+
 static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
                                       aom_codec_iter_t *iter) {
   aom_image_t *img = NULL;
@@ -850,6 +947,16 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
           }
 
           ctx->img.fb_priv = output_frame_buf->raw_frame_buffer.priv;
+          if (ctx->output_downscale > 1 && !cm->large_scale_tile) {
+            YV12_BUFFER_CONFIG *const ds = &ctx->downscaled_frames[*index];
+            if (downscale_output_frame(ctx, sd, ds)) {
+              aom_internal_error(&pbi->common.error, AOM_CODEC_MEM_ERROR,
+                                 "Failed to allocate downscaled frame");
+            }
+            yuvconfig2image(&ctx->img, ds, frame_worker_data->user_priv);
+            ctx->img.metadata = sd->metadata;
+            ctx->img.fb_priv = NULL;
+          }
           img = &ctx->img;
           img->temporal_id = cm->temporal_layer_id;
           img->spatial_id = cm->spatial_layer_id;
@@ -1377,6 +1484,41 @@ static aom_codec_err_t ctrl_set_row_mt(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_low_memory(aom_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  ctx->low_memory = va_arg(args, unsigned int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_peak_mem_usage(aom_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  uint64_t *const peak_mem_usage = va_arg(args, uint64_t *);
+
+  if (peak_mem_usage == NULL) return AOM_CODEC_INVALID_PARAM;
+  *peak_mem_usage = 0;
+  if (ctx->frame_workers) {
+    AVxWorker *const worker = ctx->frame_workers;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    *peak_mem_usage = frame_worker_data->pbi->peak_mem_usage;
+  }
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_output_downscale(aom_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  const unsigned int factor = va_arg(args, unsigned int);
+  if (factor != 1 && factor != 2 && factor != 4 && factor != 8)
+    return AOM_CODEC_INVALID_PARAM;
+  ctx->output_downscale = factor;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_keyframes_only(aom_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  ctx->keyframes_only = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1_COPY_REFERENCE, ctrl_copy_reference },
 
@@ -1401,6 +1543,9 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1D_SET_ROW_MT, ctrl_set_row_mt },
   { AV1D_SET_EXT_REF_PTR, ctrl_set_ext_ref_ptr },
   { AV1D_SET_SKIP_FILM_GRAIN, ctrl_set_skip_film_grain },
+  { AV1D_SET_LOW_MEMORY, ctrl_set_low_memory },
+  { AV1D_SET_OUTPUT_DOWNSCALE, ctrl_set_output_downscale },
+  { AV1D_SET_KEYFRAMES_ONLY, ctrl_set_keyframes_only },
 
   // Getters
   { AOMD_GET_FRAME_CORRUPTED, ctrl_get_frame_corrupted },
@@ -1418,6 +1563,7 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1_GET_REFERENCE, ctrl_get_reference },
   { AV1D_GET_FRAME_HEADER_INFO, ctrl_get_frame_header_info },
   { AV1D_GET_TILE_DATA, ctrl_get_tile_data },
+  { AV1D_GET_PEAK_MEM_USAGE, ctrl_get_peak_mem_usage },
 
   { -1, NULL },
 };
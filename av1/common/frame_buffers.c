@@ -54,6 +54,17 @@ void av1_zero_unused_internal_frame_buffers(InternalFrameBufferList *list) {
   }
 }
 
+size_t av1_internal_frame_buffers_size(const InternalFrameBufferList *list) {
+  size_t size = 0;
+
+  assert(list != NULL);
+
+  for (int i = 0; i < list->num_internal_frame_buffers; ++i) {
+    if (list->int_fb[i].data) size += list->int_fb[i].size;
+  }
+  return size;
+}
+
 int av1_get_frame_buffer(void *cb_priv, size_t min_size,
                          aom_codec_frame_buffer_t *fb) {
   int i;
@@ -91,8 +102,16 @@ int av1_get_frame_buffer(void *cb_priv, size_t min_size,
 }
 
 int av1_release_frame_buffer(void *cb_priv, aom_codec_frame_buffer_t *fb) {
+  InternalFrameBufferList *const int_fb_list =
+      (InternalFrameBufferList *)cb_priv;
   InternalFrameBuffer *const int_fb = (InternalFrameBuffer *)fb->priv;
-  (void)cb_priv;
-  if (int_fb) int_fb->in_use = 0;
+  if (int_fb) {
+    int_fb->in_use = 0;
+    if (int_fb_list != NULL && int_fb_list->free_on_release) {
+      aom_free(int_fb->data);
+      int_fb->data = NULL;
+      int_fb->size = 0;
+    }
+  }
   return 0;
 }
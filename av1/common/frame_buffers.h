@@ -28,6 +28,9 @@ typedef struct InternalFrameBuffer {
 typedef struct InternalFrameBufferList {
   int num_internal_frame_buffers;
   InternalFrameBuffer *int_fb;
+  // If nonzero, the data of a frame buffer is freed as soon as it is
+  // released instead of being kept around for reuse.
+  int free_on_release;
 } InternalFrameBufferList;
 
 // Initializes |list|. Returns 0 on success.
@@ -49,8 +52,13 @@ void av1_zero_unused_internal_frame_buffers(InternalFrameBufferList *list);
 int av1_get_frame_buffer(void *cb_priv, size_t min_size,
                          aom_codec_frame_buffer_t *fb);
 
+// Returns the number of bytes currently allocated to the frame buffers in
+// |list|.
+size_t av1_internal_frame_buffers_size(const InternalFrameBufferList *list);
+
 // Callback used by libaom when there are no references to the frame buffer.
-// |cb_priv| is not used. |fb| pointer to the frame buffer.
+// |cb_priv| Callback private data, which points to an InternalFrameBufferList.
+// |fb| pointer to the frame buffer.
 int av1_release_frame_buffer(void *cb_priv, aom_codec_frame_buffer_t *fb);
 
 #ifdef __cplusplus
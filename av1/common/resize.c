@@ -17,6 +17,7 @@
 #include <string.h>
 
 #include "config/aom_config.h"
+#include "config/av1_rtcd.h"
 
 #include "aom_dsp/aom_dsp_common.h"
 #include "aom_ports/mem.h"
@@ -217,6 +218,15 @@ const int16_t av1_resize_filter_normative[(
 static const int16_t av1_down2_symeven_half_filter[] = { 56, 12, -3, -1 };
 static const int16_t av1_down2_symodd_half_filter[] = { 64, 35, 0, -3 };
 
+// The same filters as full 8-tap kernels, with the first tap applied to input
+// sample i - 3 when computing output sample i / 2.
+DECLARE_ALIGNED(16, static const int16_t,
+                av1_down2_symeven_filter[SUBPEL_TAPS]) = { -1, -3, 12, 56,
+                                                           56, 12, -3, -1 };
+DECLARE_ALIGNED(16, static const int16_t,
+                av1_down2_symodd_filter[SUBPEL_TAPS]) = { -3, 0, 35, 64,
+                                                          35, 0, -3, 0 };
+
 static const InterpKernel *choose_interp_filter(int in_length, int out_length) {
   int out_length16 = out_length * 16;
   if (out_length16 >= in_length * 16)
@@ -603,24 +613,6 @@ static void upscale_multistep_double_prec(const double *const input, int length,
   interpolate_double_prec(input, length, output, olength);
 }
 
-static void fill_col_to_arr(uint8_t *img, int stride, int len, uint8_t *arr) {
-  int i;
-  uint8_t *iptr = img;
-  uint8_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *aptr++ = *iptr;
-  }
-}
-
-static void fill_arr_to_col(uint8_t *img, int stride, int len, uint8_t *arr) {
-  int i;
-  uint8_t *iptr = img;
-  uint8_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *iptr = *aptr++;
-  }
-}
-
 static void fill_col_to_arr_double_prec(double *img, int stride, int len,
                                         double *arr) {
   int i;
@@ -641,16 +633,130 @@ static void fill_arr_to_col_double_prec(double *img, int stride, int len,
   }
 }
 
+static void get_interp_step(int in_length, int out_length, int32_t *delta,
+                            int32_t *offset) {
+  *delta = (((uint32_t)in_length << RS_SCALE_SUBPEL_BITS) + out_length / 2) /
+           out_length;
+  *offset =
+      in_length > out_length
+          ? (((int32_t)(in_length - out_length) << (RS_SCALE_SUBPEL_BITS - 1)) +
+             out_length / 2) /
+                out_length
+          : -(((int32_t)(out_length - in_length)
+               << (RS_SCALE_SUBPEL_BITS - 1)) +
+              out_length / 2) /
+                out_length;
+}
+
+// Returns the size of the scratch buffer needed by resize_multistep_vert()
+// and highbd_resize_multistep_vert(), in samples.
+static size_t get_vert_tmp_size(int length, int olength, int w) {
+  if (get_down2_steps(length, olength) == 0) return 0;
+  return (size_t)2 * w * get_down2_length(length, 1);
+}
+
+void av1_resize_vert_8tap_c(const uint8_t *const *src, uint8_t *dst, int w,
+                            const int16_t *filter) {
+  for (int x = 0; x < w; ++x) {
+    int sum = 0;
+    for (int k = 0; k < SUBPEL_TAPS; ++k) sum += filter[k] * src[k][x];
+    dst[x] = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
+  }
+}
+
+// Column-wise equivalent of down2_symeven() / down2_symodd(), filtering w
+// columns a whole row at a time.
+static void down2_vert(const uint8_t *const input, int in_stride, int length,
+                       uint8_t *output, int out_stride, int w) {
+  const int16_t *filter =
+      (length & 1) ? av1_down2_symodd_filter : av1_down2_symeven_filter;
+  const uint8_t *src[SUBPEL_TAPS];
+  for (int i = 0; i < length; i += 2) {
+    for (int k = 0; k < SUBPEL_TAPS; ++k) {
+      const int pk = clamp(i - SUBPEL_TAPS / 2 + 1 + k, 0, length - 1);
+      src[k] = input + pk * in_stride;
+    }
+    av1_resize_vert_8tap(src, output + (i >> 1) * out_stride, w, filter);
+  }
+}
+
+// Column-wise equivalent of interpolate().
+static void interpolate_vert(const uint8_t *const input, int in_stride,
+                             int in_length, uint8_t *output, int out_stride,
+                             int out_length, int w) {
+  const InterpKernel *interp_filters =
+      choose_interp_filter(in_length, out_length);
+  const uint8_t *src[SUBPEL_TAPS];
+  int32_t delta, offset, y;
+  get_interp_step(in_length, out_length, &delta, &offset);
+  y = offset + RS_SCALE_EXTRA_OFF;
+  for (int x = 0; x < out_length; ++x, y += delta) {
+    const int int_pel = y >> RS_SCALE_SUBPEL_BITS;
+    const int sub_pel = (y >> RS_SCALE_EXTRA_BITS) & RS_SUBPEL_MASK;
+    for (int k = 0; k < SUBPEL_TAPS; ++k) {
+      const int pk = clamp(int_pel - SUBPEL_TAPS / 2 + 1 + k, 0, in_length - 1);
+      src[k] = input + pk * in_stride;
+    }
+    av1_resize_vert_8tap(src, output + x * out_stride, w,
+                         interp_filters[sub_pel]);
+  }
+}
+
+// Column-wise equivalent of resize_multistep(): resizes the w columns of
+// input from length to olength rows. otmp must hold get_vert_tmp_size()
+// samples.
+static void resize_multistep_vert(const uint8_t *const input, int in_stride,
+                                  int length, uint8_t *output, int out_stride,
+                                  int olength, int w, uint8_t *otmp) {
+  if (length == olength) {
+    for (int i = 0; i < length; ++i)
+      memcpy(output + i * out_stride, input + i * in_stride, w);
+    return;
+  }
+  const int steps = get_down2_steps(length, olength);
+
+  if (steps > 0) {
+    const uint8_t *in = input;
+    int in_s = in_stride;
+    int filteredlength = length;
+
+    assert(otmp != NULL);
+    uint8_t *otmp2 = otmp + w * get_down2_length(length, 1);
+    for (int s = 0; s < steps; ++s) {
+      const int proj_filteredlength = get_down2_length(filteredlength, 1);
+      uint8_t *out;
+      int out_s;
+      if (s == steps - 1 && proj_filteredlength == olength) {
+        out = output;
+        out_s = out_stride;
+      } else {
+        out = (s & 1 ? otmp2 : otmp);
+        out_s = w;
+      }
+      down2_vert(in, in_s, filteredlength, out, out_s, w);
+      in = out;
+      in_s = out_s;
+      filteredlength = proj_filteredlength;
+    }
+    if (filteredlength != olength) {
+      interpolate_vert(in, in_s, filteredlength, output, out_stride, olength,
+                       w);
+    }
+  } else {
+    interpolate_vert(input, in_stride, length, output, out_stride, olength, w);
+  }
+}
+
 void av1_resize_plane(const uint8_t *const input, int height, int width,
                       int in_stride, uint8_t *output, int height2, int width2,
                       int out_stride) {
   int i;
+  const size_t vtmp_size = get_vert_tmp_size(height, height2, width2);
   uint8_t *intbuf = (uint8_t *)aom_malloc(sizeof(uint8_t) * width2 * height);
-  uint8_t *tmpbuf =
-      (uint8_t *)aom_malloc(sizeof(uint8_t) * AOMMAX(width, height));
-  uint8_t *arrbuf = (uint8_t *)aom_malloc(sizeof(uint8_t) * height);
-  uint8_t *arrbuf2 = (uint8_t *)aom_malloc(sizeof(uint8_t) * height2);
-  if (intbuf == NULL || tmpbuf == NULL || arrbuf == NULL || arrbuf2 == NULL)
+  uint8_t *tmpbuf = (uint8_t *)aom_malloc(sizeof(uint8_t) * width);
+  uint8_t *vtmpbuf =
+      vtmp_size ? (uint8_t *)aom_malloc(sizeof(uint8_t) * vtmp_size) : NULL;
+  if (intbuf == NULL || tmpbuf == NULL || (vtmp_size && vtmpbuf == NULL))
     goto Error;
   assert(width > 0);
   assert(height > 0);
@@ -659,17 +765,13 @@ void av1_resize_plane(const uint8_t *const input, int height, int width,
   for (i = 0; i < height; ++i)
     resize_multistep(input + in_stride * i, width, intbuf + width2 * i, width2,
                      tmpbuf);
-  for (i = 0; i < width2; ++i) {
-    fill_col_to_arr(intbuf + i, width2, height, arrbuf);
-    resize_multistep(arrbuf, height, arrbuf2, height2, tmpbuf);
-    fill_arr_to_col(output + i, out_stride, height2, arrbuf2);
-  }
+  resize_multistep_vert(intbuf, width2, height, output, out_stride, height2,
+                        width2, vtmpbuf);
 
 Error:
   aom_free(intbuf);
   aom_free(tmpbuf);
-  aom_free(arrbuf);
-  aom_free(arrbuf2);
+  aom_free(vtmpbuf);
 }
 
 void av1_upscale_plane_double_prec(const double *const input, int height,
@@ -995,23 +1097,96 @@ static void highbd_resize_multistep(const uint16_t *const input, int length,
   }
 }
 
-static void highbd_fill_col_to_arr(uint16_t *img, int stride, int len,
-                                   uint16_t *arr) {
-  int i;
-  uint16_t *iptr = img;
-  uint16_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *aptr++ = *iptr;
+void av1_highbd_resize_vert_8tap_c(const uint16_t *const *src, uint16_t *dst,
+                                   int w, const int16_t *filter, int bd) {
+  for (int x = 0; x < w; ++x) {
+    int sum = 0;
+    for (int k = 0; k < SUBPEL_TAPS; ++k) sum += filter[k] * src[k][x];
+    dst[x] = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
   }
 }
 
-static void highbd_fill_arr_to_col(uint16_t *img, int stride, int len,
-                                   uint16_t *arr) {
-  int i;
-  uint16_t *iptr = img;
-  uint16_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *iptr = *aptr++;
+static void highbd_down2_vert(const uint16_t *const input, int in_stride,
+                              int length, uint16_t *output, int out_stride,
+                              int w, int bd) {
+  const int16_t *filter =
+      (length & 1) ? av1_down2_symodd_filter : av1_down2_symeven_filter;
+  const uint16_t *src[SUBPEL_TAPS];
+  for (int i = 0; i < length; i += 2) {
+    for (int k = 0; k < SUBPEL_TAPS; ++k) {
+      const int pk = clamp(i - SUBPEL_TAPS / 2 + 1 + k, 0, length - 1);
+      src[k] = input + pk * in_stride;
+    }
+    av1_highbd_resize_vert_8tap(src, output + (i >> 1) * out_stride, w, filter,
+                                bd);
+  }
+}
+
+static void highbd_interpolate_vert(const uint16_t *const input, int in_stride,
+                                    int in_length, uint16_t *output,
+                                    int out_stride, int out_length, int w,
+                                    int bd) {
+  const InterpKernel *interp_filters =
+      choose_interp_filter(in_length, out_length);
+  const uint16_t *src[SUBPEL_TAPS];
+  int32_t delta, offset, y;
+  get_interp_step(in_length, out_length, &delta, &offset);
+  y = offset + RS_SCALE_EXTRA_OFF;
+  for (int x = 0; x < out_length; ++x, y += delta) {
+    const int int_pel = y >> RS_SCALE_SUBPEL_BITS;
+    const int sub_pel = (y >> RS_SCALE_EXTRA_BITS) & RS_SUBPEL_MASK;
+    for (int k = 0; k < SUBPEL_TAPS; ++k) {
+      const int pk = clamp(int_pel - SUBPEL_TAPS / 2 + 1 + k, 0, in_length - 1);
+      src[k] = input + pk * in_stride;
+    }
+    av1_highbd_resize_vert_8tap(src, output + x * out_stride, w,
+                                interp_filters[sub_pel], bd);
+  }
+}
+
+static void highbd_resize_multistep_vert(const uint16_t *const input,
+                                         int in_stride, int length,
+                                         uint16_t *output, int out_stride,
+                                         int olength, int w, uint16_t *otmp,
+                                         int bd) {
+  if (length == olength) {
+    for (int i = 0; i < length; ++i)
+      memcpy(output + i * out_stride, input + i * in_stride,
+             sizeof(output[0]) * w);
+    return;
+  }
+  const int steps = get_down2_steps(length, olength);
+
+  if (steps > 0) {
+    const uint16_t *in = input;
+    int in_s = in_stride;
+    int filteredlength = length;
+
+    assert(otmp != NULL);
+    uint16_t *otmp2 = otmp + w * get_down2_length(length, 1);
+    for (int s = 0; s < steps; ++s) {
+      const int proj_filteredlength = get_down2_length(filteredlength, 1);
+      uint16_t *out;
+      int out_s;
+      if (s == steps - 1 && proj_filteredlength == olength) {
+        out = output;
+        out_s = out_stride;
+      } else {
+        out = (s & 1 ? otmp2 : otmp);
+        out_s = w;
+      }
+      highbd_down2_vert(in, in_s, filteredlength, out, out_s, w, bd);
+      in = out;
+      in_s = out_s;
+      filteredlength = proj_filteredlength;
+    }
+    if (filteredlength != olength) {
+      highbd_interpolate_vert(in, in_s, filteredlength, output, out_stride,
+                              olength, w, bd);
+    }
+  } else {
+    highbd_interpolate_vert(input, in_stride, length, output, out_stride,
+                            olength, w, bd);
   }
 }
 
@@ -1019,29 +1194,25 @@ void av1_highbd_resize_plane(const uint8_t *const input, int height, int width,
                              int in_stride, uint8_t *output, int height2,
                              int width2, int out_stride, int bd) {
   int i;
+  const size_t vtmp_size = get_vert_tmp_size(height, height2, width2);
   uint16_t *intbuf = (uint16_t *)aom_malloc(sizeof(uint16_t) * width2 * height);
-  uint16_t *tmpbuf =
-      (uint16_t *)aom_malloc(sizeof(uint16_t) * AOMMAX(width, height));
-  uint16_t *arrbuf = (uint16_t *)aom_malloc(sizeof(uint16_t) * height);
-  uint16_t *arrbuf2 = (uint16_t *)aom_malloc(sizeof(uint16_t) * height2);
-  if (intbuf == NULL || tmpbuf == NULL || arrbuf == NULL || arrbuf2 == NULL)
+  uint16_t *tmpbuf = (uint16_t *)aom_malloc(sizeof(uint16_t) * width);
+  uint16_t *vtmpbuf =
+      vtmp_size ? (uint16_t *)aom_malloc(sizeof(uint16_t) * vtmp_size) : NULL;
+  if (intbuf == NULL || tmpbuf == NULL || (vtmp_size && vtmpbuf == NULL))
     goto Error;
   for (i = 0; i < height; ++i) {
     highbd_resize_multistep(CONVERT_TO_SHORTPTR(input + in_stride * i), width,
                             intbuf + width2 * i, width2, tmpbuf, bd);
   }
-  for (i = 0; i < width2; ++i) {
-    highbd_fill_col_to_arr(intbuf + i, width2, height, arrbuf);
-    highbd_resize_multistep(arrbuf, height, arrbuf2, height2, tmpbuf, bd);
-    highbd_fill_arr_to_col(CONVERT_TO_SHORTPTR(output + i), out_stride, height2,
-                           arrbuf2);
-  }
+  highbd_resize_multistep_vert(intbuf, width2, height,
+                               CONVERT_TO_SHORTPTR(output), out_stride, height2,
+                               width2, vtmpbuf, bd);
 
 Error:
   aom_free(intbuf);
   aom_free(tmpbuf);
-  aom_free(arrbuf);
-  aom_free(arrbuf2);
+  aom_free(vtmpbuf);
 }
 
 static void highbd_upscale_normative_rect(const uint8_t *const input,
@@ -1188,9 +1359,8 @@ void av1_highbd_resize_frame444(const uint8_t *const y, int y_stride,
 }
 #endif  // CONFIG_AV1_HIGHBITDEPTH
 
-void av1_resize_and_extend_frame(const YV12_BUFFER_CONFIG *src,
-                                 YV12_BUFFER_CONFIG *dst, int bd,
-                                 const int num_planes) {
+void av1_resize_frame(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst,
+                      int bd, const int num_planes) {
   // TODO(dkovalev): replace YV12_BUFFER_CONFIG with aom_image_t
 
   // We use AOMMIN(num_planes, MAX_MB_PLANE) instead of num_planes to quiet
@@ -1216,6 +1386,191 @@ void av1_resize_and_extend_frame(const YV12_BUFFER_CONFIG *src,
                      dst->crop_widths[is_uv], dst->strides[is_uv]);
 #endif
   }
+}
+
+void av1_resize_and_extend_frame(const YV12_BUFFER_CONFIG *src,
+                                 YV12_BUFFER_CONFIG *dst, int bd,
+                                 const int num_planes) {
+  av1_resize_frame(src, dst, bd, num_planes);
+  aom_extend_frame_borders(dst, num_planes);
+}
+
+// Planes with fewer pixels than this are not worth splitting across threads.
+#define RESIZE_MT_MIN_PIXELS (640 * 360)
+
+typedef struct {
+  const uint8_t *input;
+  int height;
+  int width;
+  int in_stride;
+  uint8_t *output;
+  int height2;
+  int width2;
+  int out_stride;
+  // width2 x height intermediate plane (uint16_t samples for high bitdepth).
+  void *intbuf;
+  int use_highbitdepth;
+  int bd;
+  // Pass 0 resizes the input rows [start, end) horizontally into intbuf,
+  // pass 1 resizes the intbuf columns [start, end) vertically into output.
+  int pass;
+  int start;
+  int end;
+} ResizeJobData;
+
+static int resize_plane_rows_lowbd(const ResizeJobData *job) {
+  uint8_t *const intbuf = (uint8_t *)job->intbuf;
+  uint8_t *tmpbuf = (uint8_t *)aom_malloc(sizeof(uint8_t) * job->width);
+  if (tmpbuf == NULL) return 0;
+  for (int i = job->start; i < job->end; ++i)
+    resize_multistep(job->input + job->in_stride * i, job->width,
+                     intbuf + job->width2 * i, job->width2, tmpbuf);
+  aom_free(tmpbuf);
+  return 1;
+}
+
+static int resize_plane_cols_lowbd(const ResizeJobData *job) {
+  const int w = job->end - job->start;
+  const size_t vtmp_size = get_vert_tmp_size(job->height, job->height2, w);
+  uint8_t *vtmpbuf =
+      vtmp_size ? (uint8_t *)aom_malloc(sizeof(uint8_t) * vtmp_size) : NULL;
+  if (vtmp_size && vtmpbuf == NULL) return 0;
+  resize_multistep_vert((uint8_t *)job->intbuf + job->start, job->width2,
+                        job->height, job->output + job->start,
+                        job->out_stride, job->height2, w, vtmpbuf);
+  aom_free(vtmpbuf);
+  return 1;
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+static int resize_plane_rows_highbd(const ResizeJobData *job) {
+  const uint16_t *const input = CONVERT_TO_SHORTPTR(job->input);
+  uint16_t *const intbuf = (uint16_t *)job->intbuf;
+  uint16_t *tmpbuf = (uint16_t *)aom_malloc(sizeof(uint16_t) * job->width);
+  if (tmpbuf == NULL) return 0;
+  for (int i = job->start; i < job->end; ++i)
+    highbd_resize_multistep(input + job->in_stride * i, job->width,
+                            intbuf + job->width2 * i, job->width2, tmpbuf,
+                            job->bd);
+  aom_free(tmpbuf);
+  return 1;
+}
+
+static int resize_plane_cols_highbd(const ResizeJobData *job) {
+  const int w = job->end - job->start;
+  const size_t vtmp_size = get_vert_tmp_size(job->height, job->height2, w);
+  uint16_t *vtmpbuf =
+      vtmp_size ? (uint16_t *)aom_malloc(sizeof(uint16_t) * vtmp_size) : NULL;
+  if (vtmp_size && vtmpbuf == NULL) return 0;
+  highbd_resize_multistep_vert(
+      (uint16_t *)job->intbuf + job->start, job->width2, job->height,
+      CONVERT_TO_SHORTPTR(job->output) + job->start, job->out_stride,
+      job->height2, w, vtmpbuf, job->bd);
+  aom_free(vtmpbuf);
+  return 1;
+}
+#endif  // CONFIG_AV1_HIGHBITDEPTH
+
+static int resize_plane_worker_hook(void *arg1, void *unused) {
+  const ResizeJobData *const job = (const ResizeJobData *)arg1;
+  (void)unused;
+  if (job->start >= job->end) return 1;
+#if CONFIG_AV1_HIGHBITDEPTH
+  if (job->use_highbitdepth) {
+    return job->pass == 0 ? resize_plane_rows_highbd(job)
+                          : resize_plane_cols_highbd(job);
+  }
+#endif
+  return job->pass == 0 ? resize_plane_rows_lowbd(job)
+                        : resize_plane_cols_lowbd(job);
+}
+
+static void resize_plane_mt(const uint8_t *const input, int height, int width,
+                            int in_stride, uint8_t *output, int height2,
+                            int width2, int out_stride, int use_highbitdepth,
+                            int bd, AVxWorker *workers, int num_workers) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const size_t sample_size =
+      use_highbitdepth ? sizeof(uint16_t) : sizeof(uint8_t);
+  ResizeJobData *jobs =
+      (ResizeJobData *)aom_calloc(num_workers, sizeof(*jobs));
+  void *intbuf = aom_malloc(sample_size * width2 * height);
+  if (jobs == NULL || intbuf == NULL) goto Error;
+
+  for (int pass = 0; pass < 2; ++pass) {
+    const int length = pass == 0 ? height : width2;
+    // Keep the column ranges a multiple of 16 wide for the SIMD kernels.
+    const int align_log2 = pass == 0 ? 0 : 4;
+    // Worker 0 runs on the calling thread, as in the encoder.
+    for (int i = num_workers - 1; i >= 0; --i) {
+      ResizeJobData *const job = &jobs[i];
+      AVxWorker *const worker = &workers[i];
+      job->input = input;
+      job->height = height;
+      job->width = width;
+      job->in_stride = in_stride;
+      job->output = output;
+      job->height2 = height2;
+      job->width2 = width2;
+      job->out_stride = out_stride;
+      job->intbuf = intbuf;
+      job->use_highbitdepth = use_highbitdepth;
+      job->bd = bd;
+      job->pass = pass;
+      job->start = AOMMIN(
+          ALIGN_POWER_OF_TWO(length * i / num_workers, align_log2), length);
+      job->end = AOMMIN(
+          ALIGN_POWER_OF_TWO(length * (i + 1) / num_workers, align_log2),
+          length);
+
+      worker->hook = resize_plane_worker_hook;
+      worker->data1 = job;
+      worker->data2 = NULL;
+      if (i == 0)
+        winterface->execute(worker);
+      else
+        winterface->launch(worker);
+    }
+    // Pass 1 reads rows produced by every worker in pass 0.
+    for (int i = 0; i < num_workers; ++i) winterface->sync(&workers[i]);
+  }
+
+Error:
+  aom_free(jobs);
+  aom_free(intbuf);
+}
+
+void av1_resize_and_extend_frame_mt(const YV12_BUFFER_CONFIG *src,
+                                    YV12_BUFFER_CONFIG *dst, int bd,
+                                    const int num_planes, AVxWorker *workers,
+                                    int num_workers) {
+  for (int i = 0; i < AOMMIN(num_planes, MAX_MB_PLANE); ++i) {
+    const int is_uv = i > 0;
+    const int use_highbitdepth = (src->flags & YV12_FLAG_HIGHBITDEPTH) != 0;
+    if (num_workers > 1 &&
+        src->crop_widths[is_uv] * src->crop_heights[is_uv] >=
+            RESIZE_MT_MIN_PIXELS) {
+      resize_plane_mt(src->buffers[i], src->crop_heights[is_uv],
+                      src->crop_widths[is_uv], src->strides[is_uv],
+                      dst->buffers[i], dst->crop_heights[is_uv],
+                      dst->crop_widths[is_uv], dst->strides[is_uv],
+                      use_highbitdepth, bd, workers, num_workers);
+      continue;
+    }
+#if CONFIG_AV1_HIGHBITDEPTH
+    if (use_highbitdepth) {
+      av1_highbd_resize_plane(src->buffers[i], src->crop_heights[is_uv],
+                              src->crop_widths[is_uv], src->strides[is_uv],
+                              dst->buffers[i], dst->crop_heights[is_uv],
+                              dst->crop_widths[is_uv], dst->strides[is_uv], bd);
+      continue;
+    }
+#endif
+    av1_resize_plane(src->buffers[i], src->crop_heights[is_uv],
+                     src->crop_widths[is_uv], src->strides[is_uv],
+                     dst->buffers[i], dst->crop_heights[is_uv],
+                     dst->crop_widths[is_uv], dst->strides[is_uv]);
+  }
   aom_extend_frame_borders(dst, num_planes);
 }
 
@@ -14,6 +14,7 @@
 
 #include <stdio.h>
 #include "aom/aom_integer.h"
+#include "aom_util/aom_thread.h"
 #include "av1/common/onyxc_int.h"
 
 #ifdef __cplusplus
@@ -63,9 +64,19 @@ void av1_highbd_resize_frame444(const uint8_t *const y, int y_stride,
                                 uint8_t *oy, int oy_stride, uint8_t *ou,
                                 uint8_t *ov, int ouv_stride, int oheight,
                                 int owidth, int bd);
+// Resizes the visible area of the first num_planes planes of src into dst.
+// The borders of dst are left untouched.
+void av1_resize_frame(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst,
+                      int bd, const int num_planes);
 void av1_resize_and_extend_frame(const YV12_BUFFER_CONFIG *src,
                                  YV12_BUFFER_CONFIG *dst, int bd,
                                  const int num_planes);
+// Same as av1_resize_and_extend_frame(), but splits large planes across the
+// given workers: first by input rows, then by output columns.
+void av1_resize_and_extend_frame_mt(const YV12_BUFFER_CONFIG *src,
+                                    YV12_BUFFER_CONFIG *dst, int bd,
+                                    const int num_planes, AVxWorker *workers,
+                                    int num_workers);
 
 void av1_upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
                                 int src_stride, uint8_t *dst, int dst_stride,
@@ -108,6 +108,23 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
 #endif
                               AVxWorker *workers, int num_workers,
                               AV1LfSync *lf_sync);
+
+// Prepares lf_sync and the frame level loop filter state for a deblocking
+// pass whose jobs are scheduled by the caller rather than by
+// av1_loop_filter_frame_mt(). Each (mi_row, plane, dir) job is then run with
+// av1_thread_loop_filter_sb_row(). Vertical edge jobs never block. The
+// horizontal edge job of a superblock row must not be started before the
+// vertical edge jobs of that row and of the row below it have been started.
+void av1_loop_filter_frame_mt_init(struct AV1Common *cm, int plane_start,
+                                   int plane_end, int num_workers,
+                                   AV1LfSync *lf_sync);
+void av1_thread_loop_filter_sb_row(const YV12_BUFFER_CONFIG *const frame_buffer,
+                                   struct AV1Common *const cm,
+                                   struct macroblockd_plane *planes,
+                                   struct macroblockd *xd,
+                                   AV1LfSync *const lf_sync, int mi_row,
+                                   int plane, int dir);
+
 void av1_loop_restoration_filter_frame_mt(YV12_BUFFER_CONFIG *frame,
                                           struct AV1Common *cm,
                                           int optimized_lr, AVxWorker *workers,
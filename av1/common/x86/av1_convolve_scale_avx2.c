@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/aom_filter.h"
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+#include "av1/common/convolve.h"
+
+// Unlike the SSE4.1 version, which transposes the intermediate block, both
+// passes work on 8 output pixels of a row at a time:
+// - the horizontal pass gathers the 8 source windows of a row, whose filters
+//   only depend on the column and are loaded once per block,
+// - the vertical pass uses the same filter for a whole row, so it is a plain
+//   8-tap vertical convolution of the intermediate rows.
+// Blocks narrower than 8 pixels use the SSE4.1 version.
+
+// Filter coefficients of 8 consecutive columns, arranged for
+// hfilter_reduce(): coeffs[i] holds the filters of columns i and i + 4.
+typedef struct {
+  __m256i coeffs[4];
+} HFilterCoeffs;
+
+// Computes the source offsets and loads the filters of the w columns.
+static INLINE void get_hfilters(int w, int subpel_x_qn, int x_step_qn,
+                                const InterpFilterParams *filter_params,
+                                int *offsets, HFilterCoeffs *coeffs) {
+  int x_qn = subpel_x_qn;
+  const int16_t *filters[8];
+  for (int x = 0; x < w; ++x, x_qn += x_step_qn) {
+    const int filter_idx = (x_qn & SCALE_SUBPEL_MASK) >> SCALE_EXTRA_BITS;
+    assert(filter_idx < SUBPEL_SHIFTS);
+    offsets[x] = x_qn >> SCALE_SUBPEL_BITS;
+    filters[x & 7] =
+        av1_get_interp_filter_subpel_kernel(filter_params, filter_idx);
+    if ((x & 7) == 7) {
+      for (int i = 0; i < 4; ++i) {
+        coeffs[x >> 3].coeffs[i] = yy_set_m128i(xx_loadu_128(filters[i + 4]),
+                                                xx_loadu_128(filters[i]));
+      }
+    }
+  }
+}
+
+// Reduces the 8-tap products of 8 columns, data[i] holding columns i and
+// i + 4, and rounds them to 16 bits.
+static INLINE __m128i hfilter_reduce(const __m256i *data,
+                                     const HFilterCoeffs *coeffs,
+                                     __m256i round_add, __m128i round_shift) {
+  const __m256i conv0 = _mm256_madd_epi16(data[0], coeffs->coeffs[0]);
+  const __m256i conv1 = _mm256_madd_epi16(data[1], coeffs->coeffs[1]);
+  const __m256i conv2 = _mm256_madd_epi16(data[2], coeffs->coeffs[2]);
+  const __m256i conv3 = _mm256_madd_epi16(data[3], coeffs->coeffs[3]);
+  // The 128-bit lanes hold columns 0 to 3 and 4 to 7 respectively.
+  const __m256i conv = _mm256_hadd_epi32(_mm256_hadd_epi32(conv0, conv1),
+                                         _mm256_hadd_epi32(conv2, conv3));
+  const __m256i shifted =
+      _mm256_sra_epi32(_mm256_add_epi32(conv, round_add), round_shift);
+  return _mm_packus_epi32(_mm256_castsi256_si128(shifted),
+                          _mm256_extracti128_si256(shifted, 1));
+}
+
+static void hfilter8_avx2(const uint8_t *src, int src_stride, int16_t *dst,
+                          int w, int h, const int *offsets,
+                          const HFilterCoeffs *coeffs, int round) {
+  const int bd = 8;
+  const __m256i round_add =
+      _mm256_set1_epi32((1 << round) / 2 + (1 << (bd + FILTER_BITS - 1)));
+  const __m128i round_shift = _mm_cvtsi32_si128(round);
+
+  src -= SUBPEL_TAPS / 2 - 1;
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; x += 8) {
+      const int *const offs = offsets + x;
+      __m256i data[4];
+      for (int i = 0; i < 4; ++i) {
+        data[i] = _mm256_cvtepu8_epi16(
+            _mm_unpacklo_epi64(xx_loadl_64(src + offs[i]),
+                               xx_loadl_64(src + offs[i + 4])));
+      }
+      xx_storeu_128(dst + x,
+                    hfilter_reduce(data, &coeffs[x >> 3], round_add,
+                                   round_shift));
+    }
+    src += src_stride;
+    dst += w;
+  }
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+static void highbd_hfilter8_avx2(const uint16_t *src, int src_stride,
+                                 int16_t *dst, int w, int h,
+                                 const int *offsets,
+                                 const HFilterCoeffs *coeffs, int round,
+                                 int bd) {
+  const __m256i round_add =
+      _mm256_set1_epi32((1 << round) / 2 + (1 << (bd + FILTER_BITS - 1)));
+  const __m128i round_shift = _mm_cvtsi32_si128(round);
+
+  src -= SUBPEL_TAPS / 2 - 1;
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; x += 8) {
+      const int *const offs = offsets + x;
+      __m256i data[4];
+      for (int i = 0; i < 4; ++i) {
+        data[i] = yy_loadu2_128(src + offs[i + 4], src + offs[i]);
+      }
+      xx_storeu_128(dst + x,
+                    hfilter_reduce(data, &coeffs[x >> 3], round_add,
+                                   round_shift));
+    }
+    src += src_stride;
+    dst += w;
+  }
+}
+#endif  // CONFIG_AV1_HIGHBITDEPTH
+
+// Returns the unrounded 8-tap vertical convolution of 8 columns of the
+// intermediate block, src pointing to the first of the 8 rows.
+static INLINE __m256i vfilter_8(const int16_t *src, int stride,
+                                const __m256i *coeffs) {
+  __m256i sum = _mm256_setzero_si256();
+  for (int k = 0; k < SUBPEL_TAPS; k += 2) {
+    const __m128i r0 = xx_loadu_128(src + k * stride);
+    const __m128i r1 = xx_loadu_128(src + (k + 1) * stride);
+    const __m256i r01 = yy_set_m128i(_mm_unpackhi_epi16(r0, r1),
+                                     _mm_unpacklo_epi16(r0, r1));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(r01, coeffs[k >> 1]));
+  }
+  return sum;
+}
+
+// Loads the vertical filter of a row as pairs of taps for madd.
+static INLINE void get_vfilter(int y_qn,
+                               const InterpFilterParams *filter_params,
+                               __m256i *coeffs) {
+  const int filter_idx = (y_qn & SCALE_SUBPEL_MASK) >> SCALE_EXTRA_BITS;
+  assert(filter_idx < SUBPEL_SHIFTS);
+  const int16_t *filter =
+      av1_get_interp_filter_subpel_kernel(filter_params, filter_idx);
+  const __m256i f = _mm256_broadcastsi128_si256(xx_loadu_128(filter));
+  coeffs[0] = _mm256_shuffle_epi32(f, 0x00);
+  coeffs[1] = _mm256_shuffle_epi32(f, 0x55);
+  coeffs[2] = _mm256_shuffle_epi32(f, 0xaa);
+  coeffs[3] = _mm256_shuffle_epi32(f, 0xff);
+}
+
+// Rounding parameters shared by the rows of the vertical pass.
+typedef struct {
+  __m256i res_add;
+  __m128i round_1;
+  __m256i sub;
+  __m256i bits_add;
+  __m128i bits;
+  __m256i fwd_offset;
+  __m256i bck_offset;
+} VFilterRound;
+
+static INLINE void init_vfilter_round(const ConvolveParams *conv_params,
+                                      int bd, VFilterRound *r) {
+  const int offset_bits = bd + 2 * FILTER_BITS - conv_params->round_0;
+  const int bits =
+      FILTER_BITS * 2 - conv_params->round_0 - conv_params->round_1;
+  r->res_add = _mm256_set1_epi32((1 << offset_bits) +
+                                 ((1 << conv_params->round_1) >> 1));
+  r->round_1 = _mm_cvtsi32_si128(conv_params->round_1);
+  r->sub = _mm256_set1_epi32((1 << (offset_bits - conv_params->round_1)) +
+                             (1 << (offset_bits - conv_params->round_1 - 1)));
+  r->bits_add = _mm256_set1_epi32((1 << bits) >> 1);
+  r->bits = _mm_cvtsi32_si128(bits);
+  r->fwd_offset = _mm256_set1_epi32(conv_params->fwd_offset);
+  r->bck_offset = _mm256_set1_epi32(conv_params->bck_offset);
+}
+
+// Rounds the vertical sums of 8 pixels. In the compound case without
+// averaging, the intermediate result is stored to dst16 and 0 is returned.
+// Otherwise the final pixel values are returned as 32-bit integers, to be
+// clipped by the caller.
+static INLINE int vfilter_round(__m256i sum, const VFilterRound *r,
+                                const ConvolveParams *conv_params,
+                                CONV_BUF_TYPE *dst16, __m256i *out) {
+  __m256i res = _mm256_sra_epi32(_mm256_add_epi32(sum, r->res_add), r->round_1);
+  if (conv_params->is_compound) {
+    if (!conv_params->do_average) {
+      xx_storeu_128(dst16, _mm_packus_epi32(_mm256_castsi256_si128(res),
+                                            _mm256_extracti128_si256(res, 1)));
+      return 0;
+    }
+    const __m256i p = _mm256_cvtepu16_epi32(xx_loadu_128(dst16));
+    if (conv_params->use_dist_wtd_comp_avg) {
+      res = _mm256_add_epi32(_mm256_mullo_epi32(p, r->fwd_offset),
+                             _mm256_mullo_epi32(res, r->bck_offset));
+      res = _mm256_srai_epi32(res, DIST_PRECISION_BITS);
+    } else {
+      res = _mm256_srai_epi32(_mm256_add_epi32(p, res), 1);
+    }
+  }
+  res = _mm256_sub_epi32(res, r->sub);
+  *out = _mm256_sra_epi32(_mm256_add_epi32(res, r->bits_add), r->bits);
+  return 1;
+}
+
+static void vfilter8_avx2(const int16_t *src, int src_stride, uint8_t *dst,
+                          int dst_stride, int w, int h, int subpel_y_qn,
+                          int y_step_qn,
+                          const InterpFilterParams *filter_params,
+                          const ConvolveParams *conv_params) {
+  CONV_BUF_TYPE *dst16 = conv_params->dst;
+  const int dst16_stride = conv_params->dst_stride;
+  VFilterRound round;
+  init_vfilter_round(conv_params, 8, &round);
+
+  int y_qn = subpel_y_qn;
+  for (int y = 0; y < h; ++y, y_qn += y_step_qn) {
+    const int16_t *src_y = src + (y_qn >> SCALE_SUBPEL_BITS) * src_stride;
+    __m256i coeffs[SUBPEL_TAPS / 2];
+    get_vfilter(y_qn, filter_params, coeffs);
+    for (int x = 0; x < w; x += 8) {
+      const __m256i sum = vfilter_8(src_y + x, src_stride, coeffs);
+      __m256i res;
+      if (vfilter_round(sum, &round, conv_params,
+                        dst16 + y * dst16_stride + x, &res)) {
+        const __m128i res_16 = _mm_packs_epi32(
+            _mm256_castsi256_si128(res), _mm256_extracti128_si256(res, 1));
+        _mm_storel_epi64((__m128i *)(dst + y * dst_stride + x),
+                         _mm_packus_epi16(res_16, res_16));
+      }
+    }
+  }
+}
+
+void av1_convolve_2d_scale_avx2(const uint8_t *src, int src_stride,
+                                uint8_t *dst8, int dst8_stride, int w, int h,
+                                const InterpFilterParams *filter_params_x,
+                                const InterpFilterParams *filter_params_y,
+                                const int subpel_x_qn, const int x_step_qn,
+                                const int subpel_y_qn, const int y_step_qn,
+                                ConvolveParams *conv_params) {
+  if (w % 8) {
+    av1_convolve_2d_scale_sse4_1(src, src_stride, dst8, dst8_stride, w, h,
+                                 filter_params_x, filter_params_y, subpel_x_qn,
+                                 x_step_qn, subpel_y_qn, y_step_qn,
+                                 conv_params);
+    return;
+  }
+  DECLARE_ALIGNED(32, int16_t,
+                  im_block[(2 * MAX_SB_SIZE + MAX_FILTER_TAP) * MAX_SB_SIZE]);
+  int offsets[MAX_SB_SIZE];
+  HFilterCoeffs coeffs[MAX_SB_SIZE / 8];
+  const int im_h = (((h - 1) * y_step_qn + subpel_y_qn) >> SCALE_SUBPEL_BITS) +
+                   filter_params_y->taps;
+  const int fo_vert = filter_params_y->taps / 2 - 1;
+  assert(filter_params_x->taps == 8 && filter_params_y->taps == 8);
+
+  get_hfilters(w, subpel_x_qn, x_step_qn, filter_params_x, offsets, coeffs);
+  hfilter8_avx2(src - fo_vert * src_stride, src_stride, im_block, w, im_h,
+                offsets, coeffs, conv_params->round_0);
+  vfilter8_avx2(im_block, w, dst8, dst8_stride, w, h, subpel_y_qn, y_step_qn,
+                filter_params_y, conv_params);
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+static void highbd_vfilter8_avx2(const int16_t *src, int src_stride,
+                                 uint16_t *dst, int dst_stride, int w, int h,
+                                 int subpel_y_qn, int y_step_qn,
+                                 const InterpFilterParams *filter_params,
+                                 const ConvolveParams *conv_params, int bd) {
+  CONV_BUF_TYPE *dst16 = conv_params->dst;
+  const int dst16_stride = conv_params->dst_stride;
+  const __m128i max_pixel = _mm_set1_epi16((1 << bd) - 1);
+  VFilterRound round;
+  init_vfilter_round(conv_params, bd, &round);
+
+  int y_qn = subpel_y_qn;
+  for (int y = 0; y < h; ++y, y_qn += y_step_qn) {
+    const int16_t *src_y = src + (y_qn >> SCALE_SUBPEL_BITS) * src_stride;
+    __m256i coeffs[SUBPEL_TAPS / 2];
+    get_vfilter(y_qn, filter_params, coeffs);
+    for (int x = 0; x < w; x += 8) {
+      const __m256i sum = vfilter_8(src_y + x, src_stride, coeffs);
+      __m256i res;
+      if (vfilter_round(sum, &round, conv_params,
+                        dst16 + y * dst16_stride + x, &res)) {
+        const __m128i res_16 = _mm_packus_epi32(
+            _mm256_castsi256_si128(res), _mm256_extracti128_si256(res, 1));
+        xx_storeu_128(dst + y * dst_stride + x,
+                      _mm_min_epu16(res_16, max_pixel));
+      }
+    }
+  }
+}
+
+void av1_highbd_convolve_2d_scale_avx2(
+    const uint16_t *src, int src_stride, uint16_t *dst, int dst_stride, int w,
+    int h, const InterpFilterParams *filter_params_x,
+    const InterpFilterParams *filter_params_y, const int subpel_x_qn,
+    const int x_step_qn, const int subpel_y_qn, const int y_step_qn,
+    ConvolveParams *conv_params, int bd) {
+  if (w % 8) {
+    av1_highbd_convolve_2d_scale_sse4_1(src, src_stride, dst, dst_stride, w, h,
+                                        filter_params_x, filter_params_y,
+                                        subpel_x_qn, x_step_qn, subpel_y_qn,
+                                        y_step_qn, conv_params, bd);
+    return;
+  }
+  DECLARE_ALIGNED(32, int16_t,
+                  im_block[(2 * MAX_SB_SIZE + MAX_FILTER_TAP) * MAX_SB_SIZE]);
+  int offsets[MAX_SB_SIZE];
+  HFilterCoeffs coeffs[MAX_SB_SIZE / 8];
+  const int im_h = (((h - 1) * y_step_qn + subpel_y_qn) >> SCALE_SUBPEL_BITS) +
+                   filter_params_y->taps;
+  const int fo_vert = filter_params_y->taps / 2 - 1;
+  assert(filter_params_x->taps == 8 && filter_params_y->taps == 8);
+
+  get_hfilters(w, subpel_x_qn, x_step_qn, filter_params_x, offsets, coeffs);
+  highbd_hfilter8_avx2(src - fo_vert * src_stride, src_stride, im_block, w,
+                       im_h, offsets, coeffs, conv_params->round_0, bd);
+  highbd_vfilter8_avx2(im_block, w, dst, dst_stride, w, h, subpel_y_qn,
+                       y_step_qn, filter_params_y, conv_params, bd);
+}
+#endif  // CONFIG_AV1_HIGHBITDEPTH
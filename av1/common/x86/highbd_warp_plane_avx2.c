@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "av1/common/warped_motion.h"
+
+// The kernels below follow av1_highbd_warp_affine_sse4_1(), but work on two
+// rows at a time: the low 128-bit lane of every register holds row k and the
+// high lane row k + 1.
+
+static const uint8_t warp_highbd_arrange_bytes[16] = { 0,  2,  4,  6, 8, 10,
+                                                       12, 14, 1,  3, 5, 7,
+                                                       9,  11, 13, 15 };
+
+DECLARE_ALIGNED(32, static const uint8_t,
+                highbd_shuffle_alpha0_mask0_avx2[32]) = {
+  0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3,
+  0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3
+};
+DECLARE_ALIGNED(32, static const uint8_t,
+                highbd_shuffle_alpha0_mask1_avx2[32]) = {
+  4, 5, 6, 7, 4, 5, 6, 7, 4, 5, 6, 7, 4, 5, 6, 7,
+  4, 5, 6, 7, 4, 5, 6, 7, 4, 5, 6, 7, 4, 5, 6, 7
+};
+DECLARE_ALIGNED(32, static const uint8_t,
+                highbd_shuffle_alpha0_mask2_avx2[32]) = {
+  8, 9, 10, 11, 8, 9, 10, 11, 8, 9, 10, 11, 8, 9, 10, 11,
+  8, 9, 10, 11, 8, 9, 10, 11, 8, 9, 10, 11, 8, 9, 10, 11
+};
+DECLARE_ALIGNED(32, static const uint8_t,
+                highbd_shuffle_alpha0_mask3_avx2[32]) = {
+  12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15,
+  12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15
+};
+
+// Loads the 8 filter taps at offset s0 into the low lane and those at offset
+// s1 into the high lane.
+static INLINE __m256i highbd_load_filter_x2(int s0, int s1) {
+  const __m128i f0 = _mm_loadu_si128(
+      (__m128i *)(av1_warped_filter + (s0 >> WARPEDDIFF_PREC_BITS)));
+  const __m128i f1 = _mm_loadu_si128(
+      (__m128i *)(av1_warped_filter + (s1 >> WARPEDDIFF_PREC_BITS)));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(f0), f1, 1);
+}
+
+// Prepares the coefficients of 8 consecutive output pixels whose filter
+// offsets start at s0 (row k) and s1 (row k + 1) and step by 'step'. Used by
+// both the horizontal (step alpha) and the vertical (step gamma) filter.
+static INLINE void highbd_prepare_filter_coeff_avx2(int step, int s0, int s1,
+                                                    __m256i *coeff) {
+  // Filter even-index pixels
+  const __m256i tmp_0 = highbd_load_filter_x2(s0 + 0 * step, s1 + 0 * step);
+  const __m256i tmp_2 = highbd_load_filter_x2(s0 + 2 * step, s1 + 2 * step);
+  const __m256i tmp_4 = highbd_load_filter_x2(s0 + 4 * step, s1 + 4 * step);
+  const __m256i tmp_6 = highbd_load_filter_x2(s0 + 6 * step, s1 + 6 * step);
+
+  // coeffs 0 1 0 1 2 3 2 3 for pixels 0, 2
+  const __m256i tmp_8 = _mm256_unpacklo_epi32(tmp_0, tmp_2);
+  // coeffs 0 1 0 1 2 3 2 3 for pixels 4, 6
+  const __m256i tmp_10 = _mm256_unpacklo_epi32(tmp_4, tmp_6);
+  // coeffs 4 5 4 5 6 7 6 7 for pixels 0, 2
+  const __m256i tmp_12 = _mm256_unpackhi_epi32(tmp_0, tmp_2);
+  // coeffs 4 5 4 5 6 7 6 7 for pixels 4, 6
+  const __m256i tmp_14 = _mm256_unpackhi_epi32(tmp_4, tmp_6);
+
+  // coeffs 0 1 0 1 0 1 0 1 for pixels 0, 2, 4, 6
+  coeff[0] = _mm256_unpacklo_epi64(tmp_8, tmp_10);
+  // coeffs 2 3 2 3 2 3 2 3 for pixels 0, 2, 4, 6
+  coeff[2] = _mm256_unpackhi_epi64(tmp_8, tmp_10);
+  // coeffs 4 5 4 5 4 5 4 5 for pixels 0, 2, 4, 6
+  coeff[4] = _mm256_unpacklo_epi64(tmp_12, tmp_14);
+  // coeffs 6 7 6 7 6 7 6 7 for pixels 0, 2, 4, 6
+  coeff[6] = _mm256_unpackhi_epi64(tmp_12, tmp_14);
+
+  // Filter odd-index pixels
+  const __m256i tmp_1 = highbd_load_filter_x2(s0 + 1 * step, s1 + 1 * step);
+  const __m256i tmp_3 = highbd_load_filter_x2(s0 + 3 * step, s1 + 3 * step);
+  const __m256i tmp_5 = highbd_load_filter_x2(s0 + 5 * step, s1 + 5 * step);
+  const __m256i tmp_7 = highbd_load_filter_x2(s0 + 7 * step, s1 + 7 * step);
+
+  const __m256i tmp_9 = _mm256_unpacklo_epi32(tmp_1, tmp_3);
+  const __m256i tmp_11 = _mm256_unpacklo_epi32(tmp_5, tmp_7);
+  const __m256i tmp_13 = _mm256_unpackhi_epi32(tmp_1, tmp_3);
+  const __m256i tmp_15 = _mm256_unpackhi_epi32(tmp_5, tmp_7);
+
+  coeff[1] = _mm256_unpacklo_epi64(tmp_9, tmp_11);
+  coeff[3] = _mm256_unpackhi_epi64(tmp_9, tmp_11);
+  coeff[5] = _mm256_unpacklo_epi64(tmp_13, tmp_15);
+  coeff[7] = _mm256_unpackhi_epi64(tmp_13, tmp_15);
+}
+
+// Same as highbd_prepare_filter_coeff_avx2() for step == 0.
+static INLINE void highbd_prepare_filter_coeff_step0_avx2(int s0, int s1,
+                                                          __m256i *coeff) {
+  const __m256i tmp_0 = highbd_load_filter_x2(s0, s1);
+
+  coeff[0] = _mm256_shuffle_epi8(
+      tmp_0, _mm256_load_si256((__m256i *)highbd_shuffle_alpha0_mask0_avx2));
+  coeff[2] = _mm256_shuffle_epi8(
+      tmp_0, _mm256_load_si256((__m256i *)highbd_shuffle_alpha0_mask1_avx2));
+  coeff[4] = _mm256_shuffle_epi8(
+      tmp_0, _mm256_load_si256((__m256i *)highbd_shuffle_alpha0_mask2_avx2));
+  coeff[6] = _mm256_shuffle_epi8(
+      tmp_0, _mm256_load_si256((__m256i *)highbd_shuffle_alpha0_mask3_avx2));
+
+  coeff[1] = coeff[0];
+  coeff[3] = coeff[2];
+  coeff[5] = coeff[4];
+  coeff[7] = coeff[6];
+}
+
+static INLINE void highbd_prepare_coeff_avx2(int step, int s0, int s1,
+                                             __m256i *coeff) {
+  if (step == 0)
+    highbd_prepare_filter_coeff_step0_avx2(s0, s1, coeff);
+  else
+    highbd_prepare_filter_coeff_avx2(step, s0, s1, coeff);
+}
+
+// Horizontally filters the pixels ix4 - 7 ... ix4 + 8 of two rows, held in
+// src (pixels -7 ... 0) and src2 (pixels 1 ... 8), and stores the results in
+// tmp[k + 7] and tmp[k + 8] in the column order 0, 2, 4, 6, 1, 3, 5, 7.
+static INLINE void highbd_filter_src_pixels_avx2(
+    const __m256i src, const __m256i src2, __m128i *tmp, const __m256i *coeff,
+    const __m256i round_const, const __m128i shift, int k) {
+  const __m256i res_0 = _mm256_madd_epi16(src, coeff[0]);
+  const __m256i res_2 =
+      _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 4), coeff[2]);
+  const __m256i res_4 =
+      _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 8), coeff[4]);
+  const __m256i res_6 =
+      _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 12), coeff[6]);
+
+  __m256i res_even = _mm256_add_epi32(_mm256_add_epi32(res_0, res_4),
+                                      _mm256_add_epi32(res_2, res_6));
+  res_even = _mm256_sra_epi32(_mm256_add_epi32(res_even, round_const), shift);
+
+  const __m256i res_1 =
+      _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 2), coeff[1]);
+  const __m256i res_3 =
+      _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 6), coeff[3]);
+  const __m256i res_5 =
+      _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 10), coeff[5]);
+  const __m256i res_7 =
+      _mm256_madd_epi16(_mm256_alignr_epi8(src2, src, 14), coeff[7]);
+
+  __m256i res_odd = _mm256_add_epi32(_mm256_add_epi32(res_1, res_5),
+                                     _mm256_add_epi32(res_3, res_7));
+  res_odd = _mm256_sra_epi32(_mm256_add_epi32(res_odd, round_const), shift);
+
+  const __m256i res = _mm256_packs_epi32(res_even, res_odd);
+  tmp[k + 7] = _mm256_castsi256_si128(res);
+  tmp[k + 8] = _mm256_extracti128_si256(res, 1);
+}
+
+static INLINE __m256i highbd_pack_rows(const __m128i row0, const __m128i row1) {
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(row0), row1, 1);
+}
+
+// Loads pixels ix4 - 7 ... ix4 + 8 of a row that crosses the left or right
+// frame edge, replicating the edge pixels as the C code does.
+static INLINE void highbd_load_padded_row(const uint16_t *ref_row, int ix4,
+                                          int out_of_boundary_left,
+                                          int out_of_boundary_right,
+                                          __m128i *src, __m128i *src2) {
+  const __m128i s = _mm_loadu_si128((__m128i *)(ref_row + ix4 - 7));
+  const __m128i s2 = _mm_loadu_si128((__m128i *)(ref_row + ix4 + 1));
+  const __m128i arrange =
+      _mm_loadu_si128((__m128i *)warp_highbd_arrange_bytes);
+  const __m128i s_01 = _mm_shuffle_epi8(s, arrange);
+  const __m128i s2_01 = _mm_shuffle_epi8(s2, arrange);
+
+  __m128i src_lo = _mm_unpacklo_epi64(s_01, s2_01);
+  __m128i src_hi = _mm_unpackhi_epi64(s_01, s2_01);
+
+  if (out_of_boundary_left >= 0) {
+    const __m128i shuffle_reg_left =
+        _mm_loadu_si128((__m128i *)warp_pad_left[out_of_boundary_left]);
+    src_lo = _mm_shuffle_epi8(src_lo, shuffle_reg_left);
+    src_hi = _mm_shuffle_epi8(src_hi, shuffle_reg_left);
+  }
+
+  if (out_of_boundary_right >= 0) {
+    const __m128i shuffle_reg_right =
+        _mm_loadu_si128((__m128i *)warp_pad_right[out_of_boundary_right]);
+    src_lo = _mm_shuffle_epi8(src_lo, shuffle_reg_right);
+    src_hi = _mm_shuffle_epi8(src_hi, shuffle_reg_right);
+  }
+
+  *src = _mm_unpacklo_epi8(src_lo, src_hi);
+  *src2 = _mm_unpackhi_epi8(src_lo, src_hi);
+}
+
+static INLINE void highbd_warp_horizontal_filter_avx2(
+    const uint16_t *ref, __m128i *tmp, int width, int height, int stride,
+    int32_t ix4, int32_t iy4, int32_t sx4, int alpha, int beta, int p_height,
+    int i, const int offset_bits_horiz, const int reduce_bits_horiz) {
+  const __m256i round_const = _mm256_set1_epi32(
+      (1 << offset_bits_horiz) + ((1 << reduce_bits_horiz) >> 1));
+  const __m128i shift = _mm_cvtsi32_si128(reduce_bits_horiz);
+  const int out_of_boundary_left = -(ix4 - 6);
+  const int out_of_boundary_right = (ix4 + 8) - width;
+  const int needs_padding =
+      out_of_boundary_left >= 0 || out_of_boundary_right >= 0;
+  __m256i coeff[8];
+
+  // Coefficients of the first pair of rows (k = -7, -6). When beta == 0 they
+  // are shared by all rows.
+  highbd_prepare_coeff_avx2(alpha, sx4 - 3 * beta, sx4 - 2 * beta, coeff);
+
+  // The rows are filtered in pairs. When the number of rows is odd, the last
+  // pair filters one extra (clamped) row whose result is never used.
+  for (int k = -7; k < AOMMIN(8, p_height - i); k += 2) {
+    const int iy0 = clamp(iy4 + k, 0, height - 1);
+    const int iy1 = clamp(iy4 + k + 1, 0, height - 1);
+    __m256i src, src2;
+
+    if (needs_padding) {
+      __m128i s0, s0_2, s1, s1_2;
+      highbd_load_padded_row(ref + iy0 * stride, ix4, out_of_boundary_left,
+                             out_of_boundary_right, &s0, &s0_2);
+      highbd_load_padded_row(ref + iy1 * stride, ix4, out_of_boundary_left,
+                             out_of_boundary_right, &s1, &s1_2);
+      src = highbd_pack_rows(s0, s1);
+      src2 = highbd_pack_rows(s0_2, s1_2);
+    } else {
+      src = highbd_pack_rows(
+          _mm_loadu_si128((__m128i *)(ref + iy0 * stride + ix4 - 7)),
+          _mm_loadu_si128((__m128i *)(ref + iy1 * stride + ix4 - 7)));
+      src2 = highbd_pack_rows(
+          _mm_loadu_si128((__m128i *)(ref + iy0 * stride + ix4 + 1)),
+          _mm_loadu_si128((__m128i *)(ref + iy1 * stride + ix4 + 1)));
+    }
+
+    if (beta != 0 && k > -7) {
+      const int sx = sx4 + beta * (k + 4);
+      highbd_prepare_coeff_avx2(alpha, sx, sx + beta, coeff);
+    }
+    highbd_filter_src_pixels_avx2(src, src2, tmp, coeff, round_const, shift,
+                                  k);
+  }
+}
+
+void av1_highbd_warp_affine_avx2(const int32_t *mat, const uint16_t *ref,
+                                 int width, int height, int stride,
+                                 uint16_t *pred, int p_col, int p_row,
+                                 int p_width, int p_height, int p_stride,
+                                 int subsampling_x, int subsampling_y, int bd,
+                                 ConvolveParams *conv_params, int16_t alpha,
+                                 int16_t beta, int16_t gamma, int16_t delta) {
+  // One more row than the SSE4.1 version as rows are filtered in pairs.
+  __m128i tmp[16];
+  int i, j, k;
+  const int reduce_bits_horiz =
+      conv_params->round_0 +
+      AOMMAX(bd + FILTER_BITS - conv_params->round_0 - 14, 0);
+  const int reduce_bits_vert = conv_params->is_compound
+                                   ? conv_params->round_1
+                                   : 2 * FILTER_BITS - reduce_bits_horiz;
+  const int offset_bits_horiz = bd + FILTER_BITS - 1;
+  assert(IMPLIES(conv_params->is_compound, conv_params->dst != NULL));
+  assert(!(bd == 12 && reduce_bits_horiz < 5));
+  assert(IMPLIES(conv_params->do_average, conv_params->is_compound));
+
+  const int offset_bits_vert = bd + 2 * FILTER_BITS - reduce_bits_horiz;
+  const __m256i clip_pixel =
+      _mm256_set1_epi16(bd == 10 ? 1023 : (bd == 12 ? 4095 : 255));
+  const __m128i reduce_bits_vert_shift = _mm_cvtsi32_si128(reduce_bits_vert);
+  const __m256i reduce_bits_vert_const =
+      _mm256_set1_epi32(((1 << reduce_bits_vert) >> 1));
+  const __m256i res_add_const = _mm256_set1_epi32(1 << offset_bits_vert);
+  const int round_bits =
+      2 * FILTER_BITS - conv_params->round_0 - conv_params->round_1;
+  const int offset_bits = bd + 2 * FILTER_BITS - conv_params->round_0;
+  const __m256i res_sub_const =
+      _mm256_set1_epi32(-(1 << (offset_bits - conv_params->round_1)) -
+                        (1 << (offset_bits - conv_params->round_1 - 1)));
+  const __m128i round_bits_shift = _mm_cvtsi32_si128(round_bits);
+  const __m256i round_bits_const = _mm256_set1_epi32(((1 << round_bits) >> 1));
+  const __m256i wt0 = _mm256_set1_epi32(conv_params->fwd_offset);
+  const __m256i wt1 = _mm256_set1_epi32(conv_params->bck_offset);
+  const __m256i round_const =
+      _mm256_set1_epi32(-(1 << (bd + reduce_bits_vert - 1)) +
+                        ((1 << reduce_bits_vert) >> 1));
+  const __m256i max_val = _mm256_set1_epi16((1 << bd) - 1);
+  const __m256i zero = _mm256_setzero_si256();
+
+  for (i = 0; i < p_height; i += 8) {
+    for (j = 0; j < p_width; j += 8) {
+      const int32_t src_x = (p_col + j + 4) << subsampling_x;
+      const int32_t src_y = (p_row + i + 4) << subsampling_y;
+      const int32_t dst_x = mat[2] * src_x + mat[3] * src_y + mat[0];
+      const int32_t dst_y = mat[4] * src_x + mat[5] * src_y + mat[1];
+      const int32_t x4 = dst_x >> subsampling_x;
+      const int32_t y4 = dst_y >> subsampling_y;
+
+      int32_t ix4 = x4 >> WARPEDMODEL_PREC_BITS;
+      int32_t sx4 = x4 & ((1 << WARPEDMODEL_PREC_BITS) - 1);
+      int32_t iy4 = y4 >> WARPEDMODEL_PREC_BITS;
+      int32_t sy4 = y4 & ((1 << WARPEDMODEL_PREC_BITS) - 1);
+
+      // Add in all the constant terms, including rounding and offset
+      sx4 += alpha * (-4) + beta * (-4) + (1 << (WARPEDDIFF_PREC_BITS - 1)) +
+             (WARPEDPIXEL_PREC_SHIFTS << WARPEDDIFF_PREC_BITS);
+      sy4 += gamma * (-4) + delta * (-4) + (1 << (WARPEDDIFF_PREC_BITS - 1)) +
+             (WARPEDPIXEL_PREC_SHIFTS << WARPEDDIFF_PREC_BITS);
+
+      sx4 &= ~((1 << WARP_PARAM_REDUCE_BITS) - 1);
+      sy4 &= ~((1 << WARP_PARAM_REDUCE_BITS) - 1);
+
+      // Horizontal filter
+      // If the block is aligned such that, after clamping, every sample
+      // would be taken from the leftmost/rightmost column, then we can
+      // skip the expensive horizontal filter.
+      if (ix4 <= -7) {
+        for (k = -7; k < AOMMIN(8, p_height - i); ++k) {
+          const int iy = clamp(iy4 + k, 0, height - 1);
+          tmp[k + 7] = _mm_set1_epi16(
+              (1 << (bd + FILTER_BITS - reduce_bits_horiz - 1)) +
+              ref[iy * stride] * (1 << (FILTER_BITS - reduce_bits_horiz)));
+        }
+      } else if (ix4 >= width + 6) {
+        for (k = -7; k < AOMMIN(8, p_height - i); ++k) {
+          const int iy = clamp(iy4 + k, 0, height - 1);
+          tmp[k + 7] =
+              _mm_set1_epi16((1 << (bd + FILTER_BITS - reduce_bits_horiz - 1)) +
+                             ref[iy * stride + (width - 1)] *
+                                 (1 << (FILTER_BITS - reduce_bits_horiz)));
+        }
+      } else {
+        highbd_warp_horizontal_filter_avx2(
+            ref, tmp, width, height, stride, ix4, iy4, sx4, alpha, beta,
+            p_height, i, offset_bits_horiz, reduce_bits_horiz);
+      }
+
+      // Vertical filter, two output rows at a time.
+      for (k = -4; k < AOMMIN(4, p_height - i - 4); k += 2) {
+        const int sy = sy4 + delta * (k + 4);
+        __m256i coeff[8];
+        highbd_prepare_coeff_avx2(gamma, sy, sy + delta, coeff);
+
+        // Rows k + 4 ... k + 11 of tmp feed output row k (low lane) and rows
+        // k + 5 ... k + 12 feed output row k + 1 (high lane).
+        const __m128i *src = tmp + (k + 4);
+        const __m256i r0 = highbd_pack_rows(src[0], src[1]);
+        const __m256i r1 = highbd_pack_rows(src[1], src[2]);
+        const __m256i r2 = highbd_pack_rows(src[2], src[3]);
+        const __m256i r3 = highbd_pack_rows(src[3], src[4]);
+        const __m256i r4 = highbd_pack_rows(src[4], src[5]);
+        const __m256i r5 = highbd_pack_rows(src[5], src[6]);
+        const __m256i r6 = highbd_pack_rows(src[6], src[7]);
+        const __m256i r7 = highbd_pack_rows(src[7], src[8]);
+
+        // Filter even-index pixels
+        const __m256i res_0 =
+            _mm256_madd_epi16(_mm256_unpacklo_epi16(r0, r1), coeff[0]);
+        const __m256i res_2 =
+            _mm256_madd_epi16(_mm256_unpacklo_epi16(r2, r3), coeff[2]);
+        const __m256i res_4 =
+            _mm256_madd_epi16(_mm256_unpacklo_epi16(r4, r5), coeff[4]);
+        const __m256i res_6 =
+            _mm256_madd_epi16(_mm256_unpacklo_epi16(r6, r7), coeff[6]);
+        const __m256i res_even = _mm256_add_epi32(
+            _mm256_add_epi32(res_0, res_2), _mm256_add_epi32(res_4, res_6));
+
+        // Filter odd-index pixels
+        const __m256i res_1 =
+            _mm256_madd_epi16(_mm256_unpackhi_epi16(r0, r1), coeff[1]);
+        const __m256i res_3 =
+            _mm256_madd_epi16(_mm256_unpackhi_epi16(r2, r3), coeff[3]);
+        const __m256i res_5 =
+            _mm256_madd_epi16(_mm256_unpackhi_epi16(r4, r5), coeff[5]);
+        const __m256i res_7 =
+            _mm256_madd_epi16(_mm256_unpackhi_epi16(r6, r7), coeff[7]);
+        const __m256i res_odd = _mm256_add_epi32(
+            _mm256_add_epi32(res_1, res_3), _mm256_add_epi32(res_5, res_7));
+
+        // Rearrange pixels back into the order 0 ... 7
+        __m256i res_lo = _mm256_unpacklo_epi32(res_even, res_odd);
+        __m256i res_hi = _mm256_unpackhi_epi32(res_even, res_odd);
+
+        uint16_t *const pred0 = &pred[(i + k + 4) * p_stride + j];
+        uint16_t *const pred1 = pred0 + p_stride;
+
+        if (conv_params->is_compound) {
+          CONV_BUF_TYPE *const dst0 =
+              &conv_params->dst[(i + k + 4) * conv_params->dst_stride + j];
+          CONV_BUF_TYPE *const dst1 = dst0 + conv_params->dst_stride;
+          for (int half = 0; half < 2 && half * 4 < p_width; ++half) {
+            __m256i res = half ? res_hi : res_lo;
+            res = _mm256_add_epi32(res, res_add_const);
+            res = _mm256_sra_epi32(
+                _mm256_add_epi32(res, reduce_bits_vert_const),
+                reduce_bits_vert_shift);
+            if (conv_params->do_average) {
+              const __m256i p_32 = _mm256_cvtepu16_epi32(_mm_unpacklo_epi64(
+                  _mm_loadl_epi64((__m128i *)(dst0 + half * 4)),
+                  _mm_loadl_epi64((__m128i *)(dst1 + half * 4))));
+
+              if (conv_params->use_dist_wtd_comp_avg) {
+                res = _mm256_add_epi32(_mm256_mullo_epi32(p_32, wt0),
+                                       _mm256_mullo_epi32(res, wt1));
+                res = _mm256_srai_epi32(res, DIST_PRECISION_BITS);
+              } else {
+                res = _mm256_srai_epi32(_mm256_add_epi32(p_32, res), 1);
+              }
+
+              __m256i res32 = _mm256_add_epi32(res, res_sub_const);
+              res32 = _mm256_sra_epi32(
+                  _mm256_add_epi32(res32, round_bits_const), round_bits_shift);
+              __m256i res16 = _mm256_packus_epi32(res32, res32);
+              res16 = _mm256_min_epi16(res16, clip_pixel);
+              _mm_storel_epi64((__m128i *)(pred0 + half * 4),
+                               _mm256_castsi256_si128(res16));
+              _mm_storel_epi64((__m128i *)(pred1 + half * 4),
+                               _mm256_extracti128_si256(res16, 1));
+            } else {
+              const __m256i res16 = _mm256_packus_epi32(res, res);
+              _mm_storel_epi64((__m128i *)(dst0 + half * 4),
+                               _mm256_castsi256_si128(res16));
+              _mm_storel_epi64((__m128i *)(dst1 + half * 4),
+                               _mm256_extracti128_si256(res16, 1));
+            }
+          }
+        } else {
+          // Round and pack into 16 bits
+          const __m256i res_lo_round = _mm256_sra_epi32(
+              _mm256_add_epi32(res_lo, round_const), reduce_bits_vert_shift);
+          const __m256i res_hi_round = _mm256_sra_epi32(
+              _mm256_add_epi32(res_hi, round_const), reduce_bits_vert_shift);
+
+          __m256i res_16bit = _mm256_packs_epi32(res_lo_round, res_hi_round);
+          // Clamp res_16bit to the range [0, 2^bd - 1]
+          res_16bit =
+              _mm256_max_epi16(_mm256_min_epi16(res_16bit, max_val), zero);
+
+          // Note: If we're outputting a 4x4 block, we need to be very careful
+          // to only output 4 pixels at this point, to avoid encode/decode
+          // mismatches when encoding with multiple threads.
+          if (p_width == 4) {
+            _mm_storel_epi64((__m128i *)pred0,
+                             _mm256_castsi256_si128(res_16bit));
+            _mm_storel_epi64((__m128i *)pred1,
+                             _mm256_extracti128_si256(res_16bit, 1));
+          } else {
+            _mm_storeu_si128((__m128i *)pred0,
+                             _mm256_castsi256_si128(res_16bit));
+            _mm_storeu_si128((__m128i *)pred1,
+                             _mm256_extracti128_si256(res_16bit, 1));
+          }
+        }
+      }
+    }
+  }
+}
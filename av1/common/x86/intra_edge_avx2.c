@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+#include <string.h>
+
+#include "config/aom_config.h"
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+
+// The filters are symmetric: { k[0], k[1], k[2], k[1], k[0] }.
+static const int16_t kIntraEdgeKernel[3][3] = { { 0, 4, 8 },
+                                                { 0, 5, 6 },
+                                                { 2, 4, 4 } };
+
+// Size of the copy of the edge: 2 extended samples on the left, at most 129
+// samples and the samples read past the last one by the last 16 outputs.
+#define EDGE_BUF_SIZE (2 + 129 + 17)
+
+// Filters 16 samples, e pointing 2 samples to the left of the first one. The
+// sums fit in unsigned 16 bits for pixels of up to 12 bits.
+static INLINE __m256i filter_edge_16(const __m256i *e, __m256i k0, __m256i k1,
+                                     __m256i k2) {
+  const __m256i eight = _mm256_set1_epi16(8);
+  __m256i sum = _mm256_mullo_epi16(_mm256_add_epi16(e[0], e[4]), k0);
+  sum = _mm256_add_epi16(
+      sum, _mm256_mullo_epi16(_mm256_add_epi16(e[1], e[3]), k1));
+  sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(e[2], k2));
+  return _mm256_srli_epi16(_mm256_add_epi16(sum, eight), 4);
+}
+
+void av1_filter_intra_edge_avx2(uint8_t *p, int sz, int strength) {
+  if (!strength) return;
+  assert(sz <= 129);
+
+  // The filter reads the original samples, so work on an extended copy.
+  DECLARE_ALIGNED(32, uint8_t, edge[EDGE_BUF_SIZE]);
+  edge[0] = edge[1] = p[0];
+  memcpy(edge + 2, p, sz);
+  memset(edge + 2 + sz, p[sz - 1], EDGE_BUF_SIZE - 2 - sz);
+
+  const int16_t *const kernel = kIntraEdgeKernel[strength - 1];
+  const __m256i k0 = _mm256_set1_epi16(kernel[0]);
+  const __m256i k1 = _mm256_set1_epi16(kernel[1]);
+  const __m256i k2 = _mm256_set1_epi16(kernel[2]);
+  // Avoid modifying the first sample.
+  for (int i = 1; i < sz; i += 16) {
+    __m256i e[5];
+    for (int j = 0; j < 5; ++j) {
+      e[j] = _mm256_cvtepu8_epi16(xx_loadu_128(edge + i + j));
+    }
+    const __m256i out = filter_edge_16(e, k0, k1, k2);
+    const __m128i out8 = _mm_packus_epi16(_mm256_castsi256_si128(out),
+                                          _mm256_extracti128_si256(out, 1));
+    if (sz - i >= 16) {
+      xx_storeu_128(p + i, out8);
+    } else {
+      DECLARE_ALIGNED(16, uint8_t, tail[16]);
+      xx_store_128(tail, out8);
+      memcpy(p + i, tail, sz - i);
+    }
+  }
+}
+
+void av1_filter_intra_edge_high_avx2(uint16_t *p, int sz, int strength) {
+  if (!strength) return;
+  assert(sz <= 129);
+
+  DECLARE_ALIGNED(32, uint16_t, edge[EDGE_BUF_SIZE]);
+  edge[0] = edge[1] = p[0];
+  memcpy(edge + 2, p, sz * sizeof(*p));
+  for (int i = 2 + sz; i < EDGE_BUF_SIZE; ++i) edge[i] = p[sz - 1];
+
+  const int16_t *const kernel = kIntraEdgeKernel[strength - 1];
+  const __m256i k0 = _mm256_set1_epi16(kernel[0]);
+  const __m256i k1 = _mm256_set1_epi16(kernel[1]);
+  const __m256i k2 = _mm256_set1_epi16(kernel[2]);
+  for (int i = 1; i < sz; i += 16) {
+    __m256i e[5];
+    for (int j = 0; j < 5; ++j) e[j] = yy_loadu_256(edge + i + j);
+    const __m256i out = filter_edge_16(e, k0, k1, k2);
+    if (sz - i >= 16) {
+      yy_storeu_256(p + i, out);
+    } else {
+      DECLARE_ALIGNED(32, uint16_t, tail[16]);
+      yy_store_256(tail, out);
+      memcpy(p + i, tail, (sz - i) * sizeof(*p));
+    }
+  }
+}
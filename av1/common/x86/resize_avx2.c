@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "config/aom_config.h"
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/aom_filter.h"
+
+static INLINE void prepare_coeffs(const int16_t *filter, __m256i *coeffs) {
+  const __m256i f =
+      _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)filter));
+  coeffs[0] = _mm256_shuffle_epi32(f, 0x00);
+  coeffs[1] = _mm256_shuffle_epi32(f, 0x55);
+  coeffs[2] = _mm256_shuffle_epi32(f, 0xaa);
+  coeffs[3] = _mm256_shuffle_epi32(f, 0xff);
+}
+
+// Filters 16 columns of the 8 rows in s, which hold 16-bit samples, and
+// returns the rounded sums as 16-bit values in column order.
+static INLINE __m256i filter_8tap(const __m256i *s, const __m256i *coeffs) {
+  const __m256i round = _mm256_set1_epi32(1 << (FILTER_BITS - 1));
+  __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(s[0], s[1]), coeffs[0]);
+  __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(s[0], s[1]), coeffs[0]);
+  for (int k = 1; k < SUBPEL_TAPS / 2; ++k) {
+    lo = _mm256_add_epi32(
+        lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(s[2 * k], s[2 * k + 1]),
+                              coeffs[k]));
+    hi = _mm256_add_epi32(
+        hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(s[2 * k], s[2 * k + 1]),
+                              coeffs[k]));
+  }
+  lo = _mm256_srai_epi32(_mm256_add_epi32(lo, round), FILTER_BITS);
+  hi = _mm256_srai_epi32(_mm256_add_epi32(hi, round), FILTER_BITS);
+  // The unpacks and the pack all work within 128-bit lanes, so the result is
+  // back in column order.
+  return _mm256_packs_epi32(lo, hi);
+}
+
+void av1_resize_vert_8tap_avx2(const uint8_t *const *src, uint8_t *dst, int w,
+                               const int16_t *filter) {
+  __m256i coeffs[4];
+  __m256i s[SUBPEL_TAPS];
+  int x = 0;
+
+  prepare_coeffs(filter, coeffs);
+  for (; x + 16 <= w; x += 16) {
+    for (int k = 0; k < SUBPEL_TAPS; ++k) {
+      s[k] = _mm256_cvtepu8_epi16(
+          _mm_loadu_si128((const __m128i *)(src[k] + x)));
+    }
+    const __m256i res = filter_8tap(s, coeffs);
+    _mm_storeu_si128((__m128i *)(dst + x),
+                     _mm_packus_epi16(_mm256_castsi256_si128(res),
+                                      _mm256_extracti128_si256(res, 1)));
+  }
+  if (x < w) {
+    const uint8_t *src_tail[SUBPEL_TAPS];
+    for (int k = 0; k < SUBPEL_TAPS; ++k) src_tail[k] = src[k] + x;
+    av1_resize_vert_8tap_sse2(src_tail, dst + x, w - x, filter);
+  }
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+void av1_highbd_resize_vert_8tap_avx2(const uint16_t *const *src,
+                                      uint16_t *dst, int w,
+                                      const int16_t *filter, int bd) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i max_val = _mm256_set1_epi16((1 << bd) - 1);
+  __m256i coeffs[4];
+  __m256i s[SUBPEL_TAPS];
+  int x = 0;
+
+  prepare_coeffs(filter, coeffs);
+  for (; x + 16 <= w; x += 16) {
+    for (int k = 0; k < SUBPEL_TAPS; ++k)
+      s[k] = _mm256_loadu_si256((const __m256i *)(src[k] + x));
+    const __m256i res = filter_8tap(s, coeffs);
+    _mm256_storeu_si256((__m256i *)(dst + x),
+                        _mm256_min_epi16(_mm256_max_epi16(res, zero), max_val));
+  }
+  if (x < w) {
+    const uint16_t *src_tail[SUBPEL_TAPS];
+    for (int k = 0; k < SUBPEL_TAPS; ++k) src_tail[k] = src[k] + x;
+    av1_highbd_resize_vert_8tap_sse2(src_tail, dst + x, w - x, filter, bd);
+  }
+}
+#endif  // CONFIG_AV1_HIGHBITDEPTH
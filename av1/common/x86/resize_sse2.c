@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <emmintrin.h>
+
+#include "config/aom_config.h"
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/aom_filter.h"
+
+// Splits the 8 filter taps into the pairs (0, 1), (2, 3), (4, 5) and (6, 7),
+// each broadcast over a register, for use with _mm_madd_epi16().
+static INLINE void prepare_coeffs(const int16_t *filter, __m128i *coeffs) {
+  const __m128i f = _mm_loadu_si128((const __m128i *)filter);
+  coeffs[0] = _mm_shuffle_epi32(f, 0x00);
+  coeffs[1] = _mm_shuffle_epi32(f, 0x55);
+  coeffs[2] = _mm_shuffle_epi32(f, 0xaa);
+  coeffs[3] = _mm_shuffle_epi32(f, 0xff);
+}
+
+// Filters 8 columns of the 8 rows in s, which hold 16-bit samples, and
+// returns the rounded sums as 16-bit values.
+static INLINE __m128i filter_8tap(const __m128i *s, const __m128i *coeffs) {
+  const __m128i round = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+  __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(s[0], s[1]), coeffs[0]);
+  __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(s[0], s[1]), coeffs[0]);
+  for (int k = 1; k < SUBPEL_TAPS / 2; ++k) {
+    lo = _mm_add_epi32(
+        lo, _mm_madd_epi16(_mm_unpacklo_epi16(s[2 * k], s[2 * k + 1]),
+                           coeffs[k]));
+    hi = _mm_add_epi32(
+        hi, _mm_madd_epi16(_mm_unpackhi_epi16(s[2 * k], s[2 * k + 1]),
+                           coeffs[k]));
+  }
+  lo = _mm_srai_epi32(_mm_add_epi32(lo, round), FILTER_BITS);
+  hi = _mm_srai_epi32(_mm_add_epi32(hi, round), FILTER_BITS);
+  return _mm_packs_epi32(lo, hi);
+}
+
+void av1_resize_vert_8tap_sse2(const uint8_t *const *src, uint8_t *dst, int w,
+                               const int16_t *filter) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i coeffs[4];
+  __m128i s[SUBPEL_TAPS];
+  int x = 0;
+
+  prepare_coeffs(filter, coeffs);
+  for (; x + 8 <= w; x += 8) {
+    for (int k = 0; k < SUBPEL_TAPS; ++k) {
+      s[k] = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src[k] + x)),
+                               zero);
+    }
+    const __m128i res = filter_8tap(s, coeffs);
+    _mm_storel_epi64((__m128i *)(dst + x), _mm_packus_epi16(res, res));
+  }
+  for (; x < w; ++x) {
+    int sum = 0;
+    for (int k = 0; k < SUBPEL_TAPS; ++k) sum += filter[k] * src[k][x];
+    dst[x] = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
+  }
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+void av1_highbd_resize_vert_8tap_sse2(const uint16_t *const *src,
+                                      uint16_t *dst, int w,
+                                      const int16_t *filter, int bd) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i max_val = _mm_set1_epi16((1 << bd) - 1);
+  __m128i coeffs[4];
+  __m128i s[SUBPEL_TAPS];
+  int x = 0;
+
+  prepare_coeffs(filter, coeffs);
+  for (; x + 8 <= w; x += 8) {
+    for (int k = 0; k < SUBPEL_TAPS; ++k)
+      s[k] = _mm_loadu_si128((const __m128i *)(src[k] + x));
+    const __m128i res = filter_8tap(s, coeffs);
+    _mm_storeu_si128((__m128i *)(dst + x),
+                     _mm_min_epi16(_mm_max_epi16(res, zero), max_val));
+  }
+  for (; x < w; ++x) {
+    int sum = 0;
+    for (int k = 0; k < SUBPEL_TAPS; ++k) sum += filter[k] * src[k][x];
+    dst[x] = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
+  }
+}
+#endif  // CONFIG_AV1_HIGHBITDEPTH
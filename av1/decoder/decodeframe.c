@@ -2215,7 +2215,8 @@ static AOM_INLINE void resize_context_buffers(AV1_COMMON *cm, int width,
   cm->cur_frame->height = cm->height;
 }
 
-static AOM_INLINE void setup_buffer_pool(AV1_COMMON *cm) {
+static AOM_INLINE void setup_buffer_pool(AV1Decoder *pbi) {
+  AV1_COMMON *const cm = &pbi->common;
   BufferPool *const pool = cm->buffer_pool;
   const SequenceHeader *const seq_params = &cm->seq_params;
 
@@ -2223,7 +2224,7 @@ static AOM_INLINE void setup_buffer_pool(AV1_COMMON *cm) {
   if (aom_realloc_frame_buffer(
           &cm->cur_frame->buf, cm->width, cm->height, seq_params->subsampling_x,
           seq_params->subsampling_y, seq_params->use_highbitdepth,
-          AOM_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
+          av1_dec_border_in_pixels(pbi), cm->byte_alignment,
           &cm->cur_frame->raw_frame_buffer, pool->get_fb_cb, pool->cb_priv)) {
     unlock_buffer_pool(pool);
     aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
@@ -2244,9 +2245,10 @@ static AOM_INLINE void setup_buffer_pool(AV1_COMMON *cm) {
   cm->cur_frame->buf.render_height = cm->render_height;
 }
 
-static AOM_INLINE void setup_frame_size(AV1_COMMON *cm,
+static AOM_INLINE void setup_frame_size(AV1Decoder *pbi,
                                         int frame_size_override_flag,
                                         struct aom_read_bit_buffer *rb) {
+  AV1_COMMON *const cm = &pbi->common;
   const SequenceHeader *const seq_params = &cm->seq_params;
   int width, height;
 
@@ -2267,7 +2269,7 @@ static AOM_INLINE void setup_frame_size(AV1_COMMON *cm,
   setup_superres(cm, rb, &width, &height);
   resize_context_buffers(cm, width, height);
   setup_render_size(cm, rb);
-  setup_buffer_pool(cm);
+  setup_buffer_pool(pbi);
 }
 
 static AOM_INLINE void setup_sb_size(SequenceHeader *seq_params,
@@ -2284,7 +2286,8 @@ static INLINE int valid_ref_frame_img_fmt(aom_bit_depth_t ref_bit_depth,
 }
 
 static AOM_INLINE void setup_frame_size_with_refs(
-    AV1_COMMON *cm, struct aom_read_bit_buffer *rb) {
+    AV1Decoder *pbi, struct aom_read_bit_buffer *rb) {
+  AV1_COMMON *const cm = &pbi->common;
   int width, height;
   int found = 0;
   int has_valid_ref_frame = 0;
@@ -2348,7 +2351,7 @@ static AOM_INLINE void setup_frame_size_with_refs(
       aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
                          "Referenced frame has incompatible color format");
   }
-  setup_buffer_pool(cm);
+  setup_buffer_pool(pbi);
 }
 
 // Same function as av1_read_uniform but reading from uncompresses header wb
@@ -3227,6 +3230,76 @@ static INLINE int get_max_row_mt_workers_per_tile(AV1_COMMON *cm,
   return max_workers;
 }
 
+// Returns 1 if every superblock row above mi_row_end has been reconstructed
+// in all the tiles being decoded.
+static int dec_rows_reconstructed(AV1Decoder *const pbi, int mi_row_end) {
+  AV1_COMMON *cm = &pbi->common;
+  AV1DecRowMTInfo *frame_row_mt_info = &pbi->frame_row_mt_info;
+
+  for (int tile_row = frame_row_mt_info->tile_rows_start;
+       tile_row < frame_row_mt_info->tile_rows_end; ++tile_row) {
+    for (int tile_col = frame_row_mt_info->tile_cols_start;
+         tile_col < frame_row_mt_info->tile_cols_end; ++tile_col) {
+      const TileDataDec *const tile_data =
+          pbi->tile_data + tile_row * cm->tile_cols + tile_col;
+      const TileInfo *const tile_info = &tile_data->tile_info;
+      if (tile_info->mi_row_start >= mi_row_end) break;
+      const int mi_rows_needed =
+          AOMMIN(mi_row_end, tile_info->mi_row_end) - tile_info->mi_row_start;
+      if (tile_data->dec_row_mt_sync.mi_rows_decode_done < mi_rows_needed)
+        return 0;
+    }
+  }
+  return 1;
+}
+
+// The caller must hold pbi->row_mt_mutex_ when calling this function.
+// Returns 1 if a deblocking job is stored in *next_job_info.
+// The return value of this function depends on the following variables:
+// - tile_data->dec_row_mt_sync.mi_rows_decode_done
+// - frame_row_mt_info->lf_vert_jobs_started
+// - frame_row_mt_info->lf_horz_jobs_started
+static int get_next_lf_job_info(AV1Decoder *const pbi,
+                                AV1DecRowMTJobInfo *next_job_info) {
+  AV1_COMMON *cm = &pbi->common;
+  AV1DecRowMTInfo *frame_row_mt_info = &pbi->frame_row_mt_info;
+  const int num_planes = frame_row_mt_info->lf_num_planes;
+  const int lf_sb_rows = frame_row_mt_info->lf_sb_rows;
+  const int num_jobs = lf_sb_rows * num_planes;
+
+  if (!frame_row_mt_info->lf_pipelined) return 0;
+
+  if (frame_row_mt_info->lf_vert_jobs_started < num_jobs) {
+    const int job = frame_row_mt_info->lf_vert_jobs_started;
+    const int r = job / num_planes;
+    const int mi_row_end = AOMMIN((r + 2) << MAX_MIB_SIZE_LOG2, cm->mi_rows);
+    if (dec_rows_reconstructed(pbi, mi_row_end)) {
+      next_job_info->lf_job = 1;
+      next_job_info->mi_row = r << MAX_MIB_SIZE_LOG2;
+      next_job_info->plane = frame_row_mt_info->lf_planes[job % num_planes];
+      next_job_info->dir = 0;
+      frame_row_mt_info->lf_vert_jobs_started++;
+      return 1;
+    }
+  }
+
+  if (frame_row_mt_info->lf_horz_jobs_started < num_jobs) {
+    const int job = frame_row_mt_info->lf_horz_jobs_started;
+    const int r = job / num_planes;
+    const int vert_jobs_needed = AOMMIN(r + 2, lf_sb_rows) * num_planes;
+    if (frame_row_mt_info->lf_vert_jobs_started >= vert_jobs_needed) {
+      next_job_info->lf_job = 1;
+      next_job_info->mi_row = r << MAX_MIB_SIZE_LOG2;
+      next_job_info->plane = frame_row_mt_info->lf_planes[job % num_planes];
+      next_job_info->dir = 1;
+      frame_row_mt_info->lf_horz_jobs_started++;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
 // The caller must hold pbi->row_mt_mutex_ when calling this function.
 // Returns 1 if either the next job is stored in *next_job_info or 1 is stored
 // in *end_of_frame.
@@ -3235,6 +3308,8 @@ static INLINE int get_max_row_mt_workers_per_tile(AV1_COMMON *cm,
 // - frame_row_mt_info->mi_rows_parse_done
 // - frame_row_mt_info->mi_rows_decode_started
 // - frame_row_mt_info->row_mt_exit
+// and, if the deblocking is pipelined, on the variables listed for
+// get_next_lf_job_info().
 // Therefore we may need to signal or broadcast pbi->row_mt_cond_ if any of
 // these variables is modified.
 static int get_next_job_info(AV1Decoder *const pbi,
@@ -3266,6 +3341,14 @@ static int get_next_job_info(AV1Decoder *const pbi,
   *end_of_frame = (frame_row_mt_info->mi_rows_decode_started ==
                    frame_row_mt_info->mi_rows_to_decode) ||
                   (frame_row_mt_info->row_mt_exit == 1);
+  if (*end_of_frame && frame_row_mt_info->lf_pipelined &&
+      frame_row_mt_info->row_mt_exit == 0) {
+    // All the decode jobs have been started. The remaining work is deblocking.
+    *end_of_frame = frame_row_mt_info->lf_horz_jobs_started ==
+                    frame_row_mt_info->lf_sb_rows *
+                        frame_row_mt_info->lf_num_planes;
+    if (!*end_of_frame) return get_next_lf_job_info(pbi, next_job_info);
+  }
   if (*end_of_frame) {
     return 1;
   }
@@ -3275,7 +3358,7 @@ static int get_next_job_info(AV1Decoder *const pbi,
          frame_row_mt_info->mi_rows_decode_started);
   if (frame_row_mt_info->mi_rows_parse_done ==
       frame_row_mt_info->mi_rows_decode_started)
-    return 0;
+    return get_next_lf_job_info(pbi, next_job_info);
 
   // Choose the tile to decode.
   for (tile_row_idx = tile_rows_start; tile_row_idx < tile_rows_end;
@@ -3317,7 +3400,8 @@ static int get_next_job_info(AV1Decoder *const pbi,
     }
   }
   // No job found to process
-  if (tile_row == -1 || tile_col == -1) return 0;
+  if (tile_row == -1 || tile_col == -1)
+    return get_next_lf_job_info(pbi, next_job_info);
 
   tile_data = pbi->tile_data + tile_row * cm->tile_cols + tile_col;
   tile_info = tile_data->tile_info;
@@ -3500,6 +3584,22 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
 
     if (end_of_frame) break;
 
+    if (next_job_info.lf_job) {
+      av1_thread_loop_filter_sb_row(&cm->cur_frame->buf, cm, td->xd.plane,
+                                    &td->xd, &pbi->lf_row_sync,
+                                    next_job_info.mi_row, next_job_info.plane,
+                                    next_job_info.dir);
+#if CONFIG_MULTITHREAD
+      // Starting a vertical edge job may have made horizontal edge jobs
+      // available, and the last job makes the other workers see the end of
+      // the frame.
+      pthread_mutex_lock(pbi->row_mt_mutex_);
+      pthread_cond_broadcast(pbi->row_mt_cond_);
+      pthread_mutex_unlock(pbi->row_mt_mutex_);
+#endif
+      continue;
+    }
+
     int tile_row = next_job_info.tile_row;
     int tile_col = next_job_info.tile_col;
     int mi_row = next_job_info.mi_row;
@@ -3519,7 +3619,14 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
     pthread_mutex_lock(pbi->row_mt_mutex_);
 #endif
     dec_row_mt_sync->num_threads_working--;
+    // Superblock rows of a tile finish in order (see sync_read()), so the
+    // first mi_rows_decode_done rows of the tile are reconstructed.
+    dec_row_mt_sync->mi_rows_decode_done +=
+        mi_size_wide[cm->seq_params.sb_size];
 #if CONFIG_MULTITHREAD
+    // Deblocking jobs may be waiting for this row.
+    if (frame_row_mt_info->lf_pipelined)
+      pthread_cond_broadcast(pbi->row_mt_cond_);
     pthread_mutex_unlock(pbi->row_mt_mutex_);
 #endif
   }
@@ -3863,7 +3970,8 @@ static AOM_INLINE void dec_alloc_cb_buf(AV1Decoder *pbi) {
 static AOM_INLINE void row_mt_frame_init(AV1Decoder *pbi, int tile_rows_start,
                                          int tile_rows_end, int tile_cols_start,
                                          int tile_cols_end, int start_tile,
-                                         int end_tile, int max_sb_rows) {
+                                         int end_tile, int max_sb_rows,
+                                         int pipeline_lf) {
   AV1_COMMON *const cm = &pbi->common;
   AV1DecRowMTInfo *frame_row_mt_info = &pbi->frame_row_mt_info;
 
@@ -3878,6 +3986,26 @@ static AOM_INLINE void row_mt_frame_init(AV1Decoder *pbi, int tile_rows_start,
   frame_row_mt_info->mi_rows_decode_started = 0;
   frame_row_mt_info->row_mt_exit = 0;
 
+  frame_row_mt_info->lf_pipelined = pipeline_lf;
+  frame_row_mt_info->lf_num_planes = 0;
+  frame_row_mt_info->lf_sb_rows =
+      ALIGN_POWER_OF_TWO(cm->mi_rows, MAX_MIB_SIZE_LOG2) >> MAX_MIB_SIZE_LOG2;
+  frame_row_mt_info->lf_vert_jobs_started = 0;
+  frame_row_mt_info->lf_horz_jobs_started = 0;
+  if (pipeline_lf) {
+    const int num_planes = av1_num_planes(cm);
+    // Same plane selection as enqueue_lf_jobs().
+    for (int plane = 0; plane < num_planes; ++plane) {
+      if (plane == 0 && !(cm->lf.filter_level[0]) && !(cm->lf.filter_level[1]))
+        break;
+      else if (plane == 1 && !(cm->lf.filter_level_u))
+        continue;
+      else if (plane == 2 && !(cm->lf.filter_level_v))
+        continue;
+      frame_row_mt_info->lf_planes[frame_row_mt_info->lf_num_planes++] = plane;
+    }
+  }
+
   for (int tile_row = tile_rows_start; tile_row < tile_rows_end; ++tile_row) {
     for (int tile_col = tile_cols_start; tile_col < tile_cols_end; ++tile_col) {
       if (tile_row * cm->tile_cols + tile_col < start_tile ||
@@ -3890,6 +4018,7 @@ static AOM_INLINE void row_mt_frame_init(AV1Decoder *pbi, int tile_rows_start,
 
       tile_data->dec_row_mt_sync.mi_rows_parse_done = 0;
       tile_data->dec_row_mt_sync.mi_rows_decode_started = 0;
+      tile_data->dec_row_mt_sync.mi_rows_decode_done = 0;
       tile_data->dec_row_mt_sync.num_threads_working = 0;
       tile_data->dec_row_mt_sync.mi_rows =
           ALIGN_POWER_OF_TWO(tile_info.mi_row_end - tile_info.mi_row_start,
@@ -3928,7 +4057,8 @@ static AOM_INLINE void row_mt_frame_init(AV1Decoder *pbi, int tile_rows_start,
 
 static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
                                           const uint8_t *data_end,
-                                          int start_tile, int end_tile) {
+                                          int start_tile, int end_tile,
+                                          int pipeline_lf) {
   AV1_COMMON *const cm = &pbi->common;
   const int tile_cols = cm->tile_cols;
   const int tile_rows = cm->tile_rows;
@@ -4009,6 +4139,8 @@ static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
     }
   }
   num_workers = AOMMIN(num_workers, max_threads);
+  // Workers beyond the per-tile limit pick up the deblocking jobs.
+  if (pipeline_lf) num_workers = max_threads;
 
   if (pbi->allocated_row_mt_sync_rows != max_sb_rows) {
     for (int i = 0; i < n_tiles; ++i) {
@@ -4025,7 +4157,13 @@ static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
   dec_alloc_cb_buf(pbi);
 
   row_mt_frame_init(pbi, tile_rows_start, tile_rows_end, tile_cols_start,
-                    tile_cols_end, start_tile, end_tile, max_sb_rows);
+                    tile_cols_end, start_tile, end_tile, max_sb_rows,
+                    pipeline_lf);
+
+  if (pipeline_lf) {
+    av1_loop_filter_frame_mt_init(cm, 0, av1_num_planes(cm), num_workers,
+                                  &pbi->lf_row_sync);
+  }
 
   reset_dec_workers(pbi, row_mt_worker_hook, num_workers);
   launch_dec_workers(pbi, data_end, num_workers);
@@ -4969,8 +5107,10 @@ static int read_uncompressed_header(AV1Decoder *pbi,
                   &buf->buf, seq_params->max_frame_width,
                   seq_params->max_frame_height, seq_params->subsampling_x,
                   seq_params->subsampling_y, seq_params->use_highbitdepth,
-                  AOM_BORDER_IN_PIXELS, cm->byte_alignment,
-                  &buf->raw_frame_buffer, pool->get_fb_cb, pool->cb_priv)) {
+                  pbi->low_memory ? av1_dec_border_in_pixels(pbi)
+                                  : AOM_BORDER_IN_PIXELS,
+                  cm->byte_alignment, &buf->raw_frame_buffer, pool->get_fb_cb,
+                  pool->cb_priv)) {
             decrease_ref_count(buf, pool);
             unlock_buffer_pool(pool);
             aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
@@ -4987,7 +5127,7 @@ static int read_uncompressed_header(AV1Decoder *pbi,
   }
 
   if (current_frame->frame_type == KEY_FRAME) {
-    setup_frame_size(cm, frame_size_override_flag, rb);
+    setup_frame_size(pbi, frame_size_override_flag, rb);
 
     if (cm->allow_screen_content_tools && !av1_superres_scaled(cm))
       cm->allow_intrabc = aom_rb_read_bit(rb);
@@ -4999,7 +5139,7 @@ static int read_uncompressed_header(AV1Decoder *pbi,
     if (current_frame->frame_type == INTRA_ONLY_FRAME) {
       cm->cur_frame->film_grain_params_present =
           seq_params->film_grain_params_present;
-      setup_frame_size(cm, frame_size_override_flag, rb);
+      setup_frame_size(pbi, frame_size_override_flag, rb);
       if (cm->allow_screen_content_tools && !av1_superres_scaled(cm))
         cm->allow_intrabc = aom_rb_read_bit(rb);
 
@@ -5076,9 +5216,9 @@ static int read_uncompressed_header(AV1Decoder *pbi,
       }
 
       if (!cm->error_resilient_mode && frame_size_override_flag) {
-        setup_frame_size_with_refs(cm, rb);
+        setup_frame_size_with_refs(pbi, rb);
       } else {
-        setup_frame_size(cm, frame_size_override_flag, rb);
+        setup_frame_size(pbi, frame_size_override_flag, rb);
       }
 
       if (cm->cur_frame_force_integer_mv) {
@@ -5422,12 +5562,32 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
 #if CONFIG_LPF_MASK
   av1_loop_filter_frame_init(cm, 0, num_planes);
 #endif
+  const int use_row_mt = pbi->max_threads > 1 &&
+                         !(cm->large_scale_tile && !pbi->ext_tile_debug) &&
+                         pbi->row_mt;
+  // When the whole frame is decoded by the row-MT workers in one go, they
+  // also run the deblocking filter, overlapped with the reconstruction.
+#if CONFIG_LPF_MASK
+  const int pipeline_lf = 0;
+#else
+  const int pipeline_lf =
+      use_row_mt && start_tile == 0 &&
+      end_tile == cm->tile_rows * cm->tile_cols - 1 && !cm->allow_intrabc &&
+      !cm->single_tile_decoding && !cm->large_scale_tile &&
+      (cm->lf.filter_level[0] || cm->lf.filter_level[1]);
+#endif
 
-  if (pbi->max_threads > 1 && !(cm->large_scale_tile && !pbi->ext_tile_debug) &&
-      pbi->row_mt)
-    *p_data_end =
-        decode_tiles_row_mt(pbi, data, data_end, start_tile, end_tile);
-  else if (pbi->max_threads > 1 && tile_count_tg > 1 &&
+  if (use_row_mt) {
+    *p_data_end = decode_tiles_row_mt(pbi, data, data_end, start_tile,
+                                      end_tile, pipeline_lf);
+    // The block buffers hold the parsed data of the whole frame and are by
+    // far the largest row-MT allocation. Do not keep them across frames in
+    // low-memory mode.
+    if (pbi->low_memory) {
+      av1_update_peak_mem_usage(pbi);
+      av1_dec_free_cb_buf(pbi);
+    }
+  } else if (pbi->max_threads > 1 && tile_count_tg > 1 &&
            !(cm->large_scale_tile && !pbi->ext_tile_debug))
     *p_data_end = decode_tiles_mt(pbi, data, data_end, start_tile, end_tile);
   else
@@ -5443,7 +5603,7 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
   }
 
   if (!cm->allow_intrabc && !cm->single_tile_decoding) {
-    if (cm->lf.filter_level[0] || cm->lf.filter_level[1]) {
+    if (!pipeline_lf && (cm->lf.filter_level[0] || cm->lf.filter_level[1])) {
       if (pbi->num_workers > 1) {
         av1_loop_filter_frame_mt(
             &cm->cur_frame->buf, cm, &pbi->mb, 0, num_planes, 0,
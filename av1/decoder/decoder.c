@@ -195,6 +195,44 @@ void av1_dec_free_cb_buf(AV1Decoder *pbi) {
   pbi->cb_buffer_alloc_size = 0;
 }
 
+uint64_t av1_get_mem_usage(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  const BufferPool *const pool = cm->buffer_pool;
+  uint64_t size = 0;
+
+  if (pool != NULL) {
+    const int use_internal_fb = pool->cb_priv == &pool->int_frame_buffers;
+    if (use_internal_fb)
+      size += av1_internal_frame_buffers_size(&pool->int_frame_buffers);
+    for (int i = 0; i < FRAME_BUFFERS; ++i) {
+      const RefCntBuffer *const buf = &pool->frame_bufs[i];
+      // External frame buffers are only counted while the decoder uses them.
+      if (!use_internal_fb && buf->raw_frame_buffer.data != NULL)
+        size += buf->raw_frame_buffer.size;
+      if (buf->mvs != NULL) {
+        size += (uint64_t)((buf->mi_rows + 1) >> 1) *
+                ((buf->mi_cols + 1) >> 1) * sizeof(*buf->mvs);
+        size += (uint64_t)buf->mi_rows * buf->mi_cols * sizeof(*buf->seg_map);
+      }
+    }
+  }
+
+  size += (uint64_t)cm->mi_alloc_size * sizeof(*cm->mi);
+  size += (uint64_t)cm->mi_grid_size *
+          (sizeof(*cm->mi_grid_base) + sizeof(*cm->tx_type_map));
+  size += (uint64_t)cm->tpl_mvs_mem_size * sizeof(*cm->tpl_mvs);
+  size += (uint64_t)pbi->cb_buffer_alloc_size * sizeof(*pbi->cb_buffer_base);
+  size += (uint64_t)pbi->allocated_tiles * sizeof(*pbi->tile_data);
+  if (pbi->thread_data != NULL)
+    size += (uint64_t)(pbi->max_threads - 1) * sizeof(ThreadData);
+  return size;
+}
+
+void av1_update_peak_mem_usage(AV1Decoder *pbi) {
+  const uint64_t size = av1_get_mem_usage(pbi);
+  if (size > pbi->peak_mem_usage) pbi->peak_mem_usage = size;
+}
+
 void av1_decoder_remove(AV1Decoder *pbi) {
   int i;
 
@@ -513,6 +551,7 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
 
   // Note: At this point, this function holds a reference to cm->cur_frame
   // in the buffer pool. This reference is consumed by update_frame_buffers().
+  av1_update_peak_mem_usage(pbi);
   update_frame_buffers(pbi, frame_decoded);
 
   if (frame_decoded) {
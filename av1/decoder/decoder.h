@@ -71,6 +71,11 @@ typedef struct AV1DecRowMTJobInfo {
   int tile_row;
   int tile_col;
   int mi_row;
+  // Boolean: the job deblocks superblock row mi_row of the whole frame rather
+  // than reconstructing a superblock row of tile (tile_row, tile_col).
+  int lf_job;
+  int plane;
+  int dir;
 } AV1DecRowMTJobInfo;
 
 typedef struct AV1DecRowMTSyncData {
@@ -85,6 +90,7 @@ typedef struct AV1DecRowMTSyncData {
   int mi_cols;
   int mi_rows_parse_done;
   int mi_rows_decode_started;
+  int mi_rows_decode_done;
   int num_threads_working;
 } AV1DecRowMTSync;
 
@@ -116,6 +122,21 @@ typedef struct AV1DecRowMTInfo {
   // Boolean: Initialized to 0 (false). Set to 1 (true) on error to abort
   // decoding.
   int row_mt_exit;
+
+  // Boolean: the deblocking filter runs on the row-MT workers, pipelined with
+  // the reconstruction of the frame. A vertical edge job of a loop filter row
+  // is started once the rows it covers and the row below have been
+  // reconstructed (intra prediction of the row below reads unfiltered
+  // pixels). A horizontal edge job is started once the vertical edge jobs of
+  // its row and the row below have been started.
+  int lf_pipelined;
+  int lf_planes[MAX_MB_PLANE];
+  int lf_num_planes;
+  int lf_sb_rows;
+  // Number of vertical and horizontal edge jobs started so far. Jobs are
+  // started in raster order of (superblock row, plane).
+  int lf_vert_jobs_started;
+  int lf_horz_jobs_started;
 } AV1DecRowMTInfo;
 
 typedef struct TileDataDec {
@@ -230,6 +251,10 @@ typedef struct AV1Decoder {
   uint32_t coded_tile_data_size;
   unsigned int ext_tile_debug;  // for ext-tile software debug & testing
   unsigned int row_mt;
+  // Decode with the smallest possible footprint, see AV1D_SET_LOW_MEMORY.
+  unsigned int low_memory;
+  // Largest value returned by av1_get_mem_usage() so far.
+  uint64_t peak_mem_usage;
   EXTERNAL_REFERENCES ext_refs;
   YV12_BUFFER_CONFIG tile_list_outbuf;
 
@@ -276,6 +301,24 @@ void av1_dec_row_mt_dealloc(AV1DecRowMTSync *dec_row_mt_sync);
 
 void av1_dec_free_cb_buf(AV1Decoder *pbi);
 
+// Returns the number of bytes held by the frame buffer pool and by the
+// per-frame working buffers of the decoder.
+uint64_t av1_get_mem_usage(const AV1Decoder *pbi);
+
+// Records the current memory usage in pbi->peak_mem_usage if it is the
+// largest seen so far.
+void av1_update_peak_mem_usage(AV1Decoder *pbi);
+
+// Returns the border, in luma pixels, of the frame buffers the decoder
+// allocates. Motion compensation emulates the frame edges itself (see
+// extend_mc_border()), but blocks at the right and bottom edges may extend
+// past the frame by up to half a superblock and are predicted and
+// reconstructed in place, which bounds the low-memory border from below.
+static INLINE int av1_dec_border_in_pixels(const AV1Decoder *pbi) {
+  if (!pbi->low_memory) return AOM_DEC_BORDER_IN_PIXELS;
+  return block_size_wide[pbi->common.seq_params.sb_size] >> 1;
+}
+
 static INLINE void decrease_ref_count(RefCntBuffer *const buf,
                                       BufferPool *const pool) {
   if (buf != NULL) {
@@ -141,6 +141,25 @@ typedef struct {
   CRC32C crc_calculator;  // Hash function.
 } MB_RD_RECORD;
 
+// Entry of the frame-persistent cache of the MB_RD_INFO results, which are
+// only valid for the same quantizer and transform search parameters (ctx) and
+// the same rdmult.
+typedef struct {
+  MB_RD_INFO rd_info;
+  int rdmult;
+  uint32_t ctx;
+  // Raster position of the block which saved the entry, so that the merge of
+  // the tables of the threads does not depend on the order of the blocks.
+  int pos;
+  int valid;
+} TX_RD_CACHE_ENTRY;
+
+// Direct-mapped table of TX_RD_CACHE_ENTRY, indexed by the residue hash.
+typedef struct {
+  TX_RD_CACHE_ENTRY *entries;
+  int size_log2;
+} TX_RD_CACHE;
+
 typedef struct {
   int64_t dist;
   int64_t sse;
@@ -207,6 +226,7 @@ typedef struct {
 } CompoundTypeRdBuffers;
 
 struct inter_modes_info;
+struct pc_tree_arena;
 typedef struct macroblock MACROBLOCK;
 struct macroblock {
   struct macroblock_plane plane[MAX_MB_PLANE];
@@ -221,6 +241,9 @@ struct macroblock {
 
   // Inter macroblock RD search info.
   MB_RD_RECORD mb_rd_record;
+  // Results of the current frame, to be merged into the frame-persistent
+  // cache once the frame is encoded. NULL when the cache is disabled.
+  TX_RD_CACHE *tx_rd_cache;
 
   // Inter transform block RD search info. for square TX sizes.
   TXB_RD_RECORD txb_rd_record_8X8[(MAX_MIB_SIZE >> 1) * (MAX_MIB_SIZE >> 1)];
@@ -258,6 +281,8 @@ struct macroblock {
   unsigned int txb_split_count;
 #if CONFIG_SPEED_STATS
   unsigned int tx_search_count;
+  unsigned int tx_rd_cache_lookups;
+  unsigned int tx_rd_cache_hits;
 #endif  // CONFIG_SPEED_STATS
 
   // These are set to their default values at the beginning, and then adjusted
@@ -299,6 +324,8 @@ struct macroblock {
   FRAME_CONTEXT *tile_pb_ctx;
 
   struct inter_modes_info *inter_modes_info;
+  // Buffers of the PICK_MODE_CONTEXTs of the thread.
+  struct pc_tree_arena *pc_tree_arena;
 
   // buffer for hash value calculation of a block
   // used only in av1_get_block_hash_value()
@@ -456,6 +483,10 @@ struct macroblock {
   int valid_cost_b;
   int64_t inter_cost_b[MAX_MC_FLOW_BLK_IN_SB * MAX_MC_FLOW_BLK_IN_SB];
   int64_t intra_cost_b[MAX_MC_FLOW_BLK_IN_SB * MAX_MC_FLOW_BLK_IN_SB];
+  // The TPL motion vectors of each reference frame, indexed by the position of
+  // the block in the superblock.
+  int_mv tpl_mvs_b[MAX_MC_FLOW_BLK_IN_SB * MAX_MC_FLOW_BLK_IN_SB]
+                  [INTER_REFS_PER_FRAME];
   int cost_stride;
 };
 
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include "aom_mem/aom_mem.h"
+
+#include "av1/common/mvref_common.h"
+#include "av1/encoder/block_hints.h"
+#include "av1/encoder/encoder.h"
+
+static void free_hints_frame(BlockHintsFrame *frame) {
+  if (frame == NULL) return;
+  aom_free(frame->map.hints);
+  aom_free(frame->analysis.mvs);
+  aom_free(frame->analysis.depths);
+  aom_free(frame);
+}
+
+static int has_analysis(const BlockHintsFrame *frame) {
+  return frame->analysis.mvs != NULL || frame->analysis.depths != NULL;
+}
+
+static BlockHintsFrame *get_pending_frame(BLOCK_HINTS *bh) {
+  if (bh->pending == NULL) bh->pending = aom_calloc(1, sizeof(*bh->pending));
+  return bh->pending;
+}
+
+static void *copy_array(const void *src, size_t size) {
+  void *const dst = aom_malloc(size);
+  if (dst != NULL) memcpy(dst, src, size);
+  return dst;
+}
+
+int av1_set_block_hints(AV1_COMP *cpi, const aom_block_hint_map_t *map) {
+  BLOCK_HINTS *const bh = &cpi->block_hints;
+  if (map->hints == NULL) {
+    if (bh->pending != NULL) {
+      aom_free(bh->pending->map.hints);
+      bh->pending->map.hints = NULL;
+    }
+    return 0;
+  }
+
+  if (map->width == 0 || map->height == 0 ||
+      map->cols != (map->width + 3) >> 2 || map->rows != (map->height + 3) >> 2)
+    return -1;
+
+  BlockHintsFrame *const frame = get_pending_frame(bh);
+  if (frame == NULL) return -1;
+  aom_block_hint_t *const hints = copy_array(
+      map->hints, (size_t)map->rows * map->cols * sizeof(*map->hints));
+  if (hints == NULL) return -1;
+  aom_free(frame->map.hints);
+  frame->map = *map;
+  frame->map.hints = hints;
+  return 0;
+}
+
+int av1_set_analysis_hints(AV1_COMP *cpi, const aom_analysis_hints_t *hints) {
+  const unsigned int width = cpi->oxcf.width;
+  const unsigned int height = cpi->oxcf.height;
+  const size_t num_mvs = (size_t)hints->mv_rows * hints->mv_cols;
+  const size_t num_depths = (size_t)hints->depth_rows * hints->depth_cols;
+
+  if (hints->mvs != NULL && (hints->mv_cols != (width + 15) >> 4 ||
+                             hints->mv_rows != (height + 15) >> 4))
+    return -1;
+  if (hints->depths != NULL) {
+    if (hints->depth_cols != (width + 63) >> 6 ||
+        hints->depth_rows != (height + 63) >> 6)
+      return -1;
+    for (size_t i = 0; i < num_depths; ++i) {
+      if (hints->depths[i] > 3 && hints->depths[i] != AOM_ANALYSIS_NO_DEPTH)
+        return -1;
+    }
+  }
+
+  BlockHintsFrame *const frame = get_pending_frame(&cpi->block_hints);
+  if (frame == NULL) return -1;
+  aom_analysis_mv_t *mvs = NULL;
+  uint8_t *depths = NULL;
+  if (hints->mvs != NULL) {
+    mvs = copy_array(hints->mvs, num_mvs * sizeof(*hints->mvs));
+    if (mvs == NULL) return -1;
+  }
+  if (hints->depths != NULL) {
+    depths = copy_array(hints->depths, num_depths * sizeof(*hints->depths));
+    if (depths == NULL) {
+      aom_free(mvs);
+      return -1;
+    }
+  }
+  aom_free(frame->analysis.mvs);
+  aom_free(frame->analysis.depths);
+  frame->analysis = *hints;
+  frame->analysis.mvs = mvs;
+  frame->analysis.depths = depths;
+  frame->analysis_width = width;
+  frame->analysis_height = height;
+  return 0;
+}
+
+int av1_block_hints_scene_cut(const AV1_COMP *cpi) {
+  const BlockHintsFrame *const frame = cpi->block_hints.pending;
+  return frame != NULL && frame->analysis.scene_cut;
+}
+
+void av1_block_hints_receive_frame(AV1_COMP *cpi, int64_t ts) {
+  BLOCK_HINTS *const bh = &cpi->block_hints;
+  if (bh->pending == NULL) return;
+  if (bh->pending->map.hints == NULL && !has_analysis(bh->pending)) {
+    free_hints_frame(bh->pending);
+    bh->pending = NULL;
+    return;
+  }
+
+  BlockHintsFrame **tail = &bh->frames;
+  while (*tail != NULL) tail = &(*tail)->next;
+  bh->pending->ts = ts;
+  *tail = bh->pending;
+  bh->pending = NULL;
+}
+
+void av1_block_hints_setup_frame(AV1_COMP *cpi, int64_t ts, int show_frame) {
+  BLOCK_HINTS *const bh = &cpi->block_hints;
+  bh->cur = NULL;
+  bh->cur_analysis = NULL;
+
+  // The frames are received in display order, the earlier ones were all
+  // coded by the time a frame is shown.
+  while (show_frame && bh->frames != NULL && bh->frames->ts < ts) {
+    BlockHintsFrame *const frame = bh->frames;
+    bh->frames = frame->next;
+    free_hints_frame(frame);
+  }
+
+  for (const BlockHintsFrame *frame = bh->frames; frame != NULL;
+       frame = frame->next) {
+    if (frame->ts == ts) {
+      if (frame->map.hints != NULL) bh->cur = &frame->map;
+      if (has_analysis(frame)) bh->cur_analysis = frame;
+      break;
+    }
+  }
+}
+
+void av1_block_hints_free(AV1_COMP *cpi) {
+  BLOCK_HINTS *const bh = &cpi->block_hints;
+  while (bh->frames != NULL) {
+    BlockHintsFrame *const frame = bh->frames;
+    bh->frames = frame->next;
+    free_hints_frame(frame);
+  }
+  free_hints_frame(bh->pending);
+  bh->pending = NULL;
+  bh->cur = NULL;
+  bh->cur_analysis = NULL;
+}
+
+// Returns the hint at the pixel (x, y) of the coded frame.
+static const aom_block_hint_t *get_hint_at(const AV1_COMMON *cm,
+                                           const aom_block_hint_map_t *map,
+                                           int x, int y) {
+  const int hint_x = (int)((int64_t)x * map->width / cm->width);
+  const int hint_y = (int)((int64_t)y * map->height / cm->height);
+  const int col = AOMMIN(hint_x >> 2, (int)map->cols - 1);
+  const int row = AOMMIN(hint_y >> 2, (int)map->rows - 1);
+  return &map->hints[row * map->cols + col];
+}
+
+const aom_block_hint_t *av1_get_block_hint(const AV1_COMP *cpi,
+                                           BLOCK_SIZE bsize, int mi_row,
+                                           int mi_col) {
+  const aom_block_hint_map_t *const map = cpi->block_hints.cur;
+  if (map == NULL) return NULL;
+  return get_hint_at(&cpi->common, map,
+                     mi_col * MI_SIZE + block_size_wide[bsize] / 2,
+                     mi_row * MI_SIZE + block_size_high[bsize] / 2);
+}
+
+int av1_get_block_hint_mv(const AV1_COMP *cpi, BLOCK_SIZE bsize, int mi_row,
+                          int mi_col, MV_REFERENCE_FRAME ref, MV *mv) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const aom_block_hint_t *const hint =
+      av1_get_block_hint(cpi, bsize, mi_row, mi_col);
+  if (hint == NULL || hint->ref_frame != ref) return 0;
+
+  const aom_block_hint_map_t *const map = cpi->block_hints.cur;
+  mv->row = (int16_t)(hint->mv_row * cm->height / (int)map->height);
+  mv->col = (int16_t)(hint->mv_col * cm->width / (int)map->width);
+  return 1;
+}
+
+void av1_block_hints_prune_partition(const AV1_COMP *cpi, BLOCK_SIZE bsize,
+                                     int mi_row, int mi_col,
+                                     int *partition_none_allowed,
+                                     int *partition_horz_allowed,
+                                     int *partition_vert_allowed,
+                                     int *do_rectangular_split,
+                                     int *do_square_split) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const aom_block_hint_map_t *const map = cpi->block_hints.cur;
+  if (map == NULL) return;
+
+  // The smallest and the largest hinted sizes, scaled to the coded
+  // resolution, at the centers of the four quadrants.
+  const int bw = block_size_wide[bsize];
+  int min_size = INT_MAX;
+  int max_size = 0;
+  for (int i = 0; i < 4; ++i) {
+    const int x = mi_col * MI_SIZE + (i & 1) * bw / 2 + bw / 4;
+    const int y = mi_row * MI_SIZE + (i >> 1) * bw / 2 + bw / 4;
+    const aom_block_hint_t *const hint = get_hint_at(cm, map, x, y);
+    const int w = hint->block_width * cm->width / (int)map->width;
+    const int h = hint->block_height * cm->height / (int)map->height;
+    min_size = AOMMIN(min_size, AOMMIN(w, h));
+    max_size = AOMMAX(max_size, AOMMAX(w, h));
+  }
+
+  if (min_size >= bw && *partition_none_allowed) {
+    *do_square_split = 0;
+  } else if (max_size * 4 <= bw && *do_square_split) {
+    *partition_none_allowed = 0;
+    *partition_horz_allowed = 0;
+    *partition_vert_allowed = 0;
+    *do_rectangular_split = 0;
+  }
+}
+
+int av1_get_analysis_mv(const AV1_COMP *cpi, BLOCK_SIZE bsize, int mi_row,
+                        int mi_col, int dist, MV *mv) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const BlockHintsFrame *const frame = cpi->block_hints.cur_analysis;
+  if (frame == NULL || frame->analysis.mvs == NULL || dist == 0) return 0;
+
+  const aom_analysis_hints_t *const analysis = &frame->analysis;
+  const int x = mi_col * MI_SIZE + block_size_wide[bsize] / 2;
+  const int y = mi_row * MI_SIZE + block_size_high[bsize] / 2;
+  const int src_x = (int)((int64_t)x * frame->analysis_width / cm->width);
+  const int src_y = (int)((int64_t)y * frame->analysis_height / cm->height);
+  const int col = AOMMIN(src_x >> 4, (int)analysis->mv_cols - 1);
+  const int row = AOMMIN(src_y >> 4, (int)analysis->mv_rows - 1);
+  const aom_analysis_mv_t *const hint =
+      &analysis->mvs[row * analysis->mv_cols + col];
+  if (hint->row == AOM_ANALYSIS_NO_MV) return 0;
+
+  const int64_t mv_row =
+      (int64_t)hint->row * dist * cm->height / frame->analysis_height;
+  const int64_t mv_col =
+      (int64_t)hint->col * dist * cm->width / frame->analysis_width;
+  mv->row = (int16_t)clamp64(mv_row, MV_LOW + 1, MV_UPP - 1);
+  mv->col = (int16_t)clamp64(mv_col, MV_LOW + 1, MV_UPP - 1);
+  return 1;
+}
+
+int av1_get_analysis_ref_mv(const AV1_COMP *cpi, BLOCK_SIZE bsize, int mi_row,
+                            int mi_col, MV_REFERENCE_FRAME ref, MV *mv) {
+  const AV1_COMMON *const cm = &cpi->common;
+  if (cpi->block_hints.cur_analysis == NULL) return 0;
+  const RefCntBuffer *const buf = get_ref_frame_buf(cm, ref);
+  if (buf == NULL) return 0;
+  const int dist = get_relative_dist(&cm->seq_params.order_hint_info,
+                                     cm->current_frame.order_hint,
+                                     buf->order_hint);
+  return av1_get_analysis_mv(cpi, bsize, mi_row, mi_col, dist, mv);
+}
+
+int av1_get_analysis_depth(const AV1_COMP *cpi, int mi_row, int mi_col) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const BlockHintsFrame *const frame = cpi->block_hints.cur_analysis;
+  if (frame == NULL || frame->analysis.depths == NULL ||
+      cm->width != frame->analysis_width ||
+      cm->height != frame->analysis_height)
+    return -1;
+
+  const aom_analysis_hints_t *const analysis = &frame->analysis;
+  const unsigned int row = mi_row / MI_SIZE_64X64;
+  const unsigned int col = mi_col / MI_SIZE_64X64;
+  if (row >= analysis->depth_rows || col >= analysis->depth_cols) return -1;
+  const uint8_t depth = analysis->depths[row * analysis->depth_cols + col];
+  return depth == AOM_ANALYSIS_NO_DEPTH ? -1 : depth;
+}
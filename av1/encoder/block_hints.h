@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_ENCODER_BLOCK_HINTS_H_
+#define AOM_AV1_ENCODER_BLOCK_HINTS_H_
+
+#include "av1/encoder/encoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The block hints (see AV1E_SET_BLOCK_HINTS) and the analysis hints (see
+// AV1E_SET_ANALYSIS_HINTS) set before a frame is received follow it through
+// the lookahead, keyed by its time stamp.
+
+// Copies the hints for the next frame received. A map without hints clears
+// them. Returns -1 if the map is invalid.
+int av1_set_block_hints(AV1_COMP *cpi, const aom_block_hint_map_t *map);
+
+// Copies the analysis for the next frame received, which must describe frames
+// of the configured size. Returns -1 if it does not.
+int av1_set_analysis_hints(AV1_COMP *cpi, const aom_analysis_hints_t *hints);
+
+// Returns 1 if the analysis of the next frame received marks a scene cut.
+int av1_block_hints_scene_cut(const AV1_COMP *cpi);
+
+// Attaches the pending hints to the frame received with the time stamp ts.
+void av1_block_hints_receive_frame(AV1_COMP *cpi, int64_t ts);
+
+// Selects the hints of the source frame with the time stamp ts for the frame
+// about to be coded. Once a frame is shown, the hints of the earlier frames
+// are freed.
+void av1_block_hints_setup_frame(AV1_COMP *cpi, int64_t ts, int show_frame);
+
+void av1_block_hints_free(AV1_COMP *cpi);
+
+// Returns the hint at the center of the block, or NULL when the frame has no
+// hints.
+const aom_block_hint_t *av1_get_block_hint(const AV1_COMP *cpi,
+                                           BLOCK_SIZE bsize, int mi_row,
+                                           int mi_col);
+
+// Gets the hinted motion vector of the block for the reference frame ref,
+// scaled to the coded resolution. Returns 0 if there is none.
+int av1_get_block_hint_mv(const AV1_COMP *cpi, BLOCK_SIZE bsize, int mi_row,
+                          int mi_col, MV_REFERENCE_FRAME ref, MV *mv);
+
+// Prunes the partitions of a square block the hinted block sizes rule out:
+// the split when the hinted blocks are at least as large, the none and
+// rectangular partitions when they are at most a quarter of its size.
+void av1_block_hints_prune_partition(const AV1_COMP *cpi, BLOCK_SIZE bsize,
+                                     int mi_row, int mi_col,
+                                     int *partition_none_allowed,
+                                     int *partition_horz_allowed,
+                                     int *partition_vert_allowed,
+                                     int *do_rectangular_split,
+                                     int *do_square_split);
+
+// Gets the analysis motion vector of the 16x16 source block at the center of
+// the block, extrapolated to a reference dist frames away in display order
+// and scaled to the coded resolution. Returns 0 if there is none.
+int av1_get_analysis_mv(const AV1_COMP *cpi, BLOCK_SIZE bsize, int mi_row,
+                        int mi_col, int dist, MV *mv);
+
+// Same as av1_get_analysis_mv() for the reference frame ref of the frame being
+// coded.
+int av1_get_analysis_ref_mv(const AV1_COMP *cpi, BLOCK_SIZE bsize, int mi_row,
+                            int mi_col, MV_REFERENCE_FRAME ref, MV *mv);
+
+// Returns the analysis partition depth of the 64x64 block at (mi_row,
+// mi_col), or -1 if there is none or the frame is not coded at the size of
+// the source.
+int av1_get_analysis_depth(const AV1_COMP *cpi, int mi_row, int mi_col);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_ENCODER_BLOCK_HINTS_H_
@@ -297,14 +297,6 @@ activation_fn get_activation(ACTIVATION layer_activation) {
   }
 }
 
-static INLINE int get_start_shift_convolve(int width, int filt_width,
-                                           int stride) {
-  const int mod = (width % stride);
-  const int filt_off = (filt_width - 1) / 2;
-  const int dif = (mod ? mod - 1 : stride - 1);
-  return AOMMIN((dif + (filt_width % 2)) / 2, filt_off);
-}
-
 void av1_cnn_add_c(float **output, int channels, int width, int height,
                    int stride, const float **add) {
   for (int c = 0; c < channels; ++c) {
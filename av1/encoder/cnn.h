@@ -18,6 +18,7 @@ extern "C" {
 
 #include <math.h>
 
+#include "aom_dsp/aom_dsp_common.h"
 #include "aom_util/aom_thread.h"
 #include "config/av1_rtcd.h"
 
@@ -162,6 +163,16 @@ struct CNN_MULTI_OUT {
   float **output_buffer;
 };
 
+// Returns the position of the first filter center along a dimension of a
+// strided convolution with "same" padding.
+static INLINE int get_start_shift_convolve(int width, int filt_width,
+                                           int stride) {
+  const int mod = (width % stride);
+  const int filt_off = (filt_width - 1) / 2;
+  const int dif = (mod ? mod - 1 : stride - 1);
+  return AOMMIN((dif + (filt_width % 2)) / 2, filt_off);
+}
+
 // Function to return size of output
 void av1_find_cnn_output_size(int in_width, int in_height,
                               const CNN_CONFIG *cnn_config, int *out_width,
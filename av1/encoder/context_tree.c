@@ -22,115 +22,127 @@ typedef struct {
   tran_low_t *dqcoeff_buf[MAX_MB_PLANE];
 } PC_TREE_SHARED_BUFFERS;
 
-static AOM_INLINE void alloc_mode_context(AV1_COMMON *cm, int num_pix,
-                                          PICK_MODE_CONTEXT *ctx,
-                                          PC_TREE_SHARED_BUFFERS *shared_bufs) {
-  const int num_planes = av1_num_planes(cm);
-  int i;
+#define ARENA_ALIGN 32
+
+static INLINE size_t arena_align(size_t size) {
+  return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+// Returns the size of the buffers handed out to a context of num_pix pixels.
+static size_t get_mode_context_size(int num_pix, int num_planes) {
   const int num_blk = num_pix / 16;
-  ctx->num_4x4_blk = num_blk;
+  size_t size = arena_align(num_blk * sizeof(uint8_t)) +
+                arena_align(num_blk * sizeof(TX_TYPE));
+  size += num_planes * (arena_align(num_blk * sizeof(uint16_t)) +
+                        arena_align(num_blk * sizeof(uint8_t)));
+  if (num_pix <= MAX_PALETTE_SQUARE)
+    size += 2 * arena_align(num_pix * sizeof(uint8_t));
+  return size;
+}
 
-  CHECK_MEM_ERROR(cm, ctx->blk_skip,
-                  aom_calloc(num_blk, sizeof(*ctx->blk_skip)));
-  CHECK_MEM_ERROR(cm, ctx->tx_type_map,
-                  aom_calloc(num_blk, sizeof(*ctx->tx_type_map)));
-  for (i = 0; i < num_planes; ++i) {
-    ctx->coeff[i] = shared_bufs->coeff_buf[i];
-    ctx->qcoeff[i] = shared_bufs->qcoeff_buf[i];
-    ctx->dqcoeff[i] = shared_bufs->dqcoeff_buf[i];
-    CHECK_MEM_ERROR(cm, ctx->eobs[i],
-                    aom_memalign(32, num_blk * sizeof(*ctx->eobs[i])));
-    CHECK_MEM_ERROR(
-        cm, ctx->txb_entropy_ctx[i],
-        aom_memalign(32, num_blk * sizeof(*ctx->txb_entropy_ctx[i])));
-  }
+static INLINE void *arena_alloc(PC_TREE_ARENA *arena, size_t size) {
+  void *const ptr = arena->buf + arena->used;
+  arena->used += arena_align(size);
+  assert(arena->used <= arena->size);
+  return ptr;
+}
+
+void av1_reset_pc_tree_arena(PC_TREE_ARENA *arena) {
+  arena->used = 0;
+  ++arena->generation;
+}
 
+void av1_setup_mode_context(PC_TREE_ARENA *arena, PICK_MODE_CONTEXT *ctx) {
+  if (ctx->arena_generation == arena->generation) return;
+  ctx->arena_generation = arena->generation;
+
+  const int num_blk = ctx->num_4x4_blk;
+  const int num_pix = num_blk * 16;
+  ctx->blk_skip = arena_alloc(arena, num_blk * sizeof(*ctx->blk_skip));
+  ctx->tx_type_map = arena_alloc(arena, num_blk * sizeof(*ctx->tx_type_map));
+  memset(ctx->blk_skip, 0, num_blk * sizeof(*ctx->blk_skip));
+  memset(ctx->tx_type_map, 0, num_blk * sizeof(*ctx->tx_type_map));
+  for (int i = 0; i < arena->num_planes; ++i) {
+    ctx->eobs[i] = arena_alloc(arena, num_blk * sizeof(*ctx->eobs[i]));
+    ctx->txb_entropy_ctx[i] =
+        arena_alloc(arena, num_blk * sizeof(*ctx->txb_entropy_ctx[i]));
+  }
   if (num_pix <= MAX_PALETTE_SQUARE) {
-    for (i = 0; i < 2; ++i) {
-      CHECK_MEM_ERROR(
-          cm, ctx->color_index_map[i],
-          aom_memalign(32, num_pix * sizeof(*ctx->color_index_map[i])));
+    for (int i = 0; i < 2; ++i) {
+      ctx->color_index_map[i] =
+          arena_alloc(arena, num_pix * sizeof(*ctx->color_index_map[i]));
     }
   }
 }
 
-static AOM_INLINE void free_mode_context(PICK_MODE_CONTEXT *ctx,
-                                         const int num_planes) {
-  int i;
-  aom_free(ctx->blk_skip);
-  ctx->blk_skip = 0;
-  aom_free(ctx->tx_type_map);
-  ctx->tx_type_map = 0;
-  for (i = 0; i < num_planes; ++i) {
-    ctx->coeff[i] = 0;
-    ctx->qcoeff[i] = 0;
-    ctx->dqcoeff[i] = 0;
-    aom_free(ctx->eobs[i]);
-    ctx->eobs[i] = 0;
-    aom_free(ctx->txb_entropy_ctx[i]);
-    ctx->txb_entropy_ctx[i] = 0;
-  }
-
-  for (i = 0; i < 2; ++i) {
-    aom_free(ctx->color_index_map[i]);
-    ctx->color_index_map[i] = 0;
+// The buffers of the context are handed out by av1_setup_mode_context() when
+// it is first used in a superblock, except for the coefficients shared by all
+// the contexts.
+static AOM_INLINE void init_mode_context(int num_pix, int num_planes,
+                                         PICK_MODE_CONTEXT *ctx,
+                                         PC_TREE_SHARED_BUFFERS *shared_bufs,
+                                         size_t *arena_size) {
+  ctx->num_4x4_blk = num_pix / 16;
+  for (int i = 0; i < num_planes; ++i) {
+    ctx->coeff[i] = shared_bufs->coeff_buf[i];
+    ctx->qcoeff[i] = shared_bufs->qcoeff_buf[i];
+    ctx->dqcoeff[i] = shared_bufs->dqcoeff_buf[i];
   }
+  *arena_size += get_mode_context_size(num_pix, num_planes);
 }
 
-static AOM_INLINE void alloc_tree_contexts(
-    AV1_COMMON *cm, PC_TREE *tree, int num_pix, int is_leaf,
-    PC_TREE_SHARED_BUFFERS *shared_bufs) {
-  alloc_mode_context(cm, num_pix, &tree->none, shared_bufs);
+static AOM_INLINE void init_tree_contexts(int num_planes, PC_TREE *tree,
+                                          int num_pix, int is_leaf,
+                                          PC_TREE_SHARED_BUFFERS *shared_bufs,
+                                          size_t *arena_size) {
+  init_mode_context(num_pix, num_planes, &tree->none, shared_bufs,
+                    arena_size);
 
   if (is_leaf) return;
 
-  alloc_mode_context(cm, num_pix / 2, &tree->horizontal[0], shared_bufs);
-  alloc_mode_context(cm, num_pix / 2, &tree->vertical[0], shared_bufs);
-
-  alloc_mode_context(cm, num_pix / 2, &tree->horizontal[1], shared_bufs);
-  alloc_mode_context(cm, num_pix / 2, &tree->vertical[1], shared_bufs);
-
-  alloc_mode_context(cm, num_pix / 4, &tree->horizontala[0], shared_bufs);
-  alloc_mode_context(cm, num_pix / 4, &tree->horizontala[1], shared_bufs);
-  alloc_mode_context(cm, num_pix / 2, &tree->horizontala[2], shared_bufs);
-
-  alloc_mode_context(cm, num_pix / 2, &tree->horizontalb[0], shared_bufs);
-  alloc_mode_context(cm, num_pix / 4, &tree->horizontalb[1], shared_bufs);
-  alloc_mode_context(cm, num_pix / 4, &tree->horizontalb[2], shared_bufs);
-
-  alloc_mode_context(cm, num_pix / 4, &tree->verticala[0], shared_bufs);
-  alloc_mode_context(cm, num_pix / 4, &tree->verticala[1], shared_bufs);
-  alloc_mode_context(cm, num_pix / 2, &tree->verticala[2], shared_bufs);
+  for (int i = 0; i < 2; ++i) {
+    init_mode_context(num_pix / 2, num_planes, &tree->horizontal[i],
+                      shared_bufs, arena_size);
+    init_mode_context(num_pix / 2, num_planes, &tree->vertical[i],
+                      shared_bufs, arena_size);
+  }
 
-  alloc_mode_context(cm, num_pix / 2, &tree->verticalb[0], shared_bufs);
-  alloc_mode_context(cm, num_pix / 4, &tree->verticalb[1], shared_bufs);
-  alloc_mode_context(cm, num_pix / 4, &tree->verticalb[2], shared_bufs);
+  init_mode_context(num_pix / 4, num_planes, &tree->horizontala[0],
+                    shared_bufs, arena_size);
+  init_mode_context(num_pix / 4, num_planes, &tree->horizontala[1],
+                    shared_bufs, arena_size);
+  init_mode_context(num_pix / 2, num_planes, &tree->horizontala[2],
+                    shared_bufs, arena_size);
+
+  init_mode_context(num_pix / 2, num_planes, &tree->horizontalb[0],
+                    shared_bufs, arena_size);
+  init_mode_context(num_pix / 4, num_planes, &tree->horizontalb[1],
+                    shared_bufs, arena_size);
+  init_mode_context(num_pix / 4, num_planes, &tree->horizontalb[2],
+                    shared_bufs, arena_size);
+
+  init_mode_context(num_pix / 4, num_planes, &tree->verticala[0],
+                    shared_bufs, arena_size);
+  init_mode_context(num_pix / 4, num_planes, &tree->verticala[1],
+                    shared_bufs, arena_size);
+  init_mode_context(num_pix / 2, num_planes, &tree->verticala[2],
+                    shared_bufs, arena_size);
+
+  init_mode_context(num_pix / 2, num_planes, &tree->verticalb[0],
+                    shared_bufs, arena_size);
+  init_mode_context(num_pix / 4, num_planes, &tree->verticalb[1],
+                    shared_bufs, arena_size);
+  init_mode_context(num_pix / 4, num_planes, &tree->verticalb[2],
+                    shared_bufs, arena_size);
 
   for (int i = 0; i < 4; ++i) {
-    alloc_mode_context(cm, num_pix / 4, &tree->horizontal4[i], shared_bufs);
-    alloc_mode_context(cm, num_pix / 4, &tree->vertical4[i], shared_bufs);
+    init_mode_context(num_pix / 4, num_planes, &tree->horizontal4[i],
+                      shared_bufs, arena_size);
+    init_mode_context(num_pix / 4, num_planes, &tree->vertical4[i],
+                      shared_bufs, arena_size);
   }
 }
 
-static AOM_INLINE void free_tree_contexts(PC_TREE *tree, const int num_planes) {
-  int i;
-  for (i = 0; i < 3; i++) {
-    free_mode_context(&tree->horizontala[i], num_planes);
-    free_mode_context(&tree->horizontalb[i], num_planes);
-    free_mode_context(&tree->verticala[i], num_planes);
-    free_mode_context(&tree->verticalb[i], num_planes);
-  }
-  for (i = 0; i < 4; ++i) {
-    free_mode_context(&tree->horizontal4[i], num_planes);
-    free_mode_context(&tree->vertical4[i], num_planes);
-  }
-  free_mode_context(&tree->none, num_planes);
-  free_mode_context(&tree->horizontal[0], num_planes);
-  free_mode_context(&tree->horizontal[1], num_planes);
-  free_mode_context(&tree->vertical[0], num_planes);
-  free_mode_context(&tree->vertical[1], num_planes);
-}
-
 // This function sets up a tree of contexts such that at each square
 // partition level. There are contexts for none, horizontal, vertical, and
 // split.  Along with a block_size value and a selected block_size which
@@ -146,6 +158,8 @@ void av1_setup_pc_tree(AV1_COMMON *cm, ThreadData *td) {
   PC_TREE_SHARED_BUFFERS shared_bufs;
   int square_index = 1;
   int nodes;
+  const int num_planes = av1_num_planes(cm);
+  size_t arena_size = 0;
 
   aom_free(td->pc_tree);
   CHECK_MEM_ERROR(cm, td->pc_tree,
@@ -169,7 +183,7 @@ void av1_setup_pc_tree(AV1_COMMON *cm, ThreadData *td) {
   for (pc_tree_index = 0; pc_tree_index < leaf_nodes; ++pc_tree_index) {
     PC_TREE *const tree = &td->pc_tree[pc_tree_index];
     tree->block_size = square[0];
-    alloc_tree_contexts(cm, tree, 16, 1, &shared_bufs);
+    init_tree_contexts(num_planes, tree, 16, 1, &shared_bufs, &arena_size);
   }
 
   // Each node has 4 leaf nodes, fill each block_size level of the tree
@@ -177,7 +191,8 @@ void av1_setup_pc_tree(AV1_COMMON *cm, ThreadData *td) {
   for (nodes = leaf_nodes >> 2; nodes > 0; nodes >>= 2) {
     for (i = 0; i < nodes; ++i) {
       PC_TREE *const tree = &td->pc_tree[pc_tree_index];
-      alloc_tree_contexts(cm, tree, 16 << (2 * square_index), 0, &shared_bufs);
+      init_tree_contexts(num_planes, tree, 16 << (2 * square_index), 0,
+                         &shared_bufs, &arena_size);
       tree->block_size = square[square_index];
       for (j = 0; j < 4; j++) tree->split[j] = this_pc++;
       ++pc_tree_index;
@@ -185,6 +200,17 @@ void av1_setup_pc_tree(AV1_COMMON *cm, ThreadData *td) {
     ++square_index;
   }
 
+  // The arena can hold the buffers of all the contexts, but only the pages
+  // of the ones searched in a superblock are ever touched.
+  aom_free(td->pc_tree_arena.buf);
+  CHECK_MEM_ERROR(cm, td->pc_tree_arena.buf,
+                  aom_memalign(ARENA_ALIGN, arena_size));
+  td->pc_tree_arena.size = arena_size;
+  td->pc_tree_arena.used = 0;
+  td->pc_tree_arena.num_planes = num_planes;
+  td->pc_tree_arena.generation = 1;
+  td->mb.pc_tree_arena = &td->pc_tree_arena;
+
   // Set up the root node for the largest superblock size
   i = MAX_MIB_SIZE_LOG2 - MIN_MIB_SIZE_LOG2;
   td->pc_root[i] = &td->pc_tree[tree_nodes - 1];
@@ -200,13 +226,11 @@ void av1_setup_pc_tree(AV1_COMMON *cm, ThreadData *td) {
   }
 }
 
-void av1_free_pc_tree(ThreadData *td, const int num_planes) {
+void av1_free_pc_tree(ThreadData *td) {
   if (td->pc_tree != NULL) {
-    const int tree_nodes_inc = 1024;
-    const int tree_nodes = tree_nodes_inc + 256 + 64 + 16 + 4 + 1;
-    for (int i = 0; i < tree_nodes; ++i) {
-      free_tree_contexts(&td->pc_tree[i], num_planes);
-    }
+    aom_free(td->pc_tree_arena.buf);
+    td->pc_tree_arena.buf = NULL;
+    td->pc_tree_arena.size = 0;
     for (int i = 0; i < 3; ++i) {
       aom_free(td->tree_coeff_buf[i]);
       aom_free(td->tree_qcoeff_buf[i]);
@@ -220,8 +244,9 @@ void av1_free_pc_tree(ThreadData *td, const int num_planes) {
   }
 }
 
-void av1_copy_tree_context(PICK_MODE_CONTEXT *dst_ctx,
+void av1_copy_tree_context(PC_TREE_ARENA *arena, PICK_MODE_CONTEXT *dst_ctx,
                            PICK_MODE_CONTEXT *src_ctx) {
+  av1_setup_mode_context(arena, dst_ctx);
   dst_ctx->mic = src_ctx->mic;
   dst_ctx->mbmi_ext = src_ctx->mbmi_ext;
 
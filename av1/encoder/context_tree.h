@@ -59,8 +59,24 @@ typedef struct {
   // search loop
   MV pred_mv[REF_FRAMES];
   PARTITION_TYPE partition;
+
+  // The generation of the arena when the buffers were handed out.
+  unsigned int arena_generation;
 } PICK_MODE_CONTEXT;
 
+// Storage of the buffers of the PICK_MODE_CONTEXTs of a thread. A context gets
+// its buffers the first time it is used in a superblock, and all of them are
+// released at once when the next superblock starts.
+typedef struct pc_tree_arena {
+  uint8_t *buf;
+  size_t size;
+  size_t used;
+  int num_planes;
+  // Incremented on each reset, the contexts of the older generations have no
+  // buffers.
+  unsigned int generation;
+} PC_TREE_ARENA;
+
 typedef struct PC_TREE {
   PARTITION_TYPE partitioning;
   BLOCK_SIZE block_size;
@@ -85,8 +101,12 @@ typedef struct PC_TREE {
 } PC_TREE;
 
 void av1_setup_pc_tree(struct AV1Common *cm, struct ThreadData *td);
-void av1_free_pc_tree(struct ThreadData *td, const int num_planes);
-void av1_copy_tree_context(PICK_MODE_CONTEXT *dst_ctx,
+void av1_free_pc_tree(struct ThreadData *td);
+void av1_reset_pc_tree_arena(PC_TREE_ARENA *arena);
+// Hands out the buffers of the context, unless it already got them since the
+// last reset.
+void av1_setup_mode_context(PC_TREE_ARENA *arena, PICK_MODE_CONTEXT *ctx);
+void av1_copy_tree_context(PC_TREE_ARENA *arena, PICK_MODE_CONTEXT *dst_ctx,
                            PICK_MODE_CONTEXT *src_ctx);
 
 #ifdef __cplusplus
@@ -26,6 +26,7 @@
 #include "av1/common/onyxc_int.h"
 #include "av1/common/reconinter.h"
 
+#include "av1/encoder/block_hints.h"
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/encode_strategy.h"
 #include "av1/encoder/encodeframe.h"
@@ -1161,6 +1162,7 @@ int av1_encode_strategy(AV1_COMP *const cpi, size_t *const size,
     cpi->last_end_time_stamp_seen = source->ts_start;
   }
 
+  av1_block_hints_setup_frame(cpi, source->ts_start, frame_params.show_frame);
   av1_apply_encoding_flags(cpi, source->flags);
   if (!frame_params.show_existing_frame)
     *frame_flags = (source->flags & AOM_EFLAG_FORCE_KF) ? FRAMEFLAGS_KEY : 0;
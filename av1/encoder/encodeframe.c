@@ -47,6 +47,7 @@
 #include "av1/encoder/aq_complexity.h"
 #include "av1/encoder/aq_cyclicrefresh.h"
 #include "av1/encoder/aq_variance.h"
+#include "av1/encoder/block_hints.h"
 #include "av1/encoder/corner_detect.h"
 #include "av1/encoder/global_motion.h"
 #include "av1/encoder/encodeframe.h"
@@ -64,8 +65,10 @@
 #include "av1/encoder/rdopt.h"
 #include "av1/encoder/reconinter_enc.h"
 #include "av1/encoder/segmentation.h"
+#include "av1/encoder/time_budget.h"
 #include "av1/encoder/tokenize.h"
 #include "av1/encoder/tpl_model.h"
+#include "av1/encoder/tx_rd_cache.h"
 #include "av1/encoder/var_based_part.h"
 
 static AOM_INLINE void encode_superblock(const AV1_COMP *const cpi,
@@ -503,6 +506,7 @@ static AOM_INLINE void update_state(const AV1_COMP *const cpi, ThreadData *td,
   const int mi_height = mi_size_high[bsize];
 
   assert(mi->sb_type == bsize);
+  assert(ctx->arena_generation == x->pc_tree_arena->generation);
 
   *mi_addr = *mi;
   *x->mbmi_ext = ctx->mbmi_ext;
@@ -686,6 +690,7 @@ static AOM_INLINE void pick_sb_modes(AV1_COMP *const cpi,
                                      PARTITION_TYPE partition, BLOCK_SIZE bsize,
                                      PICK_MODE_CONTEXT *ctx, RD_STATS best_rd,
                                      int pick_mode_type) {
+  av1_setup_mode_context(x->pc_tree_arena, ctx);
   if (best_rd.rdcost < 0) {
     ctx->rd_stats.rdcost = INT64_MAX;
     ctx->rd_stats.skip = 0;
@@ -2701,6 +2706,16 @@ static bool rd_pick_partition(AV1_COMP *const cpi, ThreadData *td,
         &partition_vert_allowed, &prune_horz, &prune_vert);
   }
 
+  // Follow the block sizes of the hinted encode of the source.
+  if (cpi->block_hints.cur && bsize >= BLOCK_8X8 &&
+      mi_row + mi_size_high[bsize] <= cm->mi_rows &&
+      mi_col + mi_size_wide[bsize] <= cm->mi_cols) {
+    av1_block_hints_prune_partition(
+        cpi, bsize, mi_row, mi_col, &partition_none_allowed,
+        &partition_horz_allowed, &partition_vert_allowed, &do_rectangular_split,
+        &do_square_split);
+  }
+
   // Max and min square partition levels are defined as the partition nodes that
   // the recursive function rd_pick_partition() can reach. To implement this:
   // only PARTITION_NONE is allowed if the current node equals min_sq_part,
@@ -3284,11 +3299,12 @@ BEGIN_PARTITION_SEARCH:
     pc_tree->horizontala[1].rd_mode_is_ready = 0;
     pc_tree->horizontala[2].rd_mode_is_ready = 0;
     if (split_ctx_is_ready[0]) {
-      av1_copy_tree_context(&pc_tree->horizontala[0], &pc_tree->split[0]->none);
+      av1_copy_tree_context(x->pc_tree_arena, &pc_tree->horizontala[0],
+                            &pc_tree->split[0]->none);
       pc_tree->horizontala[0].mic.partition = PARTITION_HORZ_A;
       pc_tree->horizontala[0].rd_mode_is_ready = 1;
       if (split_ctx_is_ready[1]) {
-        av1_copy_tree_context(&pc_tree->horizontala[1],
+        av1_copy_tree_context(x->pc_tree_arena, &pc_tree->horizontala[1],
                               &pc_tree->split[1]->none);
         pc_tree->horizontala[1].mic.partition = PARTITION_HORZ_A;
         pc_tree->horizontala[1].rd_mode_is_ready = 1;
@@ -3330,7 +3346,8 @@ BEGIN_PARTITION_SEARCH:
     pc_tree->horizontalb[1].rd_mode_is_ready = 0;
     pc_tree->horizontalb[2].rd_mode_is_ready = 0;
     if (horz_ctx_is_ready) {
-      av1_copy_tree_context(&pc_tree->horizontalb[0], &pc_tree->horizontal[0]);
+      av1_copy_tree_context(x->pc_tree_arena, &pc_tree->horizontalb[0],
+                            &pc_tree->horizontal[0]);
       pc_tree->horizontalb[0].mic.partition = PARTITION_HORZ_B;
       pc_tree->horizontalb[0].rd_mode_is_ready = 1;
     }
@@ -3372,7 +3389,8 @@ BEGIN_PARTITION_SEARCH:
     pc_tree->verticala[1].rd_mode_is_ready = 0;
     pc_tree->verticala[2].rd_mode_is_ready = 0;
     if (split_ctx_is_ready[0]) {
-      av1_copy_tree_context(&pc_tree->verticala[0], &pc_tree->split[0]->none);
+      av1_copy_tree_context(x->pc_tree_arena, &pc_tree->verticala[0],
+                            &pc_tree->split[0]->none);
       pc_tree->verticala[0].mic.partition = PARTITION_VERT_A;
       pc_tree->verticala[0].rd_mode_is_ready = 1;
     }
@@ -3412,7 +3430,8 @@ BEGIN_PARTITION_SEARCH:
     pc_tree->verticalb[1].rd_mode_is_ready = 0;
     pc_tree->verticalb[2].rd_mode_is_ready = 0;
     if (vert_ctx_is_ready) {
-      av1_copy_tree_context(&pc_tree->verticalb[0], &pc_tree->vertical[0]);
+      av1_copy_tree_context(x->pc_tree_arena, &pc_tree->verticalb[0],
+                            &pc_tree->vertical[0]);
       pc_tree->verticalb[0].mic.partition = PARTITION_VERT_B;
       pc_tree->verticalb[0].rd_mode_is_ready = 1;
     }
@@ -3769,7 +3788,9 @@ static int get_rdmult_delta(AV1_COMP *cpi, BLOCK_SIZE bsize, int analysis_type,
 
 static int get_tpl_stats_b(AV1_COMP *cpi, BLOCK_SIZE bsize, int mi_row,
                            int mi_col, int64_t *intra_cost_b,
-                           int64_t *inter_cost_b, int *stride) {
+                           int64_t *inter_cost_b,
+                           int_mv (*ref_mvs_b)[INTER_REFS_PER_FRAME],
+                           int *stride) {
   if (!cpi->oxcf.enable_tpl_model) return 0;
   if (cpi->tpl_model_pass == 1) {
     assert(cpi->oxcf.enable_tpl_model == 2);
@@ -3817,6 +3838,11 @@ static int get_tpl_stats_b(AV1_COMP *cpi, BLOCK_SIZE bsize, int mi_row,
           &tpl_stats[av1_tpl_ptr_pos(cpi, row, col, tpl_stride)];
       inter_cost_b[mi_count] = this_stats->inter_cost;
       intra_cost_b[mi_count] = this_stats->intra_cost;
+      // Unlike the costs, the motion vectors are stored by position, so they
+      // can also be looked up in the partial superblocks.
+      const int pos =
+          (row - mi_row) / step * *stride + (col - mi_col_sr) / step;
+      memcpy(ref_mvs_b[pos], this_stats->ref_mvs, sizeof(this_stats->ref_mvs));
       mi_count++;
     }
   }
@@ -4316,6 +4342,7 @@ static AOM_INLINE void encode_sb_row(AV1_COMP *cpi, ThreadData *td,
     }
     PC_TREE *const pc_root = td->pc_root[mib_size_log2 - MIN_MIB_SIZE_LOG2];
     pc_root->index = 0;
+    av1_reset_pc_tree_arena(&td->pc_tree_arena);
 
     if ((sf->simple_motion_search_split ||
          sf->simple_motion_search_prune_rect ||
@@ -4408,7 +4435,8 @@ static AOM_INLINE void encode_sb_row(AV1_COMP *cpi, ThreadData *td,
         // No stats for overlay frames. Exclude key frame.
         x->valid_cost_b =
             get_tpl_stats_b(cpi, cm->seq_params.sb_size, mi_row, mi_col,
-                            x->intra_cost_b, x->inter_cost_b, &x->cost_stride);
+                            x->intra_cost_b, x->inter_cost_b, x->tpl_mvs_b,
+                            &x->cost_stride);
 
         reset_partition(pc_root, sb_size);
 
@@ -4581,6 +4609,10 @@ void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
   for (mi_row = tile_info->mi_row_start; mi_row < tile_info->mi_row_end;
        mi_row += cm->seq_params.mib_size) {
     av1_encode_sb_row(cpi, td, tile_row, tile_col, mi_row);
+    if (cpi->time_budget.check_rows) {
+      av1_time_budget_sb_row_done(cpi,
+                                  av1_get_sb_cols_in_tile(cm, *tile_info));
+    }
   }
 }
 
@@ -4595,6 +4627,8 @@ static AOM_INLINE void encode_tiles(AV1_COMP *cpi) {
 
   av1_init_tile_data(cpi);
 
+  if (av1_time_budget_enabled(cpi)) av1_time_budget_start_rows(cpi);
+
   for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
     for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
       TileDataEnc *const this_tile =
@@ -5256,6 +5290,8 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
   x->txb_split_count = 0;
 #if CONFIG_SPEED_STATS
   x->tx_search_count = 0;
+  x->tx_rd_cache_lookups = 0;
+  x->tx_rd_cache_hits = 0;
 #endif  // CONFIG_SPEED_STATS
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
@@ -5357,6 +5393,9 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
   cm->current_frame.skip_mode_info.skip_mode_flag =
       check_skip_mode_enabled(cpi);
 
+  av1_tx_rd_cache_init_frame(cpi);
+  av1_tx_rd_cache_setup_thread(cpi, &cpi->td);
+
   cpi->row_mt_sync_read_ptr = av1_row_mt_sync_read_dummy;
   cpi->row_mt_sync_write_ptr = av1_row_mt_sync_write_dummy;
   cpi->row_mt = 0;
@@ -5372,6 +5411,7 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
     else
       encode_tiles(cpi);
   }
+  av1_tx_rd_cache_merge_threads(cpi);
 
   // If intrabc is allowed but never selected, reset the allow_intrabc flag.
   if (cm->allow_intrabc && !cpi->intrabc_used) cm->allow_intrabc = 0;
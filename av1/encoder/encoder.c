@@ -52,6 +52,7 @@
 #include "av1/encoder/aq_cyclicrefresh.h"
 #include "av1/encoder/aq_variance.h"
 #include "av1/encoder/bitstream.h"
+#include "av1/encoder/block_hints.h"
 #include "av1/encoder/context_tree.h"
 #include "av1/encoder/encodeframe.h"
 #include "av1/encoder/encodemv.h"
@@ -63,6 +64,7 @@
 #include "av1/encoder/grain_test_vectors.h"
 #include "av1/encoder/hash_motion.h"
 #include "av1/encoder/mbgraph.h"
+#include "av1/encoder/partition_strategy.h"
 #include "av1/encoder/pass2_strategy.h"
 #include "av1/encoder/picklpf.h"
 #include "av1/encoder/pickrst.h"
@@ -72,7 +74,9 @@
 #include "av1/encoder/rdopt.h"
 #include "av1/encoder/segmentation.h"
 #include "av1/encoder/speed_features.h"
+#include "av1/encoder/time_budget.h"
 #include "av1/encoder/tpl_model.h"
+#include "av1/encoder/tx_rd_cache.h"
 #include "av1/encoder/reconinter_enc.h"
 #include "av1/encoder/var_based_part.h"
 
@@ -685,7 +689,6 @@ static void update_film_grain_parameters(struct AV1_COMP *cpi,
 
 static void dealloc_compressor_data(AV1_COMP *cpi) {
   AV1_COMMON *const cm = &cpi->common;
-  const int num_planes = av1_num_planes(cm);
 
   dealloc_context_buffers_ext(cpi);
 
@@ -711,6 +714,8 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
   aom_free(cpi->tpl_sb_rdmult_scaling_factors);
   cpi->tpl_sb_rdmult_scaling_factors = NULL;
 
+  av1_free_partition_nn_models(cpi);
+
   aom_free(cpi->td.mb.above_pred_buf);
   cpi->td.mb.above_pred_buf = NULL;
 
@@ -737,6 +742,9 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
   aom_free(cpi->td.mb.mbmi_ext);
   cpi->td.mb.mbmi_ext = NULL;
 
+  av1_tx_rd_cache_dealloc(&cpi->td.tx_rd_cache);
+  av1_tx_rd_cache_dealloc(&cpi->tx_rd_cache);
+
   av1_free_ref_frame_buffers(cm->buffer_pool);
   av1_free_txb_buf(cpi);
   av1_free_context_buffers(cm);
@@ -755,7 +763,7 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
   aom_free(cpi->tplist[0][0]);
   cpi->tplist[0][0] = NULL;
 
-  av1_free_pc_tree(&cpi->td, num_planes);
+  av1_free_pc_tree(&cpi->td);
 
   aom_free(cpi->td.mb.palette_buffer);
   av1_release_compound_type_rd_buffers(&cpi->td.mb.comp_rd_buffer);
@@ -2663,7 +2671,6 @@ static void config_target_level(AV1_COMP *const cpi, AV1_LEVEL target_level,
 void av1_change_config(struct AV1_COMP *cpi, const AV1EncoderConfig *oxcf) {
   AV1_COMMON *const cm = &cpi->common;
   SequenceHeader *const seq_params = &cm->seq_params;
-  const int num_planes = av1_num_planes(cm);
   RATE_CONTROL *const rc = &cpi->rc;
   MACROBLOCK *const x = &cpi->td.mb;
 
@@ -2817,7 +2824,7 @@ void av1_change_config(struct AV1_COMP *cpi, const AV1EncoderConfig *oxcf) {
     if (cm->width > cpi->initial_width || cm->height > cpi->initial_height ||
         seq_params->sb_size != sb_size) {
       av1_free_context_buffers(cm);
-      av1_free_pc_tree(&cpi->td, num_planes);
+      av1_free_pc_tree(&cpi->td);
       alloc_compressor_data(cpi);
       realloc_segmentation_maps(cpi);
       cpi->initial_width = cpi->initial_height = 0;
@@ -2927,6 +2934,8 @@ AV1_COMP *av1_create_compressor(AV1EncoderConfig *oxcf,
   cpi->bytes = 0;
 #if CONFIG_SPEED_STATS
   cpi->tx_search_count = 0;
+  cpi->tx_rd_cache_lookups = 0;
+  cpi->tx_rd_cache_hits = 0;
 #endif  // CONFIG_SPEED_STATS
 
   if (cpi->b_calculate_psnr) {
@@ -3032,6 +3041,10 @@ AV1_COMP *av1_create_compressor(AV1EncoderConfig *oxcf,
                                sizeof(*cpi->tpl_sb_rdmult_scaling_factors)));
   }
 
+  if (!av1_quantize_partition_nn_models(cpi))
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate quantized partition models");
+
   {
     const int bsize = BLOCK_16X16;
     const int w = mi_size_wide[bsize];
@@ -3315,7 +3328,6 @@ void av1_remove_compressor(AV1_COMP *cpi) {
   if (!cpi) return;
 
   cm = &cpi->common;
-  const int num_planes = av1_num_planes(cm);
 
   if (cm->current_frame.frame_number > 0) {
 #if CONFIG_ENTROPY_STATS
@@ -3402,6 +3414,8 @@ void av1_remove_compressor(AV1_COMP *cpi) {
 #if CONFIG_SPEED_STATS
     if (cpi->oxcf.pass != 1) {
       fprintf(stdout, "tx_search_count = %d\n", cpi->tx_search_count);
+      fprintf(stdout, "tx_rd_cache hits = %u / %u lookups\n",
+              cpi->tx_rd_cache_hits, cpi->tx_rd_cache_lookups);
     }
 #endif  // CONFIG_SPEED_STATS
 
@@ -3449,7 +3463,8 @@ void av1_remove_compressor(AV1_COMP *cpi) {
       }
       aom_free(thread_data->td->mask_buf);
       aom_free(thread_data->td->counts);
-      av1_free_pc_tree(thread_data->td, num_planes);
+      av1_free_pc_tree(thread_data->td);
+      av1_tx_rd_cache_dealloc(&thread_data->td->tx_rd_cache);
       aom_free(thread_data->td->mbmi_ext);
       aom_free(thread_data->td);
     }
@@ -3470,6 +3485,7 @@ void av1_remove_compressor(AV1_COMP *cpi) {
   }
 
   dealloc_compressor_data(cpi);
+  av1_block_hints_free(cpi);
 
   for (i = 0; i < sizeof(cpi->mbgraph_stats) / sizeof(cpi->mbgraph_stats[0]);
        ++i) {
@@ -3758,8 +3774,9 @@ static void scale_references(AV1_COMP *cpi) {
             aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
                                "Failed to allocate frame buffer");
           }
-          av1_resize_and_extend_frame(
-              ref, &new_fb->buf, (int)cm->seq_params.bit_depth, num_planes);
+          av1_resize_and_extend_frame_mt(
+              ref, &new_fb->buf, (int)cm->seq_params.bit_depth, num_planes,
+              cpi->workers, cpi->num_workers);
           cpi->scaled_ref_buf[ref_frame - 1] = new_fb;
           alloc_frame_mvs(cm, new_fb);
         }
@@ -4141,7 +4158,6 @@ static void check_initial_width(AV1_COMP *cpi, int use_highbitdepth,
 // Returns 1 if the assigned width or height was <= 0.
 int av1_set_size_literal(AV1_COMP *cpi, int width, int height) {
   AV1_COMMON *cm = &cpi->common;
-  const int num_planes = av1_num_planes(cm);
   check_initial_width(cpi, cm->seq_params.use_highbitdepth,
                       cm->seq_params.subsampling_x,
                       cm->seq_params.subsampling_y);
@@ -4154,7 +4170,7 @@ int av1_set_size_literal(AV1_COMP *cpi, int width, int height) {
   if (cpi->initial_width && cpi->initial_height &&
       (cm->width > cpi->initial_width || cm->height > cpi->initial_height)) {
     av1_free_context_buffers(cm);
-    av1_free_pc_tree(&cpi->td, num_planes);
+    av1_free_pc_tree(&cpi->td);
     alloc_compressor_data(cpi);
     realloc_segmentation_maps(cpi);
     cpi->initial_width = cpi->initial_height = 0;
@@ -4577,8 +4593,9 @@ static void superres_post_encode(AV1_COMP *cpi) {
           "Failed to reallocate scaled source buffer for superres");
     assert(cpi->scaled_source.y_crop_width == cm->superres_upscaled_width);
     assert(cpi->scaled_source.y_crop_height == cm->superres_upscaled_height);
-    av1_resize_and_extend_frame(cpi->unscaled_source, &cpi->scaled_source,
-                                (int)cm->seq_params.bit_depth, num_planes);
+    av1_resize_and_extend_frame_mt(cpi->unscaled_source, &cpi->scaled_source,
+                                   (int)cm->seq_params.bit_depth, num_planes,
+                                   cpi->workers, cpi->num_workers);
     cpi->source = &cpi->scaled_source;
   }
 }
@@ -6284,9 +6301,11 @@ int av1_receive_raw_frame(AV1_COMP *cpi, aom_enc_frame_flags_t frame_flags,
       res = -1;
 #endif  //  CONFIG_DENOISE
 
+  if (av1_block_hints_scene_cut(cpi)) frame_flags |= AOM_EFLAG_FORCE_KF;
   if (av1_lookahead_push(cpi->lookahead, sd, time_stamp, end_time,
                          use_highbitdepth, frame_flags))
     res = -1;
+  av1_block_hints_receive_frame(cpi, time_stamp);
 #if CONFIG_INTERNAL_STATS
   aom_usec_timer_mark(&timer);
   cpi->time_receive_data += aom_usec_timer_elapsed(&timer);
@@ -6328,6 +6347,51 @@ static void adjust_image_stat(double y, double u, double v, double all,
   s->worst = AOMMIN(s->worst, all);
 }
 
+// Inputs and results of a frame metric computed by an encoder worker.
+typedef struct {
+  const YV12_BUFFER_CONFIG *orig;
+  const YV12_BUFFER_CONFIG *recon;
+  uint32_t bit_depth;
+  uint32_t in_bit_depth;
+  double y;
+  double u;
+  double v;
+  double all;
+} FrameMetricData;
+
+static int calc_fastssim_hook(void *arg1, void *unused) {
+  FrameMetricData *const data = (FrameMetricData *)arg1;
+  (void)unused;
+  data->all = aom_calc_fastssim(data->orig, data->recon, &data->y, &data->u,
+                                &data->v, data->bit_depth, data->in_bit_depth);
+  return 1;
+}
+
+static int calc_psnrhvs_hook(void *arg1, void *unused) {
+  FrameMetricData *const data = (FrameMetricData *)arg1;
+  (void)unused;
+  data->all = aom_psnrhvs(data->orig, data->recon, &data->y, &data->u,
+                          &data->v, data->bit_depth, data->in_bit_depth);
+  return 1;
+}
+
+// Runs hook on the encoder worker i if it exists, and returns that worker.
+// Otherwise computes the metric on the calling thread and returns NULL.
+static AVxWorker *launch_metric_worker(AV1_COMP *cpi, int i,
+                                       AVxWorkerHook hook,
+                                       FrameMetricData *data) {
+  if (i >= cpi->num_workers) {
+    hook(data, NULL);
+    return NULL;
+  }
+  AVxWorker *const worker = &cpi->workers[i];
+  worker->hook = hook;
+  worker->data1 = data;
+  worker->data2 = NULL;
+  aom_get_worker_interface()->launch(worker);
+  return worker;
+}
+
 static void compute_internal_stats(AV1_COMP *cpi, int frame_bytes) {
   AV1_COMMON *const cm = &cpi->common;
   double samples = 0.0;
@@ -6346,7 +6410,20 @@ static void compute_internal_stats(AV1_COMP *cpi, int frame_bytes) {
   if (cm->show_frame) {
     const YV12_BUFFER_CONFIG *orig = cpi->source;
     const YV12_BUFFER_CONFIG *recon = &cpi->common.cur_frame->buf;
-    double y, u, v, frame_all;
+    FrameMetricData fastssim;
+    memset(&fastssim, 0, sizeof(fastssim));
+    fastssim.orig = orig;
+    fastssim.recon = recon;
+    fastssim.bit_depth = bit_depth;
+    fastssim.in_bit_depth = in_bit_depth;
+    FrameMetricData psnrhvs = fastssim;
+
+    // The frame has been encoded, so the encoder threads are idle. The
+    // slowest metrics run on them while the others are computed here.
+    AVxWorker *const fastssim_worker =
+        launch_metric_worker(cpi, 1, calc_fastssim_hook, &fastssim);
+    AVxWorker *const psnrhvs_worker =
+        launch_metric_worker(cpi, 2, calc_psnrhvs_hook, &psnrhvs);
 
     cpi->count++;
     if (cpi->b_calculate_psnr) {
@@ -6418,11 +6495,13 @@ static void compute_internal_stats(AV1_COMP *cpi, int frame_bytes) {
       }
     }
 
-    frame_all =
-        aom_calc_fastssim(orig, recon, &y, &u, &v, bit_depth, in_bit_depth);
-    adjust_image_stat(y, u, v, frame_all, &cpi->fastssim);
-    frame_all = aom_psnrhvs(orig, recon, &y, &u, &v, bit_depth, in_bit_depth);
-    adjust_image_stat(y, u, v, frame_all, &cpi->psnrhvs);
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    if (fastssim_worker) winterface->sync(fastssim_worker);
+    if (psnrhvs_worker) winterface->sync(psnrhvs_worker);
+    adjust_image_stat(fastssim.y, fastssim.u, fastssim.v, fastssim.all,
+                      &cpi->fastssim);
+    adjust_image_stat(psnrhvs.y, psnrhvs.u, psnrhvs.v, psnrhvs.all,
+                      &cpi->psnrhvs);
   }
 }
 #endif  // CONFIG_INTERNAL_STATS
@@ -6468,6 +6547,8 @@ int av1_get_compressed_data(AV1_COMP *cpi, unsigned int *frame_flags,
 
   if (assign_cur_frame_new_fb(cm) == NULL) return AOM_CODEC_ERROR;
 
+  if (av1_time_budget_enabled(cpi)) av1_time_budget_start_frame(cpi);
+
   const int result =
       av1_encode_strategy(cpi, size, dest, frame_flags, time_stamp, time_end,
                           timestamp_ratio, flush);
@@ -6481,6 +6562,9 @@ int av1_get_compressed_data(AV1_COMP *cpi, unsigned int *frame_flags,
   aom_usec_timer_mark(&cmptimer);
   cpi->time_compress_data += aom_usec_timer_elapsed(&cmptimer);
 #endif  // CONFIG_INTERNAL_STATS
+  if (av1_time_budget_enabled(cpi) && !cm->show_existing_frame) {
+    av1_time_budget_end_frame(cpi);
+  }
   if (cpi->b_calculate_psnr) {
     if (cm->show_existing_frame || (oxcf->pass != 1 && cm->show_frame)) {
       generate_psnr_packet(cpi);
@@ -6504,6 +6588,8 @@ int av1_get_compressed_data(AV1_COMP *cpi, unsigned int *frame_flags,
   if (cpi->oxcf.pass != 1 && !cm->show_existing_frame) {
     cpi->tx_search_count += cpi->td.mb.tx_search_count;
     cpi->td.mb.tx_search_count = 0;
+    cpi->tx_rd_cache_lookups += cpi->td.mb.tx_rd_cache_lookups;
+    cpi->tx_rd_cache_hits += cpi->td.mb.tx_rd_cache_hits;
   }
 #endif  // CONFIG_SPEED_STATS
 
@@ -36,6 +36,7 @@
 #include "av1/encoder/lookahead.h"
 #include "av1/encoder/mbgraph.h"
 #include "av1/encoder/mcomp.h"
+#include "av1/encoder/ml.h"
 #include "av1/encoder/ratectrl.h"
 #include "av1/encoder/rd.h"
 #include "av1/encoder/speed_features.h"
@@ -51,6 +52,7 @@
 #include "aom_dsp/noise_model.h"
 #endif
 #include "aom/internal/aom_codec_internal.h"
+#include "aom_ports/aom_timer.h"
 #include "aom_util/aom_thread.h"
 
 #ifdef __cplusplus
@@ -172,6 +174,8 @@ typedef struct TplDepStats {
   int64_t mc_dep_dist;
   int_mv mv;
   int ref_frame_index;
+  // The best motion vector found for each reference frame, or INVALID_MV.
+  int_mv ref_mvs[INTER_REFS_PER_FRAME];
 #if !USE_TPL_CLASSIC_MODEL
   int64_t mc_count;
   int64_t mc_saved;
@@ -428,6 +432,8 @@ typedef struct AV1EncoderConfig {
   unsigned int tier_mask;
   // min_cr / 100 is the target minimum compression ratio for each frame.
   unsigned int min_cr;
+  // Wall-clock time budget of each frame in microseconds, 0 if unlimited.
+  unsigned int frame_time_budget;
   const cfg_options_t *encoder_cfg;
 } AV1EncoderConfig;
 
@@ -619,6 +625,7 @@ typedef struct ThreadData {
   FRAME_COUNTS *counts;
   PC_TREE *pc_tree;
   PC_TREE *pc_root[MAX_MIB_SIZE_LOG2 - MIN_MIB_SIZE_LOG2 + 1];
+  PC_TREE_ARENA pc_tree_arena;
   tran_low_t *tree_coeff_buf[MAX_MB_PLANE];
   tran_low_t *tree_qcoeff_buf[MAX_MB_PLANE];
   tran_low_t *tree_dqcoeff_buf[MAX_MB_PLANE];
@@ -636,6 +643,7 @@ typedef struct ThreadData {
   int deltaq_used;
   FRAME_CONTEXT *tctx;
   MB_MODE_INFO_EXT *mbmi_ext;
+  TX_RD_CACHE tx_rd_cache;
 } ThreadData;
 
 struct EncWorkerData;
@@ -667,6 +675,49 @@ typedef struct {
   YV12_BUFFER_CONFIG buf;
 } EncRefCntBuffer;
 
+// State of the frame time budget, see time_budget.h.
+typedef struct {
+  // How much the speed features are tightened on top of those of the speed
+  // setting, from 0 to TIME_BUDGET_MAX_LEVEL.
+  int level;
+  // Number of consecutive frames coded well within the budget.
+  int num_frames_under_budget;
+  // Set when the level was raised in the middle of the current frame.
+  int raised_mid_frame;
+  // Set while a single thread codes the superblock rows of the frame, so the
+  // level may be raised between them.
+  int check_rows;
+  // Progress through the superblocks since the last check point.
+  int num_sbs;
+  int num_sbs_done;
+  int64_t check_point_time;
+  struct aom_usec_timer timer;
+  aom_time_budget_stats_t stats;
+} TIME_BUDGET;
+
+// A copy of the block and analysis hints of a source frame, see
+// block_hints.h.
+typedef struct BlockHintsFrame {
+  int64_t ts;
+  aom_block_hint_map_t map;
+  aom_analysis_hints_t analysis;
+  // Size of the source frame the analysis describes.
+  int analysis_width;
+  int analysis_height;
+  struct BlockHintsFrame *next;
+} BlockHintsFrame;
+
+typedef struct {
+  // Hints set for the next frame received.
+  BlockHintsFrame *pending;
+  // Hints of the frames received and not yet shown, in display order.
+  BlockHintsFrame *frames;
+  // Block hints of the frame being coded, or NULL.
+  const aom_block_hint_map_t *cur;
+  // Hints of the frame being coded if it has an analysis, or NULL.
+  const BlockHintsFrame *cur_analysis;
+} BLOCK_HINTS;
+
 #if CONFIG_COLLECT_PARTITION_STATS == 2
 typedef struct PartitionStats {
   int partition_decisions[6][EXT_PARTITION_TYPES];
@@ -678,7 +729,6 @@ typedef struct PartitionStats {
 #endif
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
-#include "aom_ports/aom_timer.h"
 // Adjust the following to add new components.
 enum {
   encode_frame_to_data_rate_time,
@@ -932,8 +982,18 @@ typedef struct AV1_COMP {
   int b_calculate_psnr;
 #if CONFIG_SPEED_STATS
   unsigned int tx_search_count;
+  unsigned int tx_rd_cache_lookups;
+  unsigned int tx_rd_cache_hits;
 #endif  // CONFIG_SPEED_STATS
 
+  // Transform RD search results shared by the threads, which only read it
+  // while a frame is encoded.
+  TX_RD_CACHE tx_rd_cache;
+
+  TIME_BUDGET time_budget;
+
+  BLOCK_HINTS block_hints;
+
   int droppable;
 
   FRAME_INFO frame_info;
@@ -1103,6 +1163,11 @@ typedef struct AV1_COMP {
   double *tpl_sb_rdmult_scaling_factors;
   double *ssim_rdmult_scaling_factors;
 
+  // Fixed-point copies of the simple motion search partition models, indexed
+  // like their float versions. See sf.quantized_nn_models.
+  NN_CONFIG_Q sms_split_nn_q[5];
+  NN_CONFIG_Q sms_prune_rect_nn_q[5];
+
   int use_svc;
   SVC svc;
 } AV1_COMP;
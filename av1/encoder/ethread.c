@@ -14,6 +14,7 @@
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/ethread.h"
 #include "av1/encoder/rdopt.h"
+#include "av1/encoder/tx_rd_cache.h"
 #include "aom_dsp/aom_dsp_common.h"
 
 static AOM_INLINE void accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
@@ -547,6 +548,9 @@ static AOM_INLINE void accumulate_counters_enc_workers(AV1_COMP *cpi,
       cpi->td.mb.txb_split_count += thread_data->td->mb.txb_split_count;
 #if CONFIG_SPEED_STATS
       cpi->td.mb.tx_search_count += thread_data->td->mb.tx_search_count;
+      cpi->td.mb.tx_rd_cache_lookups +=
+          thread_data->td->mb.tx_rd_cache_lookups;
+      cpi->td.mb.tx_rd_cache_hits += thread_data->td->mb.tx_rd_cache_hits;
 #endif  // CONFIG_SPEED_STATS
     }
   }
@@ -574,6 +578,7 @@ static AOM_INLINE void prepare_enc_workers(AV1_COMP *cpi, AVxWorkerHook hook,
       thread_data->td->mb.wsrc_buf = thread_data->td->wsrc_buf;
 
       thread_data->td->mb.inter_modes_info = thread_data->td->inter_modes_info;
+      thread_data->td->mb.pc_tree_arena = &thread_data->td->pc_tree_arena;
       for (int x = 0; x < 2; x++) {
         for (int y = 0; y < 2; y++) {
           memcpy(thread_data->td->hash_value_buffer[x][y],
@@ -587,6 +592,7 @@ static AOM_INLINE void prepare_enc_workers(AV1_COMP *cpi, AVxWorkerHook hook,
       thread_data->td->mb.mask_buf = thread_data->td->mask_buf;
       thread_data->td->mb.mbmi_ext = thread_data->td->mbmi_ext;
     }
+    av1_tx_rd_cache_setup_thread(cpi, thread_data->td);
     if (thread_data->td->counts != &cpi->counts) {
       memcpy(thread_data->td->counts, &cpi->counts, sizeof(cpi->counts));
     }
@@ -31,6 +31,7 @@
 #include "av1/encoder/aq_variance.h"
 #include "av1/encoder/av1_quantize.h"
 #include "av1/encoder/block.h"
+#include "av1/encoder/block_hints.h"
 #include "av1/encoder/dwt.h"
 #include "av1/encoder/encodeframe.h"
 #include "av1/encoder/encodemb.h"
@@ -332,7 +333,7 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
   TileInfo tile;
   struct macroblock_plane *const p = x->plane;
   struct macroblockd_plane *const pd = xd->plane;
-  const PICK_MODE_CONTEXT *ctx =
+  PICK_MODE_CONTEXT *ctx =
       &cpi->td.pc_root[MAX_MIB_SIZE_LOG2 - MIN_MIB_SIZE_LOG2]->none;
   int i;
 
@@ -422,6 +423,8 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
   xd->cfl.store_y = 0;
   av1_frame_init_quantizer(cpi);
 
+  av1_reset_pc_tree_arena(&cpi->td.pc_tree_arena);
+  av1_setup_mode_context(&cpi->td.pc_tree_arena, ctx);
   for (i = 0; i < num_planes; ++i) {
     p[i].coeff = ctx->coeff[i];
     p[i].qcoeff = ctx->qcoeff[i];
@@ -599,19 +602,27 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
 #endif
         // TODO(pengchong): Replace the hard-coded threshold
         if (raw_motion_error > 25) {
-          // Test last reference frame using the previous best mv as the
-          // starting point (best reference) for the search.
-          first_pass_motion_search(cpi, x, &best_ref_mv, &mv, &motion_error);
-
-          // If the current best reference mv is not centered on 0,0 then do a
-          // 0,0 based search as well.
-          if (!is_zero_mv(&best_ref_mv)) {
-            tmp_err = INT_MAX;
-            first_pass_motion_search(cpi, x, &kZeroMv, &tmp_mv, &tmp_err);
-
-            if (tmp_err < motion_error) {
-              motion_error = tmp_err;
-              mv = tmp_mv;
+          MV analysis_mv;
+          if (av1_get_analysis_mv(cpi, bsize, mb_row * mb_scale,
+                                  mb_col * mb_scale, 1, &analysis_mv)) {
+            // The analysis of the source already found the motion to the
+            // previous frame: refine it alone.
+            first_pass_motion_search(cpi, x, &analysis_mv, &mv, &motion_error);
+          } else {
+            // Test last reference frame using the previous best mv as the
+            // starting point (best reference) for the search.
+            first_pass_motion_search(cpi, x, &best_ref_mv, &mv, &motion_error);
+
+            // If the current best reference mv is not centered on 0,0 then do
+            // a 0,0 based search as well.
+            if (!is_zero_mv(&best_ref_mv)) {
+              tmp_err = INT_MAX;
+              first_pass_motion_search(cpi, x, &kZeroMv, &tmp_mv, &tmp_err);
+
+              if (tmp_err < motion_error) {
+                motion_error = tmp_err;
+                mv = tmp_mv;
+              }
             }
           }
 
@@ -1390,6 +1390,32 @@ static int pattern_search(
   return bestsad;
 }
 
+int av1_get_mvpred_sad(const MACROBLOCK *x, const MV *best_mv,
+                       const MV *center_mv, const aom_variance_fn_ptr_t *vfp,
+                       int sad_per_bit) {
+  const MACROBLOCKD *const xd = &x->e_mbd;
+  const struct buf_2d *const what = &x->plane[0].src;
+  const struct buf_2d *const in_what = &xd->plane[0].pre[0];
+  const MV fcenter_mv = { center_mv->row >> 3, center_mv->col >> 3 };
+
+  return vfp->sdf(what->buf, what->stride, get_buf_from_mv(in_what, best_mv),
+                  in_what->stride) +
+         mvsad_err_cost(x, best_mv, &fcenter_mv, sad_per_bit);
+}
+
+int av1_choose_start_mv(const MACROBLOCK *x, const aom_variance_fn_ptr_t *vfp,
+                        const MV *center_mv, int sad_per_bit,
+                        const MV *cand_mv_full, MV *mvp_full) {
+  if (cand_mv_full->row == mvp_full->row && cand_mv_full->col == mvp_full->col)
+    return 0;
+  if (av1_get_mvpred_sad(x, cand_mv_full, center_mv, vfp, sad_per_bit) <
+      av1_get_mvpred_sad(x, mvp_full, center_mv, vfp, sad_per_bit)) {
+    *mvp_full = *cand_mv_full;
+    return 1;
+  }
+  return 0;
+}
+
 int av1_get_mvpred_var(const MACROBLOCK *x, const MV *best_mv,
                        const MV *center_mv, const aom_variance_fn_ptr_t *vfp,
                        int use_mvcost) {
@@ -63,6 +63,18 @@ void av1_set_mv_search_range(MvLimits *mv_limits, const MV *mv);
 int av1_mv_bit_cost(const MV *mv, const MV *ref, const int *mvjcost,
                     int *mvcost[2], int weight);
 
+// Utility to compute SAD + MV rate cost for a given full-pixel MV, as the
+// full-pixel searches measure it
+int av1_get_mvpred_sad(const MACROBLOCK *x, const MV *best_mv,
+                       const MV *center_mv, const aom_variance_fn_ptr_t *vfp,
+                       int sad_per_bit);
+
+// Replaces the full-pixel start point of the motion search by the candidate
+// when the latter has a lower SAD plus mv cost. Returns 1 if it did.
+int av1_choose_start_mv(const MACROBLOCK *x, const aom_variance_fn_ptr_t *vfp,
+                        const MV *center_mv, int sad_per_bit,
+                        const MV *cand_mv_full, MV *mvp_full);
+
 // Utility to compute variance + MV rate cost for a given MV
 int av1_get_mvpred_var(const MACROBLOCK *x, const MV *best_mv,
                        const MV *center_mv, const aom_variance_fn_ptr_t *vfp,
@@ -11,8 +11,11 @@
 
 #include <assert.h>
 #include <math.h>
+#include <string.h>
 
 #include "aom_dsp/aom_dsp_common.h"
+#include "aom_mem/aom_mem.h"
+#include "aom_ports/mem.h"
 #include "av1/encoder/ml.h"
 
 void av1_nn_output_prec_reduce(float *const output, int num_output) {
@@ -68,6 +71,131 @@ void av1_nn_predict_c(const float *input_nodes,
   if (reduce_prec) av1_nn_output_prec_reduce(output, nn_config->num_outputs);
 }
 
+// Evaluates the network on num_samples feature vectors at once. Sample i is
+// read from input_nodes + i * input_stride and its outputs are written to
+// output + i * output_stride. The SIMD versions process several samples per
+// pass over the weights and match the C version exactly.
+void av1_nn_predict_batch_c(const float *input_nodes, int input_stride,
+                            int num_samples, const NN_CONFIG *const nn_config,
+                            int reduce_prec, float *output, int output_stride) {
+  for (int i = 0; i < num_samples; ++i) {
+    av1_nn_predict_c(input_nodes + i * input_stride, nn_config, reduce_prec,
+                     output + i * output_stride);
+  }
+}
+
+void av1_nn_free_quantized_config(NN_CONFIG_Q *nn_config_q) {
+  for (int layer = 0; layer <= NN_MAX_HIDDEN_LAYERS; ++layer) {
+    aom_free(nn_config_q->weights[layer]);
+    aom_free(nn_config_q->dequant[layer]);
+  }
+  memset(nn_config_q, 0, sizeof(*nn_config_q));
+}
+
+int av1_nn_quantize_config(const NN_CONFIG *nn_config,
+                           NN_CONFIG_Q *nn_config_q) {
+  const int num_layers = nn_config->num_hidden_layers;
+  const float weight_max = (float)((1 << NN_Q_WEIGHT_BITS) - 1);
+  assert(num_layers <= NN_MAX_HIDDEN_LAYERS);
+  memset(nn_config_q, 0, sizeof(*nn_config_q));
+  nn_config_q->num_inputs = nn_config->num_inputs;
+  nn_config_q->num_outputs = nn_config->num_outputs;
+  nn_config_q->num_hidden_layers = num_layers;
+
+  int num_inputs = nn_config->num_inputs;
+  for (int layer = 0; layer <= num_layers; ++layer) {
+    const int num_nodes = layer < num_layers
+                              ? nn_config->num_hidden_nodes[layer]
+                              : nn_config->num_outputs;
+    const int stride = (num_inputs + NN_Q_ALIGN - 1) & ~(NN_Q_ALIGN - 1);
+    const float *layer_weights = nn_config->weights[layer];
+    assert(num_nodes <= NN_MAX_NODES_PER_LAYER);
+    if (stride > NN_Q_MAX_STRIDE) {
+      av1_nn_free_quantized_config(nn_config_q);
+      return 0;
+    }
+    if (layer < num_layers) nn_config_q->num_hidden_nodes[layer] = num_nodes;
+    nn_config_q->stride[layer] = stride;
+    nn_config_q->bias[layer] = nn_config->bias[layer];
+    nn_config_q->weights[layer] = (int16_t *)aom_calloc(
+        num_nodes * stride, sizeof(*nn_config_q->weights[layer]));
+    nn_config_q->dequant[layer] = (float *)aom_malloc(
+        num_nodes * sizeof(*nn_config_q->dequant[layer]));
+    if (!nn_config_q->weights[layer] || !nn_config_q->dequant[layer]) {
+      av1_nn_free_quantized_config(nn_config_q);
+      return 0;
+    }
+    for (int node = 0; node < num_nodes; ++node) {
+      const float *w = layer_weights + node * num_inputs;
+      int16_t *qw = nn_config_q->weights[layer] + node * stride;
+      float max_abs = 0.0f;
+      for (int i = 0; i < num_inputs; ++i)
+        max_abs = AOMMAX(max_abs, fabsf(w[i]));
+      const float scale = max_abs > 0.0f ? weight_max / max_abs : 0.0f;
+      for (int i = 0; i < num_inputs; ++i)
+        qw[i] = (int16_t)av1_nn_round_to_int(w[i] * scale);
+      nn_config_q->dequant[layer][node] = max_abs / weight_max;
+    }
+    num_inputs = num_nodes;
+  }
+  return 1;
+}
+
+// Scales the n values of input to NN_Q_INPUT_BITS-bit integers and pads the
+// output with zeros to stride entries. Returns the factor that maps the
+// integers back to the input range.
+static float nn_quantize_input(const float *input, int n, int stride,
+                               int16_t *output) {
+  const float input_max = (float)((1 << NN_Q_INPUT_BITS) - 1);
+  float max_abs = 0.0f;
+  for (int i = 0; i < n; ++i) max_abs = AOMMAX(max_abs, fabsf(input[i]));
+  memset(output + n, 0, sizeof(*output) * (stride - n));
+  if (max_abs == 0.0f) {
+    memset(output, 0, sizeof(*output) * n);
+    return 0.0f;
+  }
+  const float scale = input_max / max_abs;
+  for (int i = 0; i < n; ++i)
+    output[i] = (int16_t)av1_nn_round_to_int(input[i] * scale);
+  return max_abs / input_max;
+}
+
+void av1_nn_predict_quantized_c(const float *input_nodes,
+                                const NN_CONFIG_Q *const nn_config_q,
+                                int reduce_prec, float *const output) {
+  DECLARE_ALIGNED(32, int16_t, qinput[NN_Q_MAX_STRIDE]);
+  float buf[NN_MAX_NODES_PER_LAYER];
+  const int num_layers = nn_config_q->num_hidden_layers;
+  int num_inputs = nn_config_q->num_inputs;
+
+  for (int layer = 0; layer <= num_layers; ++layer) {
+    const int is_output_layer = layer == num_layers;
+    const int num_nodes = is_output_layer
+                              ? nn_config_q->num_outputs
+                              : nn_config_q->num_hidden_nodes[layer];
+    const int stride = nn_config_q->stride[layer];
+    const int16_t *weights = nn_config_q->weights[layer];
+    const float *dequant = nn_config_q->dequant[layer];
+    const float *bias = nn_config_q->bias[layer];
+    float *const output_nodes = is_output_layer ? output : buf;
+    const float input_dequant =
+        nn_quantize_input(input_nodes, num_inputs, stride, qinput);
+    for (int node = 0; node < num_nodes; ++node) {
+      int32_t acc = 0;
+      for (int i = 0; i < stride; ++i) acc += qinput[i] * weights[i];
+      weights += stride;
+      float val = acc * (dequant[node] * input_dequant) + bias[node];
+      // ReLU as activation function of the hidden layers.
+      if (!is_output_layer) val = AOMMAX(val, 0.0f);
+      output_nodes[node] = val;
+    }
+    input_nodes = buf;
+    num_inputs = num_nodes;
+  }
+  if (reduce_prec)
+    av1_nn_output_prec_reduce(output, nn_config_q->num_outputs);
+}
+
 #if CONFIG_NN_V2
 // Applies the ReLu activation to one fc layer
 // output[i] = Max(input[i],0.0f)
@@ -18,6 +18,8 @@ extern "C" {
 
 #include "config/av1_rtcd.h"
 
+#include "aom/aom_integer.h"
+
 #define NN_MAX_HIDDEN_LAYERS 10
 #define NN_MAX_NODES_PER_LAYER 128
 
@@ -34,6 +36,50 @@ struct NN_CONFIG {
 };
 // Typedef from struct NN_CONFIG to NN_CONFIG is in rtcd_defs
 
+// Number of bits of the quantized weights and layer inputs of NN_CONFIG_Q,
+// excluding the sign bit.
+#define NN_Q_WEIGHT_BITS 7
+#define NN_Q_INPUT_BITS 15
+// The rows of the quantized weights are padded with zeros to a multiple of
+// NN_Q_ALIGN entries.
+#define NN_Q_ALIGN 16
+
+// Maximum padded number of inputs of a quantized layer. With this many inputs
+// the 32-bit accumulators of the integer dot products cannot overflow.
+#define NN_Q_MAX_STRIDE 256
+
+// Fixed-point version of an NN_CONFIG, built by av1_nn_quantize_config().
+// The weights of each node are scaled to 8-bit precision. The layer inputs are
+// scaled to 16 bits when the model is evaluated, so that each layer is an
+// exact integer matrix-vector product followed by a per-node float rescale.
+struct NN_CONFIG_Q {
+  int num_inputs;
+  int num_outputs;
+  int num_hidden_layers;
+  int num_hidden_nodes[NN_MAX_HIDDEN_LAYERS];
+  // Quantized weights, indexed by layer. Each node has stride[layer] entries.
+  int16_t *weights[NN_MAX_HIDDEN_LAYERS + 1];
+  int stride[NN_MAX_HIDDEN_LAYERS + 1];
+  // Per-node factors mapping quantized weights back to floats.
+  float *dequant[NN_MAX_HIDDEN_LAYERS + 1];
+  // Bias parameters, shared with the float model.
+  const float *bias[NN_MAX_HIDDEN_LAYERS + 1];
+};
+// Typedef from struct NN_CONFIG_Q to NN_CONFIG_Q is in rtcd_defs
+
+// Quantizes the weights of nn_config into nn_config_q. Returns 0 on memory
+// allocation failure. The result must be released with
+// av1_nn_free_quantized_config().
+int av1_nn_quantize_config(const NN_CONFIG *nn_config,
+                           NN_CONFIG_Q *nn_config_q);
+void av1_nn_free_quantized_config(NN_CONFIG_Q *nn_config_q);
+
+// Rounds to the nearest integer, with ties away from zero, the way the SIMD
+// versions of av1_nn_predict_quantized() do.
+static INLINE int av1_nn_round_to_int(float v) {
+  return (int)(v + (v >= 0.0f ? 0.5f : -0.5f));
+}
+
 #if CONFIG_NN_V2
 // Fully-connectedly layer configuration
 struct FC_LAYER {
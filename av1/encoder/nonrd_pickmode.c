@@ -30,6 +30,7 @@
 #include "av1/common/reconinter.h"
 #include "av1/common/reconintra.h"
 
+#include "av1/encoder/block_hints.h"
 #include "av1/encoder/encodemv.h"
 #include "av1/encoder/rdopt.h"
 #include "av1/encoder/reconinter_enc.h"
@@ -154,6 +155,21 @@ static int combined_motion_search(AV1_COMP *cpi, MACROBLOCK *x,
   mvp_full.col >>= 3;
   mvp_full.row >>= 3;
 
+  // Start from the analysis motion vector, extrapolated to the reference,
+  // when it is the better start.
+  MV analysis_mv;
+  if (!scaled_ref_frame &&
+      av1_get_analysis_ref_mv(cpi, bsize, mi_row, mi_col, ref, &analysis_mv)) {
+    MV analysis_mv_full = { analysis_mv.row >> 3, analysis_mv.col >> 3 };
+    clamp_mv(&analysis_mv_full, x->mv_limits.col_min, x->mv_limits.col_max,
+             x->mv_limits.row_min, x->mv_limits.row_max);
+    clamp_mv(&mvp_full, x->mv_limits.col_min, x->mv_limits.col_max,
+             x->mv_limits.row_min, x->mv_limits.row_max);
+    if (av1_choose_start_mv(x, &cpi->fn_ptr[bsize], &ref_mv, sadpb,
+                            &analysis_mv_full, &mvp_full))
+      step_param = AOMMAX(step_param, MAX_MVSEARCH_STEPS - 4);
+  }
+
   if (!use_base_mv)
     center_mv = ref_mv;
   else
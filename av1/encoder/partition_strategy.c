@@ -243,6 +243,29 @@ void av1_intra_mode_cnn_partition(const AV1_COMMON *const cm, MACROBLOCK *x,
   }
 }
 
+int av1_quantize_partition_nn_models(AV1_COMP *const cpi) {
+  for (int i = 0; i < 5; ++i) {
+    const NN_CONFIG *const split_config =
+        av1_simple_motion_search_split_nn_config[i];
+    const NN_CONFIG *const prune_rect_config =
+        av1_simple_motion_search_prune_rect_nn_config[i];
+    if (!av1_nn_quantize_config(split_config, &cpi->sms_split_nn_q[i]))
+      return 0;
+    if (prune_rect_config &&
+        !av1_nn_quantize_config(prune_rect_config,
+                                &cpi->sms_prune_rect_nn_q[i]))
+      return 0;
+  }
+  return 1;
+}
+
+void av1_free_partition_nn_models(AV1_COMP *const cpi) {
+  for (int i = 0; i < 5; ++i) {
+    av1_nn_free_quantized_config(&cpi->sms_split_nn_q[i]);
+    av1_nn_free_quantized_config(&cpi->sms_prune_rect_nn_q[i]);
+  }
+}
+
 void av1_simple_motion_search_based_split(
     AV1_COMP *const cpi, MACROBLOCK *x, PC_TREE *pc_tree, int mi_row,
     int mi_col, BLOCK_SIZE bsize, int *partition_none_allowed,
@@ -281,7 +304,11 @@ void av1_simple_motion_search_based_split(
 
   float score = 0.0f;
 
-  av1_nn_predict(features, nn_config, 1, &score);
+  if (cpi->sf.quantized_nn_models & QUANTIZED_NN_SMS_SPLIT)
+    av1_nn_predict_quantized(features, &cpi->sms_split_nn_q[bsize_idx], 1,
+                             &score);
+  else
+    av1_nn_predict(features, nn_config, 1, &score);
   aom_clear_system_state();
 
   if (score > split_only_thresh) {
@@ -536,7 +563,11 @@ void av1_simple_motion_search_prune_rect(AV1_COMP *const cpi, MACROBLOCK *x,
                               ? PARTITION_TYPES
                               : EXT_PARTITION_TYPES;
 
-  av1_nn_predict(features, nn_config, 1, scores);
+  if (cpi->sf.quantized_nn_models & QUANTIZED_NN_SMS_PRUNE_RECT)
+    av1_nn_predict_quantized(features, &cpi->sms_prune_rect_nn_q[bsize_idx],
+                             1, scores);
+  else
+    av1_nn_predict(features, nn_config, 1, scores);
   aom_clear_system_state();
 
   av1_nn_softmax(scores, probs, num_classes);
@@ -41,6 +41,11 @@ void av1_intra_mode_cnn_partition(const AV1_COMMON *const cm, MACROBLOCK *x,
                                   int *do_rectangular_split,
                                   int *do_square_split);
 
+// Builds the fixed-point copies of the simple motion search models used with
+// sf.quantized_nn_models. Returns 0 on memory allocation failure.
+int av1_quantize_partition_nn_models(AV1_COMP *const cpi);
+void av1_free_partition_nn_models(AV1_COMP *const cpi);
+
 // Performs a simple_motion_search with a single reference frame and extract
 // the variance of residues. Then use the features to determine whether we want
 // to go straight to splitting without trying PARTITION_NONE
@@ -43,6 +43,7 @@
 
 #include "av1/encoder/aq_variance.h"
 #include "av1/encoder/av1_quantize.h"
+#include "av1/encoder/block_hints.h"
 #include "av1/encoder/cost.h"
 #include "av1/encoder/encodemb.h"
 #include "av1/encoder/encodemv.h"
@@ -62,6 +63,7 @@
 #include "av1/encoder/tokenize.h"
 #include "av1/encoder/tpl_model.h"
 #include "av1/encoder/tx_prune_model_weights.h"
+#include "av1/encoder/tx_rd_cache.h"
 
 // Set this macro as 1 to collect data about tx size selection.
 #define COLLECT_TX_SIZE_DATA 0
@@ -4120,10 +4122,9 @@ static INLINE uint32_t get_block_residue_hash(MACROBLOCK *x, BLOCK_SIZE bsize) {
   return (hash << 5) + bsize;
 }
 
-static AOM_INLINE void save_tx_rd_info(int n4, uint32_t hash,
-                                       const MACROBLOCK *const x,
-                                       const RD_STATS *const rd_stats,
-                                       MB_RD_RECORD *tx_rd_record) {
+static AOM_INLINE const MB_RD_INFO *save_tx_rd_info(
+    int n4, uint32_t hash, const MACROBLOCK *const x,
+    const RD_STATS *const rd_stats, MB_RD_RECORD *tx_rd_record) {
   int index;
   if (tx_rd_record->num < RD_RECORD_BUFFER_LEN) {
     index =
@@ -4144,6 +4145,7 @@ static AOM_INLINE void save_tx_rd_info(int n4, uint32_t hash,
   av1_copy(tx_rd_info->inter_tx_size, mbmi->inter_tx_size);
   av1_copy_array(tx_rd_info->tx_type_map, xd->tx_type_map, n4);
   tx_rd_info->rd_stats = *rd_stats;
+  return tx_rd_info;
 }
 
 static AOM_INLINE void fetch_tx_rd_info(int n4,
@@ -4178,6 +4180,52 @@ static INLINE int32_t find_mb_rd_info(const MB_RD_RECORD *const mb_rd_record,
   return match_index;
 }
 
+// Returns the parameters of the transform search, which the results in the
+// frame-persistent cache must match besides the residue hash and rdmult.
+static INLINE uint32_t get_tx_rd_cache_ctx(const AV1_COMMON *cm,
+                                           const MACROBLOCK *x,
+                                           int is_var_tx) {
+  const MACROBLOCKD *const xd = &x->e_mbd;
+  return x->qindex | (xd->lossless[xd->mi[0]->segment_id] << 8) |
+         (x->tx_size_search_method << 9) | (x->tx_mode << 11) |
+         (cm->reduced_tx_set_used << 13) | (is_var_tx << 14);
+}
+
+// Looks up the RD search results of the residue in the records of the current
+// superblock, then in the frame-persistent cache.
+static const MB_RD_INFO *find_tx_rd_info(const AV1_COMP *cpi, MACROBLOCK *x,
+                                         int64_t ref_best_rd, uint32_t hash,
+                                         uint32_t cache_ctx) {
+  const MB_RD_RECORD *const mb_rd_record = &x->mb_rd_record;
+  const int32_t match_index = find_mb_rd_info(mb_rd_record, ref_best_rd, hash);
+  if (match_index != -1) return &mb_rd_record->tx_rd_info[match_index];
+  if (x->tx_rd_cache == NULL || ref_best_rd == INT64_MAX) return NULL;
+  const MB_RD_INFO *const tx_rd_info =
+      av1_tx_rd_cache_find(&cpi->tx_rd_cache, hash, cache_ctx, x->rdmult);
+#if CONFIG_SPEED_STATS
+  ++x->tx_rd_cache_lookups;
+  if (tx_rd_info != NULL) ++x->tx_rd_cache_hits;
+#endif  // CONFIG_SPEED_STATS
+  return tx_rd_info;
+}
+
+// Saves the RD search results into tx_rd_record, and into the table of the
+// thread to be merged into the frame-persistent cache.
+static AOM_INLINE void save_mb_rd_info(const AV1_COMMON *cm, int n4,
+                                       uint32_t hash, uint32_t cache_ctx,
+                                       MACROBLOCK *const x,
+                                       const RD_STATS *const rd_stats) {
+  const MB_RD_INFO *const tx_rd_info =
+      save_tx_rd_info(n4, hash, x, rd_stats, &x->mb_rd_record);
+  if (x->tx_rd_cache != NULL) {
+    const MACROBLOCKD *const xd = &x->e_mbd;
+    const int mi_row = -xd->mb_to_top_edge >> (3 + MI_SIZE_LOG2);
+    const int mi_col = -xd->mb_to_left_edge >> (3 + MI_SIZE_LOG2);
+    av1_tx_rd_cache_save(x->tx_rd_cache, tx_rd_info, cache_ctx, x->rdmult,
+                         mi_row * cm->mi_cols + mi_col);
+  }
+}
+
 static AOM_INLINE void super_block_yrd(const AV1_COMP *const cpi, MACROBLOCK *x,
                                        RD_STATS *rd_stats, BLOCK_SIZE bs,
                                        int64_t ref_best_rd) {
@@ -4190,8 +4238,7 @@ static AOM_INLINE void super_block_yrd(const AV1_COMP *const cpi, MACROBLOCK *x,
   const int mi_col = -xd->mb_to_left_edge >> (3 + MI_SIZE_LOG2);
 
   uint32_t hash = 0;
-  int32_t match_index = -1;
-  MB_RD_RECORD *mb_rd_record = NULL;
+  uint32_t cache_ctx = 0;
   const int within_border = mi_row >= xd->tile.mi_row_start &&
                             (mi_row + mi_size_high[bs] < xd->tile.mi_row_end) &&
                             mi_col >= xd->tile.mi_col_start &&
@@ -4201,10 +4248,10 @@ static AOM_INLINE void super_block_yrd(const AV1_COMP *const cpi, MACROBLOCK *x,
   const int n4 = bsize_to_num_blk(bs);
   if (is_mb_rd_hash_enabled) {
     hash = get_block_residue_hash(x, bs);
-    mb_rd_record = &x->mb_rd_record;
-    match_index = find_mb_rd_info(mb_rd_record, ref_best_rd, hash);
-    if (match_index != -1) {
-      MB_RD_INFO *tx_rd_info = &mb_rd_record->tx_rd_info[match_index];
+    cache_ctx = get_tx_rd_cache_ctx(&cpi->common, x, 0);
+    const MB_RD_INFO *tx_rd_info =
+        find_tx_rd_info(cpi, x, ref_best_rd, hash, cache_ctx);
+    if (tx_rd_info != NULL) {
       fetch_tx_rd_info(n4, tx_rd_info, rd_stats, x);
       return;
     }
@@ -4221,7 +4268,7 @@ static AOM_INLINE void super_block_yrd(const AV1_COMP *const cpi, MACROBLOCK *x,
     set_skip_flag(x, rd_stats, bs, dist);
     // Save the RD search results into tx_rd_record.
     if (is_mb_rd_hash_enabled)
-      save_tx_rd_info(n4, hash, x, rd_stats, mb_rd_record);
+      save_mb_rd_info(&cpi->common, n4, hash, cache_ctx, x, rd_stats);
     return;
   }
 
@@ -4234,10 +4281,8 @@ static AOM_INLINE void super_block_yrd(const AV1_COMP *const cpi, MACROBLOCK *x,
   }
 
   // Save the RD search results into tx_rd_record.
-  if (is_mb_rd_hash_enabled) {
-    assert(mb_rd_record != NULL);
-    save_tx_rd_info(n4, hash, x, rd_stats, mb_rd_record);
-  }
+  if (is_mb_rd_hash_enabled)
+    save_mb_rd_info(&cpi->common, n4, hash, cache_ctx, x, rd_stats);
 }
 
 // Return the rate cost for luma prediction mode info. of intra blocks.
@@ -5421,6 +5466,65 @@ static int ml_predict_tx_split(MACROBLOCK *x, BLOCK_SIZE bsize, int blk_row,
   return clamp(int_score, -80000, 80000);
 }
 
+// Tx split model scores of the sub-blocks of a transform block. The scores of
+// all the sub-blocks are predicted in one batch, the first time one of them is
+// needed.
+typedef struct {
+  int blk_row;  // Position of the parent transform block.
+  int blk_col;
+  TX_SIZE tx_size;  // Size of the parent transform block.
+  int ready;
+  int scores[4];
+} TxSplitScores;
+
+static int get_ml_tx_split_score(MACROBLOCK *x, BLOCK_SIZE bsize, int blk_row,
+                                 int blk_col, TxSplitScores *split_scores) {
+  const TX_SIZE sub_txs = sub_tx_size_map[split_scores->tx_size];
+  const int bsw = tx_size_wide_unit[sub_txs];
+  const int bsh = tx_size_high_unit[sub_txs];
+  const int num_cols = tx_size_wide_unit[split_scores->tx_size] / bsw;
+  const int idx = ((blk_row - split_scores->blk_row) / bsh) * num_cols +
+                  (blk_col - split_scores->blk_col) / bsw;
+  assert(idx >= 0 && idx < 4);
+  if (split_scores->ready) return split_scores->scores[idx];
+
+  const NN_CONFIG *nn_config = av1_tx_split_nnconfig_map[sub_txs];
+  if (!nn_config) return -1;
+  MACROBLOCKD *const xd = &x->e_mbd;
+  const int max_blocks_high = max_block_high(xd, bsize, 0);
+  const int max_blocks_wide = max_block_wide(xd, bsize, 0);
+  const int diff_stride = block_size_wide[bsize];
+  const int bw = tx_size_wide[sub_txs];
+  const int bh = tx_size_high[sub_txs];
+  float features[4][64];
+  float scores[4];
+  int num_blocks = 0;
+  aom_clear_system_state();
+  memset(features, 0, sizeof(features));
+  for (int r = 0; r < tx_size_high_unit[split_scores->tx_size]; r += bsh) {
+    for (int c = 0; c < tx_size_wide_unit[split_scores->tx_size]; c += bsw) {
+      const int row = split_scores->blk_row + r;
+      const int col = split_scores->blk_col + c;
+      // Sub-blocks outside of the frame are never searched; keep their slots
+      // so that the scores stay indexed by position.
+      if (row < max_blocks_high && col < max_blocks_wide) {
+        const int16_t *diff =
+            x->plane[0].src_diff + 4 * row * diff_stride + 4 * col;
+        get_mean_dev_features(diff, diff_stride, bw, bh, features[num_blocks]);
+      }
+      ++num_blocks;
+    }
+  }
+  av1_nn_predict_batch(features[0], 64, num_blocks, nn_config, 1, scores, 1);
+  aom_clear_system_state();
+
+  for (int i = 0; i < num_blocks; ++i) {
+    split_scores->scores[i] = clamp((int)(scores[i] * 10000), -80000, 80000);
+  }
+  split_scores->ready = 1;
+  return split_scores->scores[idx];
+}
+
 typedef struct {
   int64_t rd;
   int txb_entropy_ctx;
@@ -5493,7 +5597,7 @@ static AOM_INLINE void select_tx_block(
     ENTROPY_CONTEXT *tl, TXFM_CONTEXT *tx_above, TXFM_CONTEXT *tx_left,
     RD_STATS *rd_stats, int64_t prev_level_rd, int64_t ref_best_rd,
     int *is_cost_valid, FAST_TX_SEARCH_MODE ftxs_mode,
-    TXB_RD_INFO_NODE *rd_info_node);
+    TXB_RD_INFO_NODE *rd_info_node, TxSplitScores *split_scores);
 
 static AOM_INLINE void try_tx_block_split(
     const AV1_COMP *cpi, MACROBLOCK *x, int blk_row, int blk_col, int block,
@@ -5517,6 +5621,7 @@ static AOM_INLINE void try_tx_block_split(
   int64_t tmp_rd = 0;
   *split_rd = INT64_MAX;
   split_rd_stats->rate = x->txfm_partition_cost[txfm_partition_ctx][1];
+  TxSplitScores sub_split_scores = { blk_row, blk_col, tx_size, 0, { 0 } };
 
   for (int r = 0; r < tx_size_high_unit[tx_size]; r += bsh) {
     for (int c = 0; c < tx_size_wide_unit[tx_size]; c += bsw, ++blk_idx) {
@@ -5531,7 +5636,8 @@ static AOM_INLINE void try_tx_block_split(
           cpi, x, offsetr, offsetc, block, sub_txs, depth + 1, plane_bsize, ta,
           tl, tx_above, tx_left, &this_rd_stats, no_split_rd / nblks,
           ref_best_rd - tmp_rd, &this_cost_valid, ftxs_mode,
-          (rd_info_node != NULL) ? rd_info_node->children[blk_idx] : NULL);
+          (rd_info_node != NULL) ? rd_info_node->children[blk_idx] : NULL,
+          &sub_split_scores);
       if (!this_cost_valid) return;
       av1_merge_rd_stats(split_rd_stats, &this_rd_stats);
       tmp_rd = RDCOST(x->rdmult, split_rd_stats->rate, split_rd_stats->dist);
@@ -5550,7 +5656,7 @@ static AOM_INLINE void select_tx_block(
     ENTROPY_CONTEXT *tl, TXFM_CONTEXT *tx_above, TXFM_CONTEXT *tx_left,
     RD_STATS *rd_stats, int64_t prev_level_rd, int64_t ref_best_rd,
     int *is_cost_valid, FAST_TX_SEARCH_MODE ftxs_mode,
-    TXB_RD_INFO_NODE *rd_info_node) {
+    TXB_RD_INFO_NODE *rd_info_node, TxSplitScores *split_scores) {
   assert(tx_size < TX_SIZES_ALL);
   av1_init_rd_stats(rd_stats);
   if (ref_best_rd < 0) {
@@ -5608,8 +5714,12 @@ static AOM_INLINE void select_tx_block(
       !(ref_best_rd == INT64_MAX && no_split.rd == INT64_MAX)) {
     const int threshold = cpi->sf.tx_type_search.ml_tx_split_thresh;
     if (threshold >= 0) {
+      // Sub-blocks of a split block share one batched prediction.
       const int split_score =
-          ml_predict_tx_split(x, plane_bsize, blk_row, blk_col, tx_size);
+          split_scores ? get_ml_tx_split_score(x, plane_bsize, blk_row,
+                                               blk_col, split_scores)
+                       : ml_predict_tx_split(x, plane_bsize, blk_row, blk_col,
+                                             tx_size);
       if (split_score < -threshold) try_split = 0;
     }
   }
@@ -5710,7 +5820,7 @@ static int64_t select_tx_size_and_type(const AV1_COMP *cpi, MACROBLOCK *x,
       select_tx_block(cpi, x, idy, idx, block, max_tx_size, init_depth,
                       plane_bsize, ctxa, ctxl, tx_above, tx_left, &pn_rd_stats,
                       INT64_MAX, best_rd_sofar, &is_cost_valid, ftxs_mode,
-                      rd_info_tree);
+                      rd_info_tree, NULL);
       if (!is_cost_valid || pn_rd_stats.rate == INT_MAX) {
         av1_invalid_rd_stats(rd_stats);
         return INT64_MAX;
@@ -6200,8 +6310,7 @@ static AOM_INLINE void pick_tx_size_type_yrd(const AV1_COMP *cpi, MACROBLOCK *x,
   }
 
   uint32_t hash = 0;
-  int32_t match_index = -1;
-  MB_RD_RECORD *mb_rd_record = NULL;
+  uint32_t cache_ctx = 0;
   const int within_border =
       mi_row >= xd->tile.mi_row_start &&
       (mi_row + mi_size_high[bsize] < xd->tile.mi_row_end) &&
@@ -6211,10 +6320,10 @@ static AOM_INLINE void pick_tx_size_type_yrd(const AV1_COMP *cpi, MACROBLOCK *x,
   const int n4 = bsize_to_num_blk(bsize);
   if (is_mb_rd_hash_enabled) {
     hash = get_block_residue_hash(x, bsize);
-    mb_rd_record = &x->mb_rd_record;
-    match_index = find_mb_rd_info(mb_rd_record, ref_best_rd, hash);
-    if (match_index != -1) {
-      MB_RD_INFO *tx_rd_info = &mb_rd_record->tx_rd_info[match_index];
+    cache_ctx = get_tx_rd_cache_ctx(cm, x, 1);
+    const MB_RD_INFO *tx_rd_info =
+        find_tx_rd_info(cpi, x, ref_best_rd, hash, cache_ctx);
+    if (tx_rd_info != NULL) {
       fetch_tx_rd_info(n4, tx_rd_info, rd_stats, x);
       return;
     }
@@ -6228,7 +6337,7 @@ static AOM_INLINE void pick_tx_size_type_yrd(const AV1_COMP *cpi, MACROBLOCK *x,
     set_skip_flag(x, rd_stats, bsize, dist);
     // Save the RD search results into tx_rd_record.
     if (is_mb_rd_hash_enabled)
-      save_tx_rd_info(n4, hash, x, rd_stats, mb_rd_record);
+      save_mb_rd_info(cm, n4, hash, cache_ctx, x, rd_stats);
     return;
   }
 #if CONFIG_SPEED_STATS
@@ -6263,10 +6372,8 @@ static AOM_INLINE void pick_tx_size_type_yrd(const AV1_COMP *cpi, MACROBLOCK *x,
   if (!found) return;
 
   // Save the RD search results into tx_rd_record.
-  if (is_mb_rd_hash_enabled) {
-    assert(mb_rd_record != NULL);
-    save_tx_rd_info(n4, hash, x, rd_stats, mb_rd_record);
-  }
+  if (is_mb_rd_hash_enabled)
+    save_mb_rd_info(cm, n4, hash, cache_ctx, x, rd_stats);
 }
 
 static AOM_INLINE void model_rd_for_sb_with_fullrdy(
@@ -7306,6 +7413,29 @@ static AOM_INLINE void setup_buffer_ref_mvs_inter(
   }
 }
 
+// The largest distance, in full pixels, between the TPL motion vector and the
+// predicted one for the former to be used in the motion search.
+#define TPL_MV_MAX_DIST 4
+
+// Returns the motion vector the TPL model found for the reference frame ref,
+// at the center of the block, or INVALID_MV when there is none.
+static int_mv get_tpl_mv(const AV1_COMMON *const cm, const MACROBLOCK *const x,
+                         BLOCK_SIZE bsize, int mi_row, int mi_col,
+                         MV_REFERENCE_FRAME ref) {
+  int_mv tpl_mv;
+  tpl_mv.as_int = INVALID_MV;
+  if (x->valid_cost_b == 0) return tpl_mv;
+
+  const BLOCK_SIZE tpl_bsize = convert_length_to_bsize(MC_FLOW_BSIZE_1D);
+  const int step = mi_size_wide[tpl_bsize];
+  const int row = AOMMIN(mi_row + mi_size_high[bsize] / 2, cm->mi_rows - 1);
+  const int col = AOMMIN(mi_col + mi_size_wide[bsize] / 2, cm->mi_cols - 1);
+  const int of_h = row % mi_size_high[cm->seq_params.sb_size];
+  const int of_w = col % mi_size_wide[cm->seq_params.sb_size];
+  return x->tpl_mvs_b[of_h / step * x->cost_stride + of_w / step]
+                     [ref - LAST_FRAME];
+}
+
 static AOM_INLINE void single_motion_search(const AV1_COMP *const cpi,
                                             MACROBLOCK *x, BLOCK_SIZE bsize,
                                             int mi_row, int mi_col, int ref_idx,
@@ -7399,6 +7529,66 @@ static AOM_INLINE void single_motion_search(const AV1_COMP *const cpi,
   mvp_full.row >>= 3;
 
   const int sadpb = x->sadperbit16;
+
+  // The TPL model searched the 16x16 blocks of the source frames at the same
+  // resolution. Its motion vectors far from the predicted one, found in flat
+  // or noisy areas, tend to be cheap in SAD but expensive in rate, so only the
+  // close ones are trusted.
+  if (cpi->sf.mv.use_tpl_mvs && mbmi->motion_mode == SIMPLE_TRANSLATION &&
+      ref_idx == 0 && !scaled_ref_frame) {
+    const int_mv tpl_mv = get_tpl_mv(cm, x, bsize, mi_row, mi_col, ref);
+    if (tpl_mv.as_int != INVALID_MV) {
+      MV tpl_mv_full = { tpl_mv.as_mv.row >> 3, tpl_mv.as_mv.col >> 3 };
+      clamp_mv(&tpl_mv_full, x->mv_limits.col_min, x->mv_limits.col_max,
+               x->mv_limits.row_min, x->mv_limits.row_max);
+      clamp_mv(&mvp_full, x->mv_limits.col_min, x->mv_limits.col_max,
+               x->mv_limits.row_min, x->mv_limits.row_max);
+      if (abs(tpl_mv_full.row - mvp_full.row) <= TPL_MV_MAX_DIST &&
+          abs(tpl_mv_full.col - mvp_full.col) <= TPL_MV_MAX_DIST) {
+        av1_choose_start_mv(x, &cpi->fn_ptr[bsize], &ref_mv, sadpb,
+                            &tpl_mv_full, &mvp_full);
+        // Both estimates agree, the motion left to find is small: start with
+        // steps of 8 pixels at most.
+        if (cpi->sf.mv.use_tpl_mvs >= 2)
+          step_param = AOMMAX(step_param, MAX_MVSEARCH_STEPS - 4);
+      }
+    }
+  }
+
+  // The hinted encode of the source found its motion vector at the same place
+  // of the frame. Once scaled, it is at most off by the rounding, so the
+  // search starts with steps of 8 pixels at most.
+  MV hint_mv;
+  if (mbmi->motion_mode == SIMPLE_TRANSLATION && ref_idx == 0 &&
+      !scaled_ref_frame &&
+      av1_get_block_hint_mv(cpi, bsize, mi_row, mi_col, ref, &hint_mv)) {
+    MV hint_mv_full = { hint_mv.row >> 3, hint_mv.col >> 3 };
+    clamp_mv(&hint_mv_full, x->mv_limits.col_min, x->mv_limits.col_max,
+             x->mv_limits.row_min, x->mv_limits.row_max);
+    clamp_mv(&mvp_full, x->mv_limits.col_min, x->mv_limits.col_max,
+             x->mv_limits.row_min, x->mv_limits.row_max);
+    av1_choose_start_mv(x, &cpi->fn_ptr[bsize], &ref_mv, sadpb,
+                        &hint_mv_full, &mvp_full);
+    step_param = AOMMAX(step_param, MAX_MVSEARCH_STEPS - 4);
+  }
+
+  // The analysis motion vectors describe the 16x16 blocks of the source and
+  // are extrapolated to the distance of the reference. They may not fit the
+  // block, so the range only narrows when they make the better start.
+  MV analysis_mv;
+  if (mbmi->motion_mode == SIMPLE_TRANSLATION && ref_idx == 0 &&
+      !scaled_ref_frame &&
+      av1_get_analysis_ref_mv(cpi, bsize, mi_row, mi_col, ref, &analysis_mv)) {
+    MV analysis_mv_full = { analysis_mv.row >> 3, analysis_mv.col >> 3 };
+    clamp_mv(&analysis_mv_full, x->mv_limits.col_min, x->mv_limits.col_max,
+             x->mv_limits.row_min, x->mv_limits.row_max);
+    clamp_mv(&mvp_full, x->mv_limits.col_min, x->mv_limits.col_max,
+             x->mv_limits.row_min, x->mv_limits.row_max);
+    if (av1_choose_start_mv(x, &cpi->fn_ptr[bsize], &ref_mv, sadpb,
+                            &analysis_mv_full, &mvp_full))
+      step_param = AOMMAX(step_param, MAX_MVSEARCH_STEPS - 4);
+  }
+
   int cost_list[5];
   x->best_mv.as_int = x->second_best_mv.as_int = INVALID_MV;
   switch (mbmi->motion_mode) {
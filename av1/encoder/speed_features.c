@@ -16,6 +16,7 @@
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/speed_features.h"
 #include "av1/encoder/rdopt.h"
+#include "av1/encoder/time_budget.h"
 
 #include "aom_dsp/aom_dsp_common.h"
 
@@ -279,6 +280,8 @@ static void set_good_speed_features_framesize_independent(
   sf->cb_pred_filter_search = 0;
   sf->use_nonrd_pick_mode = 0;
   sf->use_real_time_ref_set = 0;
+  // Screen content repeats the same residues from frame to frame.
+  if (cm->allow_screen_content_tools) sf->use_mb_rd_hash = 2;
 
   if (speed >= 1) {
     sf->selective_ref_frame = 2;
@@ -298,6 +301,7 @@ static void set_good_speed_features_framesize_independent(
     sf->use_accurate_subpel_search = USE_4_TAPS;
     sf->reuse_inter_intra_mode = 1;
     sf->prune_comp_search_by_single_result = 1;
+    sf->mv.use_tpl_mvs = 1;
     sf->skip_repeated_newmv = 1;
     sf->obmc_full_pixel_search_level = 1;
     // TODO(Venkat): Clean-up frame type dependency for
@@ -344,6 +348,7 @@ static void set_good_speed_features_framesize_independent(
     sf->adaptive_rd_thresh = 1;
     sf->mv.auto_mv_step_size = 1;
     sf->mv.subpel_iters_per_step = 1;
+    sf->mv.use_tpl_mvs = 2;
     sf->disable_filter_search_var_thresh = 100;
     sf->comp_inter_joint_search_thresh = BLOCK_SIZES_ALL;
 
@@ -397,6 +402,8 @@ static void set_good_speed_features_framesize_independent(
     sf->mv.subpel_search_method = SUBPEL_TREE_PRUNED;
     sf->simple_motion_search_prune_agg = 1;
     sf->disable_sb_level_mv_cost_upd = 1;
+    sf->quantized_nn_models =
+        QUANTIZED_NN_SMS_SPLIT | QUANTIZED_NN_SMS_PRUNE_RECT;
   }
 
   if (speed >= 4) {
@@ -706,6 +713,70 @@ static void set_rt_speed_features_framesize_independent(AV1_COMP *cpi,
   }
 }
 
+// Tightens the speed features of the speed setting when the encoder runs over
+// its frame time budget. Each level adds to the previous ones. All of these
+// features are read as the blocks are coded, so they may change between two
+// superblock rows.
+static void set_time_budget_speed_features(SPEED_FEATURES *sf, int level) {
+  if (level >= 1) {
+    sf->less_rectangular_check_level =
+        AOMMAX(sf->less_rectangular_check_level, 1);
+    sf->prune_ext_partition_types_search_level =
+        AOMMAX(sf->prune_ext_partition_types_search_level, 1);
+    sf->selective_ref_frame = AOMMAX(sf->selective_ref_frame, 2);
+    sf->mv.subpel_search_method =
+        AOMMAX(sf->mv.subpel_search_method, SUBPEL_TREE_PRUNED);
+  }
+  if (level >= 2) {
+    sf->less_rectangular_check_level = 2;
+    sf->prune_ext_partition_types_search_level = 2;
+    sf->selective_ref_frame = AOMMAX(sf->selective_ref_frame, 3);
+    sf->tx_size_search_level = AOMMAX(sf->tx_size_search_level, 1);
+    sf->mv.subpel_search_method =
+        AOMMAX(sf->mv.subpel_search_method, SUBPEL_TREE_PRUNED_MORE);
+  }
+  if (level >= 3) {
+    sf->selective_ref_frame = AOMMAX(sf->selective_ref_frame, 4);
+    sf->tx_size_search_level = 2;
+    sf->use_square_partition_only_threshold =
+        AOMMIN(sf->use_square_partition_only_threshold, BLOCK_32X32);
+    if (sf->mv.search_method == NSTEP || sf->mv.search_method == DIAMOND)
+      sf->mv.search_method = HEX;
+  }
+}
+
+static void set_find_fractional_mv_step(AV1_COMP *cpi) {
+  const SPEED_FEATURES *const sf = &cpi->sf;
+  if (sf->mv.subpel_search_method == SUBPEL_TREE) {
+    cpi->find_fractional_mv_step = av1_find_best_sub_pixel_tree;
+  } else if (sf->mv.subpel_search_method == SUBPEL_TREE_PRUNED) {
+    cpi->find_fractional_mv_step = av1_find_best_sub_pixel_tree_pruned;
+  } else if (sf->mv.subpel_search_method == SUBPEL_TREE_PRUNED_MORE) {
+    cpi->find_fractional_mv_step = av1_find_best_sub_pixel_tree_pruned_more;
+  } else if (sf->mv.subpel_search_method == SUBPEL_TREE_PRUNED_EVENMORE) {
+    cpi->find_fractional_mv_step = av1_find_best_sub_pixel_tree_pruned_evenmore;
+  }
+
+  // This is only used in motion vector unit test.
+  if (cpi->oxcf.motion_vector_unit_test == 1)
+    cpi->find_fractional_mv_step = av1_return_max_sub_pixel_mv;
+  else if (cpi->oxcf.motion_vector_unit_test == 2)
+    cpi->find_fractional_mv_step = av1_return_min_sub_pixel_mv;
+}
+
+static void set_tx_size_search_methods(AV1_COMP *cpi) {
+  // Override speed feature setting for user config
+  if (cpi->oxcf.tx_size_search_method != USE_FULL_RD) {
+    cpi->sf.enable_winner_mode_for_tx_size_srch = 0;
+    cpi->sf.tx_size_search_level = cpi->oxcf.tx_size_search_method;
+  }
+  // assert ensures that tx_size_search_level is accessed correctly
+  assert(cpi->sf.tx_size_search_level >= 0 && cpi->sf.tx_size_search_level < 3);
+  memcpy(cpi->tx_size_search_methods,
+         tx_size_search_methods[cpi->sf.tx_size_search_level],
+         sizeof(cpi->tx_size_search_methods));
+}
+
 void av1_set_speed_features_framesize_dependent(AV1_COMP *cpi, int speed) {
   SPEED_FEATURES *const sf = &cpi->sf;
   const AV1EncoderConfig *const oxcf = &cpi->oxcf;
@@ -768,6 +839,7 @@ void av1_set_speed_features_framesize_independent(AV1_COMP *cpi, int speed) {
   sf->disable_adaptive_warp_error_thresh = 1;
   sf->mv.reduce_first_step_size = 0;
   sf->mv.auto_mv_step_size = 0;
+  sf->mv.use_tpl_mvs = 0;
   sf->comp_inter_joint_search_thresh = BLOCK_4X4;
   sf->adaptive_rd_thresh = 0;
   // TODO(sarahparker) Pair this with a speed setting once experiments are done
@@ -866,6 +938,7 @@ void av1_set_speed_features_framesize_independent(AV1_COMP *cpi, int speed) {
   sf->simple_motion_search_prune_agg = 0;
   sf->simple_motion_search_split = 0;
   sf->simple_motion_search_prune_rect = 0;
+  sf->quantized_nn_models = 0;
   sf->simple_motion_search_early_term_none = 0;
   sf->intra_cnn_split = 0;
 
@@ -917,6 +990,9 @@ void av1_set_speed_features_framesize_independent(AV1_COMP *cpi, int speed) {
   else if (oxcf->mode == REALTIME)
     set_rt_speed_features_framesize_independent(cpi, sf, speed);
 
+  if (av1_time_budget_enabled(cpi))
+    set_time_budget_speed_features(sf, cpi->time_budget.level);
+
   if (!cpi->seq_params_locked) {
     cpi->common.seq_params.enable_dual_filter &= !sf->disable_dual_filter;
   }
@@ -965,15 +1041,7 @@ void av1_set_speed_features_framesize_independent(AV1_COMP *cpi, int speed) {
   // No recode or trellis for 1 pass.
   if (oxcf->pass == 0) sf->recode_loop = DISALLOW_RECODE;
 
-  if (sf->mv.subpel_search_method == SUBPEL_TREE) {
-    cpi->find_fractional_mv_step = av1_find_best_sub_pixel_tree;
-  } else if (sf->mv.subpel_search_method == SUBPEL_TREE_PRUNED) {
-    cpi->find_fractional_mv_step = av1_find_best_sub_pixel_tree_pruned;
-  } else if (sf->mv.subpel_search_method == SUBPEL_TREE_PRUNED_MORE) {
-    cpi->find_fractional_mv_step = av1_find_best_sub_pixel_tree_pruned_more;
-  } else if (sf->mv.subpel_search_method == SUBPEL_TREE_PRUNED_EVENMORE) {
-    cpi->find_fractional_mv_step = av1_find_best_sub_pixel_tree_pruned_evenmore;
-  }
+  set_find_fractional_mv_step(cpi);
 
   x->min_partition_size = AOMMAX(sf->default_min_partition_size,
                                  dim_to_size(cpi->oxcf.min_partition_size));
@@ -982,11 +1050,6 @@ void av1_set_speed_features_framesize_independent(AV1_COMP *cpi, int speed) {
   x->min_partition_size = AOMMIN(x->min_partition_size, cm->seq_params.sb_size);
   x->max_partition_size = AOMMIN(x->max_partition_size, cm->seq_params.sb_size);
 
-  // This is only used in motion vector unit test.
-  if (cpi->oxcf.motion_vector_unit_test == 1)
-    cpi->find_fractional_mv_step = av1_return_max_sub_pixel_mv;
-  else if (cpi->oxcf.motion_vector_unit_test == 2)
-    cpi->find_fractional_mv_step = av1_return_min_sub_pixel_mv;
   cpi->max_comp_type_rd_threshold_mul =
       comp_type_rd_threshold_mul[sf->prune_comp_type_by_comp_avg];
   cpi->max_comp_type_rd_threshold_div =
@@ -1010,16 +1073,7 @@ void av1_set_speed_features_framesize_independent(AV1_COMP *cpi, int speed) {
          coeff_opt_dist_thresholds[cpi->sf.perform_coeff_opt],
          sizeof(cpi->coeff_opt_dist_threshold));
 
-  // Override speed feature setting for user config
-  if (cpi->oxcf.tx_size_search_method != USE_FULL_RD) {
-    cpi->sf.enable_winner_mode_for_tx_size_srch = 0;
-    cpi->sf.tx_size_search_level = cpi->oxcf.tx_size_search_method;
-  }
-  // assert ensures that tx_size_search_level is accessed correctly
-  assert(cpi->sf.tx_size_search_level >= 0 && cpi->sf.tx_size_search_level < 3);
-  memcpy(cpi->tx_size_search_methods,
-         tx_size_search_methods[cpi->sf.tx_size_search_level],
-         sizeof(cpi->tx_size_search_methods));
+  set_tx_size_search_methods(cpi);
 
 #if CONFIG_DIST_8X8
   if (sf->tx_domain_dist_level > 0) cpi->oxcf.using_dist_8x8 = 0;
@@ -1033,3 +1087,9 @@ void av1_set_speed_features_framesize_independent(AV1_COMP *cpi, int speed) {
     }
   }
 }
+
+void av1_set_time_budget_speed_features(AV1_COMP *cpi) {
+  set_time_budget_speed_features(&cpi->sf, cpi->time_budget.level);
+  set_find_fractional_mv_step(cpi);
+  set_tx_size_search_methods(cpi);
+}
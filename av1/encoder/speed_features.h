@@ -214,6 +214,13 @@ enum {
   ADAPT_PRED
 } UENUM1BYTE(MAX_PART_PRED_MODE);
 
+// Models that can be evaluated with fixed-point inference, see
+// SPEED_FEATURES::quantized_nn_models.
+enum {
+  QUANTIZED_NN_SMS_SPLIT = 1 << 0,
+  QUANTIZED_NN_SMS_PRUNE_RECT = 1 << 1,
+} UENUM1BYTE(QUANTIZED_NN_MODEL);
+
 typedef struct MV_SPEED_FEATURES {
   // Motion search method (Diamond, NSTEP, Hex, Big Diamond, Square, etc).
   SEARCH_METHODS search_method;
@@ -237,6 +244,14 @@ typedef struct MV_SPEED_FEATURES {
 
   // When to stop subpel search.
   SUBPEL_FORCE_STOP subpel_force_stop;
+
+  // Use the motion vectors found by the TPL model to seed the full-pixel
+  // motion search, when they are close to the predicted motion vector.
+  // 0: off
+  // 1: start the search from the TPL motion vector when it is a better start
+  //    point than the predicted one
+  // 2: also reduce the first step size of the search
+  int use_tpl_mvs;
 } MV_SPEED_FEATURES;
 
 #define MAX_MESH_STEP 4
@@ -559,6 +574,10 @@ typedef struct SPEED_FEATURES {
 
   // Use hash table to store macroblock RD search results
   // to avoid repeated search on the same residue signal.
+  // 0: disabled
+  // 1: within the superblock
+  // 2: also from the previous frames (see tx_rd_cache.h), the rates being
+  //    those of the costs when the results were saved
   int use_mb_rd_hash;
 
   // Use to control hash generation and use of the same
@@ -666,6 +685,10 @@ typedef struct SPEED_FEATURES {
   // partition after PARTITION_NONE
   int simple_motion_search_early_term_none;
 
+  // Bitmask of QUANTIZED_NN_MODEL values. The selected models are evaluated
+  // with fixed-point inference instead of floats.
+  int quantized_nn_models;
+
   int cb_pred_filter_search;
 
   // adaptive interp_filter search to allow skip of certain filter types.
@@ -821,6 +844,8 @@ void av1_set_speed_features_framesize_independent(struct AV1_COMP *cpi,
                                                   int speed);
 void av1_set_speed_features_framesize_dependent(struct AV1_COMP *cpi,
                                                 int speed);
+// Applies the level of cpi->time_budget in the middle of a frame.
+void av1_set_time_budget_speed_features(struct AV1_COMP *cpi);
 
 #ifdef __cplusplus
 }  // extern "C"
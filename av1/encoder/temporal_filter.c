@@ -71,6 +71,19 @@ static void temporal_filter_predictors_mb_c(
 
   InterPredParams inter_pred_params;
 
+  // When the 4 16x16 blocks share the same motion vector, a single 32x32
+  // predictor per plane gives the same result at a fraction of the setup and
+  // convolution overhead. This does not hold with scaled references, where
+  // the sub-block positions are not passed to the predictor.
+  if (!use_32x32 && !av1_is_scaled(scale) &&
+      blk_mvs[1].row == blk_mvs[0].row && blk_mvs[1].col == blk_mvs[0].col &&
+      blk_mvs[2].row == blk_mvs[0].row && blk_mvs[2].col == blk_mvs[0].col &&
+      blk_mvs[3].row == blk_mvs[0].row && blk_mvs[3].col == blk_mvs[0].col) {
+    use_32x32 = 1;
+    mv_row = blk_mvs[0].row;
+    mv_col = blk_mvs[0].col;
+  }
+
   av1_init_inter_params(&inter_pred_params, BW, BH, x, y, 0, 0, xd->bd,
                         is_cur_buf_hbd(xd), 0, scale, interp_filters);
   inter_pred_params.conv_params = get_conv_params(0, 0, xd->bd);
@@ -125,16 +138,16 @@ static void temporal_filter_predictors_mb_c(
     xs = (uv_block_width >> 1);
     k = 0;
 
+    av1_init_inter_params(&inter_pred_params, xs, ys, x, y,
+                          xd->plane[1].subsampling_x,
+                          xd->plane[1].subsampling_y, xd->bd,
+                          is_cur_buf_hbd(xd), 0, scale, interp_filters);
     for (i = 0; i < uv_block_height; i += ys) {
       for (j = 0; j < uv_block_width; j += xs) {
         const MV mv = blk_mvs[k];
         const int uv_offset = i * uv_stride + j;
         const int p_offset = i * uv_block_width + j;
 
-        av1_init_inter_params(&inter_pred_params, xs, ys, x, y,
-                              xd->plane[1].subsampling_x,
-                              xd->plane[1].subsampling_y, xd->bd,
-                              is_cur_buf_hbd(xd), 0, scale, interp_filters);
         inter_pred_params.conv_params = get_conv_params(0, 1, xd->bd);
 
         av1_build_inter_predictor(u_mb_ptr + uv_offset, uv_stride,
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "aom_ports/aom_timer.h"
+
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/speed_features.h"
+#include "av1/encoder/time_budget.h"
+
+static int64_t time_budget_elapsed(TIME_BUDGET *tb) {
+  aom_usec_timer_mark(&tb->timer);
+  return aom_usec_timer_elapsed(&tb->timer);
+}
+
+void av1_time_budget_start_frame(AV1_COMP *cpi) {
+  TIME_BUDGET *const tb = &cpi->time_budget;
+  tb->raised_mid_frame = 0;
+  tb->check_rows = 0;
+  aom_usec_timer_start(&tb->timer);
+}
+
+void av1_time_budget_start_rows(AV1_COMP *cpi) {
+  const AV1_COMMON *const cm = &cpi->common;
+  TIME_BUDGET *const tb = &cpi->time_budget;
+  const int mib_size = cm->seq_params.mib_size;
+  const int mib_size_log2 = cm->seq_params.mib_size_log2;
+  const int sb_rows = (cm->mi_rows + mib_size - 1) >> mib_size_log2;
+  const int sb_cols = (cm->mi_cols + mib_size - 1) >> mib_size_log2;
+
+  tb->check_rows = tb->level < TIME_BUDGET_MAX_LEVEL;
+  tb->num_sbs = sb_rows * sb_cols;
+  tb->num_sbs_done = 0;
+  tb->check_point_time = time_budget_elapsed(tb);
+}
+
+void av1_time_budget_sb_row_done(AV1_COMP *cpi, int num_sbs) {
+  TIME_BUDGET *const tb = &cpi->time_budget;
+  if (!tb->check_rows) return;
+
+  // Wait for an eighth of the remaining superblocks, so that a single costly
+  // row does not raise the level.
+  tb->num_sbs_done += num_sbs;
+  if (tb->num_sbs_done * 8 < tb->num_sbs) return;
+
+  const int64_t now = time_budget_elapsed(tb);
+  const int num_sbs_left = AOMMAX(tb->num_sbs - tb->num_sbs_done, 0);
+  const int64_t projected_time =
+      now + (now - tb->check_point_time) * num_sbs_left / tb->num_sbs_done;
+  if (projected_time > (int64_t)cpi->oxcf.frame_time_budget) {
+    ++tb->level;
+    ++tb->stats.escalations;
+    ++tb->stats.mid_frame_escalations;
+    tb->raised_mid_frame = 1;
+    tb->check_rows = tb->level < TIME_BUDGET_MAX_LEVEL;
+    av1_set_time_budget_speed_features(cpi);
+  }
+  // The next projection only uses the rows coded from now on.
+  tb->num_sbs = num_sbs_left;
+  tb->num_sbs_done = 0;
+  tb->check_point_time = now;
+}
+
+void av1_time_budget_end_frame(AV1_COMP *cpi) {
+  TIME_BUDGET *const tb = &cpi->time_budget;
+  const int64_t budget = cpi->oxcf.frame_time_budget;
+  const int64_t elapsed = time_budget_elapsed(tb);
+
+  tb->check_rows = 0;
+  ++tb->stats.frames;
+  tb->stats.max_frame_time = AOMMAX(tb->stats.max_frame_time, elapsed);
+  if (elapsed > budget) {
+    ++tb->stats.frames_over_budget;
+    tb->num_frames_under_budget = 0;
+    // Only raise the level once per frame.
+    if (!tb->raised_mid_frame && tb->level < TIME_BUDGET_MAX_LEVEL) {
+      ++tb->level;
+      ++tb->stats.escalations;
+    }
+  } else if (elapsed * 100 < budget * TIME_BUDGET_RELAX_PCT) {
+    if (++tb->num_frames_under_budget >= TIME_BUDGET_RELAX_FRAMES &&
+        tb->level > 0) {
+      --tb->level;
+      ++tb->stats.relaxations;
+      tb->num_frames_under_budget = 0;
+    }
+  } else {
+    tb->num_frames_under_budget = 0;
+  }
+  tb->stats.level = tb->level;
+}
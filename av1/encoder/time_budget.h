@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_ENCODER_TIME_BUDGET_H_
+#define AOM_AV1_ENCODER_TIME_BUDGET_H_
+
+#include "av1/encoder/encoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// When oxcf.frame_time_budget is set, the time spent on each frame raises the
+// level of cpi->time_budget, which tightens the speed features (see
+// av1_set_time_budget_speed_features()), as soon as the frame goes over the
+// budget. Once TIME_BUDGET_RELAX_FRAMES frames in a row have taken less than
+// TIME_BUDGET_RELAX_PCT percent of the budget, the level goes back down.
+#define TIME_BUDGET_MAX_LEVEL 3
+#define TIME_BUDGET_RELAX_FRAMES 4
+#define TIME_BUDGET_RELAX_PCT 70
+
+static INLINE int av1_time_budget_enabled(const AV1_COMP *cpi) {
+  return cpi->oxcf.frame_time_budget > 0 && cpi->oxcf.pass != 1;
+}
+
+void av1_time_budget_start_frame(AV1_COMP *cpi);
+
+// Called when a single thread is about to code the superblock rows of the
+// frame. It then calls av1_time_budget_sb_row_done() after each one. When the
+// rows are coded by several threads, the level only changes between frames.
+void av1_time_budget_start_rows(AV1_COMP *cpi);
+
+// Raises the level in the middle of the frame if the rate of the last rows
+// projects the frame over its budget.
+void av1_time_budget_sb_row_done(AV1_COMP *cpi, int num_sbs);
+
+void av1_time_budget_end_frame(AV1_COMP *cpi);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_ENCODER_TIME_BUDGET_H_
@@ -171,6 +171,8 @@ static AOM_INLINE void mode_estimation(
   const int dst_buffer_stride = tpl_frame->rec_picture->y_stride;
 
   memset(tpl_stats, 0, sizeof(*tpl_stats));
+  for (int i = 0; i < INTER_REFS_PER_FRAME; ++i)
+    tpl_stats->ref_mvs[i].as_int = INVALID_MV;
 
   xd->above_mbmi = NULL;
   xd->left_mbmi = NULL;
@@ -239,6 +241,7 @@ static AOM_INLINE void mode_estimation(
 
     motion_estimation(cpi, x, src_mb_buffer, ref_mb, src_stride, ref_stride,
                       bsize, mi_row, mi_col);
+    if (frame_idx) tpl_stats->ref_mvs[rf_idx].as_int = x->best_mv.as_int;
 
     InterPredParams inter_pred_params;
     av1_init_inter_params(&inter_pred_params, bw, bh, mi_col * MI_SIZE,
@@ -539,6 +542,7 @@ static AOM_INLINE void tpl_model_store(AV1_COMP *cpi,
       tpl_ptr->recrf_rate = recrf_rate;
       tpl_ptr->mv.as_int = src_stats->mv.as_int;
       tpl_ptr->ref_frame_index = src_stats->ref_frame_index;
+      memcpy(tpl_ptr->ref_mvs, src_stats->ref_mvs, sizeof(tpl_ptr->ref_mvs));
       ++tpl_ptr;
     }
   }
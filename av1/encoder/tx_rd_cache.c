@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include "aom_mem/aom_mem.h"
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/ethread.h"
+#include "av1/encoder/tx_rd_cache.h"
+
+static void alloc_tx_rd_cache(AV1_COMMON *cm, TX_RD_CACHE *cache) {
+  if (cache->entries) return;
+  cache->size_log2 = TX_RD_CACHE_SIZE_LOG2;
+  CHECK_MEM_ERROR(cm, cache->entries,
+                  aom_calloc((size_t)1 << cache->size_log2,
+                             sizeof(*cache->entries)));
+}
+
+// The results of different transform searches on the same residue, e.g. with
+// the largest transform and then with the full search, must not replace each
+// other, so the index mixes in the search context.
+static INLINE int get_cache_index(const TX_RD_CACHE *cache, uint32_t hash,
+                                  uint32_t ctx) {
+  // The 5 low bits of the residue hash are the block size.
+  return ((hash >> 5) ^ (ctx * 0x9E3779B1u >> 7)) &
+         ((1 << cache->size_log2) - 1);
+}
+
+void av1_tx_rd_cache_init_frame(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  if (cpi->sf.use_mb_rd_hash < 2) return;
+  alloc_tx_rd_cache(cm, &cpi->tx_rd_cache);
+  // The coefficient costs are reset, so the rates of the older frames would
+  // be farther off.
+  if (frame_is_intra_only(cm)) {
+    memset(cpi->tx_rd_cache.entries, 0,
+           sizeof(*cpi->tx_rd_cache.entries) << cpi->tx_rd_cache.size_log2);
+  }
+}
+
+void av1_tx_rd_cache_setup_thread(AV1_COMP *cpi, ThreadData *td) {
+  if (cpi->sf.use_mb_rd_hash < 2) {
+    td->mb.tx_rd_cache = NULL;
+    return;
+  }
+  alloc_tx_rd_cache(&cpi->common, &td->tx_rd_cache);
+  td->mb.tx_rd_cache = &td->tx_rd_cache;
+}
+
+void av1_tx_rd_cache_merge_threads(AV1_COMP *cpi) {
+  TX_RD_CACHE *const dst = &cpi->tx_rd_cache;
+  if (cpi->sf.use_mb_rd_hash < 2 || !dst->entries) return;
+  TX_RD_CACHE *src[MAX_NUM_THREADS];
+  int num_src = 0;
+  src[num_src++] = &cpi->td.tx_rd_cache;
+  for (int t = 1; t < cpi->num_workers; ++t) {
+    TX_RD_CACHE *const cache = &cpi->tile_thr_data[t].td->tx_rd_cache;
+    if (cache->entries) src[num_src++] = cache;
+  }
+
+  // For each entry keep the result of the last block in raster order, which
+  // does not depend on how the blocks were split between the threads.
+  for (int i = 0; i < 1 << dst->size_log2; ++i) {
+    TX_RD_CACHE_ENTRY *best = NULL;
+    for (int j = 0; j < num_src; ++j) {
+      TX_RD_CACHE_ENTRY *const entry = &src[j]->entries[i];
+      if (!entry->valid) continue;
+      if (!best || entry->pos > best->pos) best = entry;
+      entry->valid = 0;
+    }
+    if (best) {
+      dst->entries[i] = *best;
+      dst->entries[i].valid = 1;
+    }
+  }
+}
+
+void av1_tx_rd_cache_dealloc(TX_RD_CACHE *cache) {
+  aom_free(cache->entries);
+  cache->entries = NULL;
+}
+
+const MB_RD_INFO *av1_tx_rd_cache_find(const TX_RD_CACHE *cache,
+                                       uint32_t hash, uint32_t ctx,
+                                       int rdmult) {
+  const TX_RD_CACHE_ENTRY *const entry =
+      &cache->entries[get_cache_index(cache, hash, ctx)];
+  if (entry->valid && entry->rd_info.hash_value == hash &&
+      entry->ctx == ctx && entry->rdmult == rdmult)
+    return &entry->rd_info;
+  return NULL;
+}
+
+void av1_tx_rd_cache_save(TX_RD_CACHE *cache, const MB_RD_INFO *rd_info,
+                          uint32_t ctx, int rdmult, int pos) {
+  TX_RD_CACHE_ENTRY *const entry =
+      &cache->entries[get_cache_index(cache, rd_info->hash_value, ctx)];
+  // Keep the entry of the later block in raster order, so that the contents
+  // of the table do not depend on the order in which the blocks are encoded.
+  if (entry->valid && entry->pos > pos) return;
+  entry->rd_info = *rd_info;
+  entry->ctx = ctx;
+  entry->rdmult = rdmult;
+  entry->pos = pos;
+  entry->valid = 1;
+}
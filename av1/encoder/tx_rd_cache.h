@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_ENCODER_TX_RD_CACHE_H_
+#define AOM_AV1_ENCODER_TX_RD_CACHE_H_
+
+#include "av1/encoder/block.h"
+#include "av1/encoder/encoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The transform RD search results of the inter blocks (MB_RD_INFO) are kept
+// from one frame to the next when sf.use_mb_rd_hash is 2. During a frame the
+// threads look them up in cpi->tx_rd_cache, which is read-only, and save their
+// new results in their own table of the same size. The tables of the threads
+// are merged into cpi->tx_rd_cache once the frame is encoded, so the results
+// do not depend on the number of threads.
+#define TX_RD_CACHE_SIZE_LOG2 11
+
+// Allocates the shared table if needed, and resets it on intra-only frames.
+void av1_tx_rd_cache_init_frame(AV1_COMP *cpi);
+
+// Points the MACROBLOCK of the thread to its table, or to NULL when the cache
+// is disabled.
+void av1_tx_rd_cache_setup_thread(AV1_COMP *cpi, ThreadData *td);
+
+// Moves the results of the threads into the shared table.
+void av1_tx_rd_cache_merge_threads(AV1_COMP *cpi);
+
+void av1_tx_rd_cache_dealloc(TX_RD_CACHE *cache);
+
+const MB_RD_INFO *av1_tx_rd_cache_find(const TX_RD_CACHE *cache,
+                                       uint32_t hash, uint32_t ctx,
+                                       int rdmult);
+
+void av1_tx_rd_cache_save(TX_RD_CACHE *cache, const MB_RD_INFO *rd_info,
+                          uint32_t ctx, int rdmult, int pos);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_ENCODER_TX_RD_CACHE_H_
@@ -27,6 +27,7 @@
 #include "av1/common/reconinter.h"
 #include "av1/common/blockd.h"
 
+#include "av1/encoder/block_hints.h"
 #include "av1/encoder/encodeframe.h"
 #include "av1/encoder/var_based_part.h"
 #include "av1/encoder/reconinter_enc.h"
@@ -259,6 +260,30 @@ static int set_vt_partitioning(AV1_COMP *cpi, MACROBLOCK *const x,
   return 0;
 }
 
+// Splits the block down depth levels, or down to 8x8 blocks. The blocks
+// crossing the edge of the tile are split like in set_vt_partitioning().
+static void set_hinted_partitioning(AV1_COMP *cpi, MACROBLOCK *const x,
+                                    MACROBLOCKD *const xd,
+                                    const TileInfo *const tile,
+                                    BLOCK_SIZE bsize, int mi_row, int mi_col,
+                                    int depth) {
+  const int block_size = mi_size_wide[bsize];
+  if (mi_row >= tile->mi_row_end || mi_col >= tile->mi_col_end) return;
+  if (bsize == BLOCK_8X8 ||
+      (depth == 0 && mi_row + block_size <= tile->mi_row_end &&
+       mi_col + block_size <= tile->mi_col_end)) {
+    set_block_size(cpi, x, xd, mi_row, mi_col, bsize);
+    return;
+  }
+  const BLOCK_SIZE subsize = get_partition_subsize(bsize, PARTITION_SPLIT);
+  const int hbs = block_size / 2;
+  for (int i = 0; i < 4; ++i) {
+    set_hinted_partitioning(cpi, x, xd, tile, subsize,
+                            mi_row + (i >> 1) * hbs, mi_col + (i & 1) * hbs,
+                            AOMMAX(depth - 1, 0));
+  }
+}
+
 static AOM_INLINE void fill_variance_8x8avg(const uint8_t *s, int sp,
                                             const uint8_t *d, int dp,
                                             int x16_idx, int y16_idx,
@@ -762,6 +787,31 @@ int av1_choose_var_based_partitioning(AV1_COMP *cpi, const TileInfo *const tile,
     dp = 0;
   }
 
+  // Follow the partition depths of the analysis of the source when it has
+  // them for all the 64x64 blocks of the superblock. Like the variance based
+  // choice, intra frames split the 64x64 blocks.
+  int hinted_depths[4];
+  int use_hinted_depths = 1;
+  for (m = 0; m < num_64x64_blocks; ++m) {
+    const int row = mi_row + (m >> 1) * MI_SIZE_64X64;
+    const int col = mi_col + (m & 1) * MI_SIZE_64X64;
+    hinted_depths[m] = 0;
+    if (row >= tile->mi_row_end || col >= tile->mi_col_end) continue;
+    hinted_depths[m] = av1_get_analysis_depth(cpi, row, col);
+    if (hinted_depths[m] < 0) use_hinted_depths = 0;
+  }
+  if (use_hinted_depths) {
+    for (m = 0; m < num_64x64_blocks; ++m) {
+      set_hinted_partitioning(
+          cpi, x, xd, tile, BLOCK_64X64, mi_row + (m >> 1) * MI_SIZE_64X64,
+          mi_col + (m & 1) * MI_SIZE_64X64,
+          is_key_frame ? AOMMAX(hinted_depths[m], 1) : hinted_depths[m]);
+    }
+    chroma_check(cpi, x, bsize, y_sad, is_key_frame);
+    aom_free(vt);
+    return 0;
+  }
+
   if (low_res && threshold_4x4avg < INT64_MAX)
     CHECK_MEM_ERROR(cm, vt2, aom_malloc(sizeof(*vt2)));
   // Fill in the entire tree of 8x8 (or 4x4 under some conditions) variances
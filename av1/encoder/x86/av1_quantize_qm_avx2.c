@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+
+// Returns floor(a * b / 2^shift) for each signed 32-bit lane, with the
+// products computed on 64 bits. shift_lo holds shift and shift_hi holds
+// 32 - shift, with 0 < shift <= 32. The results must fit in 32 bits.
+static INLINE __m256i mul_shift_epi32(__m256i a, __m256i b, __m128i shift_lo,
+                                      __m128i shift_hi) {
+  const __m256i even = _mm256_mul_epi32(a, b);
+  const __m256i odd =
+      _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+  return _mm256_blend_epi32(_mm256_srl_epi64(even, shift_lo),
+                            _mm256_sll_epi64(odd, shift_hi), 0xaa);
+}
+
+static INLINE __m256i set_dc_ac_epi32(int dc, int ac) {
+  return _mm256_setr_epi32(dc, ac, ac, ac, ac, ac, ac, ac);
+}
+
+static INLINE __m256i load_qm_epi32(const qm_val_t *qm) {
+  return _mm256_cvtepu8_epi32(xx_loadl_64(qm));
+}
+
+// AVX2 version of quantize_qm_sse4_1(): quantizes n_coeffs coefficients in
+// raster order, 8 at a time.
+static INLINE void quantize_qm_avx2(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, const int16_t *zbin_ptr,
+    const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *iscan, const qm_val_t *qm_ptr, const qm_val_t *iqm_ptr,
+    int log_scale, int is_fp, int clamp_to_int16) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i int16_max = _mm256_set1_epi32(INT16_MAX);
+  const __m256i qm_round = _mm256_set1_epi32(1 << (AOM_QM_BITS - 1));
+  const int shift = 16 - log_scale + AOM_QM_BITS;
+  const __m128i shift_lo = _mm_cvtsi32_si128(shift);
+  const __m128i shift_hi = _mm_cvtsi32_si128(32 - shift);
+  const __m128i shift16 = _mm_cvtsi32_si128(16);
+  const __m128i log_scale_count = _mm_cvtsi32_si128(log_scale);
+  __m256i eob = zero;
+  assert(qm_ptr != NULL && iqm_ptr != NULL);
+  assert(n_coeffs % 8 == 0);
+
+  int thresh_dc, thresh_ac, quant_shift_dc = 0, quant_shift_ac = 0;
+  if (is_fp) {
+    const int thresh_shift = AOM_QM_BITS - (1 + log_scale);
+    thresh_dc = (dequant_ptr[0] << thresh_shift) - 1;
+    thresh_ac = (dequant_ptr[1] << thresh_shift) - 1;
+  } else {
+    thresh_dc = (ROUND_POWER_OF_TWO(zbin_ptr[0], log_scale) << AOM_QM_BITS) - 1;
+    thresh_ac = (ROUND_POWER_OF_TWO(zbin_ptr[1], log_scale) << AOM_QM_BITS) - 1;
+    quant_shift_dc = quant_shift_ptr[0];
+    quant_shift_ac = quant_shift_ptr[1];
+  }
+  const int round_dc = ROUND_POWER_OF_TWO(round_ptr[0], log_scale);
+  const int round_ac = ROUND_POWER_OF_TWO(round_ptr[1], log_scale);
+  // Lane 0 holds the DC parameters and the other lanes the AC parameters.
+  __m256i thresh = set_dc_ac_epi32(thresh_dc, thresh_ac);
+  __m256i round = set_dc_ac_epi32(round_dc, round_ac);
+  __m256i quant = set_dc_ac_epi32(quant_ptr[0], quant_ptr[1]);
+  __m256i quant_shift = set_dc_ac_epi32(quant_shift_dc, quant_shift_ac);
+  __m256i dequant = set_dc_ac_epi32(dequant_ptr[0], dequant_ptr[1]);
+
+  for (intptr_t i = 0; i < n_coeffs; i += 8) {
+    const __m256i coeff = yy_loadu_256(coeff_ptr + i);
+    const __m256i wt = load_qm_epi32(qm_ptr + i);
+    const __m256i abs_coeff = _mm256_abs_epi32(coeff);
+    const __m256i keep =
+        _mm256_cmpgt_epi32(_mm256_mullo_epi32(abs_coeff, wt), thresh);
+    if (_mm256_movemask_epi8(keep)) {
+      __m256i tmp = _mm256_add_epi32(abs_coeff, round);
+      if (clamp_to_int16) tmp = _mm256_min_epi32(tmp, int16_max);
+      const __m256i tmpw = _mm256_mullo_epi32(tmp, wt);
+      __m256i abs_q;
+      if (is_fp) {
+        abs_q = mul_shift_epi32(tmpw, quant, shift_lo, shift_hi);
+      } else {
+        const __m256i tmp2 = _mm256_add_epi32(
+            mul_shift_epi32(tmpw, quant, shift16, shift16), tmpw);
+        abs_q = mul_shift_epi32(tmp2, quant_shift, shift_lo, shift_hi);
+      }
+      const __m256i iwt = load_qm_epi32(iqm_ptr + i);
+      const __m256i dq = _mm256_srai_epi32(
+          _mm256_add_epi32(_mm256_mullo_epi32(dequant, iwt), qm_round),
+          AOM_QM_BITS);
+      const __m256i abs_dq =
+          _mm256_sra_epi32(_mm256_mullo_epi32(abs_q, dq), log_scale_count);
+      yy_storeu_256(qcoeff_ptr + i,
+                    _mm256_sign_epi32(_mm256_and_si256(keep, abs_q), coeff));
+      yy_storeu_256(dqcoeff_ptr + i,
+                    _mm256_sign_epi32(_mm256_and_si256(keep, abs_dq), coeff));
+
+      const __m256i nz =
+          _mm256_andnot_si256(_mm256_cmpeq_epi32(abs_q, zero), keep);
+      const __m256i scan_pos = _mm256_add_epi32(
+          _mm256_cvtepi16_epi32(xx_loadu_128(iscan + i)), one);
+      eob = _mm256_max_epi32(eob, _mm256_and_si256(nz, scan_pos));
+    } else {
+      yy_storeu_256(qcoeff_ptr + i, zero);
+      yy_storeu_256(dqcoeff_ptr + i, zero);
+    }
+    // Switch to the AC parameters.
+    thresh = _mm256_set1_epi32(thresh_ac);
+    round = _mm256_set1_epi32(round_ac);
+    quant = _mm256_set1_epi32(quant_ptr[1]);
+    quant_shift = _mm256_set1_epi32(quant_shift_ac);
+    dequant = _mm256_set1_epi32(dequant_ptr[1]);
+  }
+
+  __m128i eob_128 = _mm_max_epi32(_mm256_castsi256_si128(eob),
+                                  _mm256_extracti128_si256(eob, 1));
+  eob_128 = _mm_max_epi32(eob_128, _mm_srli_si128(eob_128, 8));
+  eob_128 = _mm_max_epi32(eob_128, _mm_srli_si128(eob_128, 4));
+  *eob_ptr = (uint16_t)_mm_cvtsi128_si32(eob_128);
+}
+
+void av1_quantize_b_avx2(const tran_low_t *coeff_ptr, intptr_t n_coeffs,
+                         const int16_t *zbin_ptr, const int16_t *round_ptr,
+                         const int16_t *quant_ptr,
+                         const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+                         tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr,
+                         uint16_t *eob_ptr, const int16_t *scan,
+                         const int16_t *iscan, const qm_val_t *qm_ptr,
+                         const qm_val_t *iqm_ptr, int log_scale) {
+  (void)scan;
+  quantize_qm_avx2(coeff_ptr, n_coeffs, zbin_ptr, round_ptr, quant_ptr,
+                   quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr, dequant_ptr,
+                   eob_ptr, iscan, qm_ptr, iqm_ptr, log_scale, 0, 1);
+}
+
+void av1_quantize_fp_qm_avx2(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, const int16_t *zbin_ptr,
+    const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan, const int16_t *iscan, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr, int log_scale) {
+  (void)scan;
+  quantize_qm_avx2(coeff_ptr, n_coeffs, zbin_ptr, round_ptr, quant_ptr,
+                   quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr, dequant_ptr,
+                   eob_ptr, iscan, qm_ptr, iqm_ptr, log_scale, 1, 1);
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+void av1_highbd_quantize_b_avx2(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, const int16_t *zbin_ptr,
+    const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan, const int16_t *iscan, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr, int log_scale) {
+  (void)scan;
+  quantize_qm_avx2(coeff_ptr, n_coeffs, zbin_ptr, round_ptr, quant_ptr,
+                   quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr, dequant_ptr,
+                   eob_ptr, iscan, qm_ptr, iqm_ptr, log_scale, 0, 0);
+}
+
+void av1_highbd_quantize_fp_qm_avx2(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, const int16_t *zbin_ptr,
+    const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan, const int16_t *iscan, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr, int log_scale) {
+  (void)scan;
+  quantize_qm_avx2(coeff_ptr, n_coeffs, zbin_ptr, round_ptr, quant_ptr,
+                   quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr, dequant_ptr,
+                   eob_ptr, iscan, qm_ptr, iqm_ptr, log_scale, 1, 0);
+}
+#endif  // CONFIG_AV1_HIGHBITDEPTH
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <smmintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/x86/synonyms.h"
+
+// Returns floor(a * b / 2^shift) for each signed 32-bit lane, with the
+// products computed on 64 bits. shift_lo holds shift and shift_hi holds
+// 32 - shift, with 0 < shift <= 32. The results must fit in 32 bits.
+static INLINE __m128i mul_shift_epi32(__m128i a, __m128i b, __m128i shift_lo,
+                                      __m128i shift_hi) {
+  const __m128i even = _mm_mul_epi32(a, b);
+  const __m128i odd =
+      _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_blend_epi16(_mm_srl_epi64(even, shift_lo),
+                         _mm_sll_epi64(odd, shift_hi), 0xcc);
+}
+
+static INLINE __m128i set_dc_ac_epi32(int dc, int ac) {
+  return _mm_setr_epi32(dc, ac, ac, ac);
+}
+
+// Quantizes n_coeffs coefficients in raster order with the weights of a
+// quantization matrix. Matches quantize_fp_helper_c() when is_fp is set and
+// aom_quantize_b_helper_c() otherwise, for the lowbd (clamp_to_int16) and
+// highbd versions: the coefficients are quantized independently of each
+// other, so the scan order only matters for the eob.
+static INLINE void quantize_qm_sse4_1(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, const int16_t *zbin_ptr,
+    const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *iscan, const qm_val_t *qm_ptr, const qm_val_t *iqm_ptr,
+    int log_scale, int is_fp, int clamp_to_int16) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i int16_max = _mm_set1_epi32(INT16_MAX);
+  const __m128i qm_round = _mm_set1_epi32(1 << (AOM_QM_BITS - 1));
+  const int shift = 16 - log_scale + AOM_QM_BITS;
+  const __m128i shift_lo = _mm_cvtsi32_si128(shift);
+  const __m128i shift_hi = _mm_cvtsi32_si128(32 - shift);
+  const __m128i shift16 = _mm_cvtsi32_si128(16);
+  const __m128i log_scale_count = _mm_cvtsi32_si128(log_scale);
+  __m128i eob = zero;
+  assert(qm_ptr != NULL && iqm_ptr != NULL);
+  assert(n_coeffs % 4 == 0);
+
+  // Lane 0 holds the DC parameters and the other lanes the AC parameters.
+  // Coefficients are kept when abs(coeff) * wt > thresh.
+  __m128i thresh, quant_shift;
+  if (is_fp) {
+    const int thresh_shift = AOM_QM_BITS - (1 + log_scale);
+    thresh = set_dc_ac_epi32((dequant_ptr[0] << thresh_shift) - 1,
+                             (dequant_ptr[1] << thresh_shift) - 1);
+    quant_shift = zero;
+  } else {
+    thresh = set_dc_ac_epi32(
+        (ROUND_POWER_OF_TWO(zbin_ptr[0], log_scale) << AOM_QM_BITS) - 1,
+        (ROUND_POWER_OF_TWO(zbin_ptr[1], log_scale) << AOM_QM_BITS) - 1);
+    quant_shift = set_dc_ac_epi32(quant_shift_ptr[0], quant_shift_ptr[1]);
+  }
+  __m128i round = set_dc_ac_epi32(ROUND_POWER_OF_TWO(round_ptr[0], log_scale),
+                                  ROUND_POWER_OF_TWO(round_ptr[1], log_scale));
+  __m128i quant = set_dc_ac_epi32(quant_ptr[0], quant_ptr[1]);
+  __m128i dequant = set_dc_ac_epi32(dequant_ptr[0], dequant_ptr[1]);
+
+  for (intptr_t i = 0; i < n_coeffs; i += 4) {
+    const __m128i coeff = xx_loadu_128(coeff_ptr + i);
+    const __m128i wt = _mm_cvtepu8_epi32(xx_loadl_32(qm_ptr + i));
+    const __m128i abs_coeff = _mm_abs_epi32(coeff);
+    const __m128i keep =
+        _mm_cmpgt_epi32(_mm_mullo_epi32(abs_coeff, wt), thresh);
+    if (_mm_movemask_epi8(keep)) {
+      __m128i tmp = _mm_add_epi32(abs_coeff, round);
+      if (clamp_to_int16) tmp = _mm_min_epi32(tmp, int16_max);
+      const __m128i tmpw = _mm_mullo_epi32(tmp, wt);
+      __m128i abs_q;
+      if (is_fp) {
+        abs_q = mul_shift_epi32(tmpw, quant, shift_lo, shift_hi);
+      } else {
+        const __m128i tmp2 = _mm_add_epi32(
+            mul_shift_epi32(tmpw, quant, shift16, shift16), tmpw);
+        abs_q = mul_shift_epi32(tmp2, quant_shift, shift_lo, shift_hi);
+      }
+      const __m128i iwt = _mm_cvtepu8_epi32(xx_loadl_32(iqm_ptr + i));
+      const __m128i dq = _mm_srai_epi32(
+          _mm_add_epi32(_mm_mullo_epi32(dequant, iwt), qm_round), AOM_QM_BITS);
+      const __m128i abs_dq =
+          _mm_sra_epi32(_mm_mullo_epi32(abs_q, dq), log_scale_count);
+      xx_storeu_128(qcoeff_ptr + i,
+                    _mm_sign_epi32(_mm_and_si128(keep, abs_q), coeff));
+      xx_storeu_128(dqcoeff_ptr + i,
+                    _mm_sign_epi32(_mm_and_si128(keep, abs_dq), coeff));
+
+      const __m128i nz = _mm_andnot_si128(_mm_cmpeq_epi32(abs_q, zero), keep);
+      const __m128i scan_pos =
+          _mm_add_epi32(_mm_cvtepi16_epi32(xx_loadl_64(iscan + i)), one);
+      eob = _mm_max_epi32(eob, _mm_and_si128(nz, scan_pos));
+    } else {
+      xx_storeu_128(qcoeff_ptr + i, zero);
+      xx_storeu_128(dqcoeff_ptr + i, zero);
+    }
+    // Switch to the AC parameters.
+    thresh = _mm_shuffle_epi32(thresh, 0x55);
+    round = _mm_shuffle_epi32(round, 0x55);
+    quant = _mm_shuffle_epi32(quant, 0x55);
+    quant_shift = _mm_shuffle_epi32(quant_shift, 0x55);
+    dequant = _mm_shuffle_epi32(dequant, 0x55);
+  }
+
+  eob = _mm_max_epi32(eob, _mm_srli_si128(eob, 8));
+  eob = _mm_max_epi32(eob, _mm_srli_si128(eob, 4));
+  *eob_ptr = (uint16_t)_mm_cvtsi128_si32(eob);
+}
+
+void av1_quantize_b_sse4_1(const tran_low_t *coeff_ptr, intptr_t n_coeffs,
+                           const int16_t *zbin_ptr, const int16_t *round_ptr,
+                           const int16_t *quant_ptr,
+                           const int16_t *quant_shift_ptr,
+                           tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr,
+                           const int16_t *dequant_ptr, uint16_t *eob_ptr,
+                           const int16_t *scan, const int16_t *iscan,
+                           const qm_val_t *qm_ptr, const qm_val_t *iqm_ptr,
+                           int log_scale) {
+  (void)scan;
+  quantize_qm_sse4_1(coeff_ptr, n_coeffs, zbin_ptr, round_ptr, quant_ptr,
+                     quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr, dequant_ptr,
+                     eob_ptr, iscan, qm_ptr, iqm_ptr, log_scale, 0, 1);
+}
+
+void av1_quantize_fp_qm_sse4_1(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, const int16_t *zbin_ptr,
+    const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan, const int16_t *iscan, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr, int log_scale) {
+  (void)scan;
+  quantize_qm_sse4_1(coeff_ptr, n_coeffs, zbin_ptr, round_ptr, quant_ptr,
+                     quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr, dequant_ptr,
+                     eob_ptr, iscan, qm_ptr, iqm_ptr, log_scale, 1, 1);
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+void av1_highbd_quantize_b_sse4_1(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, const int16_t *zbin_ptr,
+    const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan, const int16_t *iscan, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr, int log_scale) {
+  (void)scan;
+  quantize_qm_sse4_1(coeff_ptr, n_coeffs, zbin_ptr, round_ptr, quant_ptr,
+                     quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr, dequant_ptr,
+                     eob_ptr, iscan, qm_ptr, iqm_ptr, log_scale, 0, 0);
+}
+
+void av1_highbd_quantize_fp_qm_sse4_1(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, const int16_t *zbin_ptr,
+    const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan, const int16_t *iscan, const qm_val_t *qm_ptr,
+    const qm_val_t *iqm_ptr, int log_scale) {
+  (void)scan;
+  quantize_qm_sse4_1(coeff_ptr, n_coeffs, zbin_ptr, round_ptr, quant_ptr,
+                     quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr, dequant_ptr,
+                     eob_ptr, iscan, qm_ptr, iqm_ptr, log_scale, 1, 0);
+}
+#endif  // CONFIG_AV1_HIGHBITDEPTH
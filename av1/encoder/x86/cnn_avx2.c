@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "av1/encoder/cnn.h"
+#include "av1/encoder/x86/cnn_x86.h"
+
+static void convolve_channels_avx2(const float *x, const int *woff,
+                                   int num_taps, const float *weights,
+                                   const float *bias, int ch, int ch_end,
+                                   float **output, int out_index) {
+  int c = ch;
+  // The products are not fused into the sums (no FMA), so that the output is
+  // bit-exact with av1_cnn_convolve_c() and encoder decisions do not depend on
+  // the instruction set.
+  for (; c + 8 <= ch_end; c += 8) {
+    DECLARE_ALIGNED(32, float, res[8]);
+    __m256 sum = _mm256_loadu_ps(bias + c);
+    for (int t = 0; t < num_taps; ++t) {
+      const __m256 w = _mm256_loadu_ps(weights + woff[t] + c);
+      sum = _mm256_add_ps(sum, _mm256_mul_ps(w, _mm256_set1_ps(x[t])));
+    }
+    _mm256_store_ps(res, sum);
+    for (int j = 0; j < 8; ++j) output[c + j][out_index] = res[j];
+  }
+  if (c + 4 <= ch_end) {
+    DECLARE_ALIGNED(16, float, res[4]);
+    __m128 sum = _mm_loadu_ps(bias + c);
+    for (int t = 0; t < num_taps; ++t) {
+      const __m128 w = _mm_loadu_ps(weights + woff[t] + c);
+      sum = _mm_add_ps(sum, _mm_mul_ps(w, _mm_set1_ps(x[t])));
+    }
+    _mm_store_ps(res, sum);
+    for (int j = 0; j < 4; ++j) output[c + j][out_index] = res[j];
+    c += 4;
+  }
+  for (; c < ch_end; ++c) {
+    float sum = bias[c];
+    for (int t = 0; t < num_taps; ++t) sum += weights[woff[t] + c] * x[t];
+    output[c][out_index] = sum;
+  }
+}
+
+void av1_cnn_convolve_avx2(const float **input, int in_width, int in_height,
+                           int in_stride, const CNN_LAYER_CONFIG *layer_config,
+                           float **output, int out_stride, int start_idx,
+                           int step) {
+  if (!cnn_convolve_simd_supported(layer_config)) {
+    av1_cnn_convolve_c(input, in_width, in_height, in_stride, layer_config,
+                       output, out_stride, start_idx, step);
+    return;
+  }
+  cnn_convolve_by_channels(input, in_width, in_height, in_stride, layer_config,
+                           output, out_stride, start_idx, step, 8,
+                           convolve_channels_avx2);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_ENCODER_X86_CNN_X86_H_
+#define AOM_AV1_ENCODER_X86_CNN_X86_H_
+
+#include <assert.h>
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_mem/aom_mem.h"
+#include "av1/encoder/cnn.h"
+
+// Number of filter taps per output sample that are gathered on the stack.
+#define CNN_CONVOLVE_STACK_TAPS 256
+
+// Computes output channels [ch, ch_end) of a single output sample from the
+// gathered filter taps:
+//   output[c][out_index] = bias[c] + sum_t(weights[woff[t] + c] * x[t]).
+// The taps must be accumulated in order for the result to match the C code.
+typedef void (*cnn_convolve_channels_fn)(const float *x, const int *woff,
+                                         int num_taps, const float *weights,
+                                         const float *bias, int ch, int ch_end,
+                                         float **output, int out_index);
+
+// Convolution driver shared by the SIMD versions of av1_cnn_convolve(). The
+// weights are laid out with the output channel innermost, so for each output
+// sample the input taps are gathered once, in the order av1_cnn_convolve_c()
+// accumulates them, and convolve_channels() then vectorizes across output
+// channels. With step > 1 the work is split between threads as in the C code:
+// by output column for 1x1 filters, and by blocks of num_lanes output channels
+// otherwise.
+static INLINE void cnn_convolve_by_channels(
+    const float **input, int in_width, int in_height, int in_stride,
+    const CNN_LAYER_CONFIG *layer_config, float **output, int out_stride,
+    int start_idx, int step, int num_lanes,
+    cnn_convolve_channels_fn convolve_channels) {
+  const int filter_height = layer_config->filter_height;
+  const int filter_width = layer_config->filter_width;
+  const int skip_height = layer_config->skip_height;
+  const int skip_width = layer_config->skip_width;
+  const int in_channels = layer_config->in_channels;
+  const int out_channels = layer_config->out_channels;
+  const int cstep = in_channels * out_channels;
+  const int channel_step = AOMMAX(step, 1);
+  const int max_taps = in_channels * filter_height * filter_width;
+  float x_buf[CNN_CONVOLVE_STACK_TAPS];
+  int woff_buf[CNN_CONVOLVE_STACK_TAPS];
+  const int use_heap = max_taps > CNN_CONVOLVE_STACK_TAPS;
+  float *x = use_heap ? (float *)aom_malloc(sizeof(*x) * max_taps) : x_buf;
+  int *woff =
+      use_heap ? (int *)aom_malloc(sizeof(*woff) * max_taps) : woff_buf;
+
+  assert(!layer_config->deconvolve);
+  if (!x || !woff) {
+    aom_free(x);
+    aom_free(woff);
+    av1_cnn_convolve_c(input, in_width, in_height, in_stride, layer_config,
+                       output, out_stride, start_idx, step);
+    return;
+  }
+
+  if (filter_height == 1 && filter_width == 1) {
+    const int start_h = get_start_shift_convolve(in_height, 1, skip_height);
+    const int start_w = get_start_shift_convolve(in_width, 1, skip_width) +
+                        start_idx * skip_width;
+    const int in_w_step = skip_width * channel_step;
+    for (int k = 0; k < in_channels; ++k) woff[k] = k * out_channels;
+    for (int h = start_h, u = 0; h < in_height; h += skip_height, ++u) {
+      const int in_h = h * in_stride;
+      for (int w = start_w, out_index = u * out_stride + start_idx;
+           w < in_width; w += in_w_step, out_index += channel_step) {
+        for (int k = 0; k < in_channels; ++k) x[k] = input[k][in_h + w];
+        convolve_channels(x, woff, in_channels, layer_config->weights,
+                          layer_config->bias, 0, out_channels, output,
+                          out_index);
+      }
+    }
+  } else {
+    // (first_h, first_w) is the top left corner of the first filter window,
+    // which may lie outside of the image with "same" padding.
+    int first_h, end_h, first_w, end_w;
+    if (layer_config->pad == PADDING_VALID) {
+      first_h = 0;
+      first_w = 0;
+      end_h = in_height - filter_height + 1;
+      end_w = in_width - filter_width + 1;
+    } else {
+      assert(layer_config->pad == PADDING_SAME_ZERO ||
+             layer_config->pad == PADDING_SAME_REPLICATE);
+      const int ii_shift = (filter_height >> 1) - (filter_height - 1) % 2;
+      const int jj_shift = (filter_width >> 1) - (filter_width - 1) % 2;
+      first_h =
+          get_start_shift_convolve(in_height, filter_height, skip_height) -
+          ii_shift;
+      first_w = get_start_shift_convolve(in_width, filter_width, skip_width) -
+                jj_shift;
+      end_h = in_height - ii_shift;
+      end_w = in_width - jj_shift;
+    }
+    const int zero_pad = layer_config->pad == PADDING_SAME_ZERO;
+    const int num_blocks = (out_channels + num_lanes - 1) / num_lanes;
+    for (int h = first_h, u = 0; h < end_h; h += skip_height, ++u) {
+      for (int w = first_w, out_index = u * out_stride; w < end_w;
+           w += skip_width, ++out_index) {
+        int num_taps = 0;
+        for (int k = 0; k < in_channels; ++k) {
+          for (int l = 0; l < filter_height; ++l) {
+            int ii = h + l;
+            if (ii < 0 || ii >= in_height) {
+              if (zero_pad) continue;
+              ii = ii < 0 ? 0 : in_height - 1;
+            }
+            for (int m = 0; m < filter_width; ++m) {
+              int jj = w + m;
+              if (jj < 0 || jj >= in_width) {
+                if (zero_pad) continue;
+                jj = jj < 0 ? 0 : in_width - 1;
+              }
+              x[num_taps] = input[k][ii * in_stride + jj];
+              woff[num_taps] = (l * filter_width + m) * cstep +
+                               k * out_channels;
+              ++num_taps;
+            }
+          }
+        }
+        for (int b = start_idx; b < num_blocks; b += channel_step) {
+          convolve_channels(x, woff, num_taps, layer_config->weights,
+                            layer_config->bias, b * num_lanes,
+                            AOMMIN(out_channels, (b + 1) * num_lanes), output,
+                            out_index);
+        }
+      }
+    }
+  }
+
+  if (use_heap) {
+    aom_free(x);
+    aom_free(woff);
+  }
+}
+
+// Returns whether the SIMD versions of av1_cnn_convolve() can process the
+// layer; maxpooling layers are left to av1_cnn_convolve_c().
+static INLINE int cnn_convolve_simd_supported(
+    const CNN_LAYER_CONFIG *layer_config) {
+  return !(layer_config->maxpool &&
+           (layer_config->skip_height > 1 || layer_config->skip_width > 1));
+}
+
+#endif  // AOM_AV1_ENCODER_X86_CNN_X86_H_
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>  // AVX512
+
+#include "config/av1_rtcd.h"
+
+#include "aom/aom_integer.h"
+
+// Like the AVX2 version, saturates the coefficients to 16 bits and sums the
+// squares with madd. The order of the coefficients does not matter, so the
+// pack needs no permute.
+static INLINE void block_error_kernel(const __m512i coeff,
+                                      const __m512i dqcoeff,
+                                      __m512i *const sse, __m512i *const ssz) {
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i diff = _mm512_sub_epi16(dqcoeff, coeff);
+  const __m512i diff_sq = _mm512_madd_epi16(diff, diff);
+  const __m512i coeff_sq = _mm512_madd_epi16(coeff, coeff);
+  // The squares are unsigned, expand them to 64 bits.
+  *sse = _mm512_add_epi64(*sse, _mm512_unpacklo_epi32(diff_sq, zero));
+  *sse = _mm512_add_epi64(*sse, _mm512_unpackhi_epi32(diff_sq, zero));
+  *ssz = _mm512_add_epi64(*ssz, _mm512_unpacklo_epi32(coeff_sq, zero));
+  *ssz = _mm512_add_epi64(*ssz, _mm512_unpackhi_epi32(coeff_sq, zero));
+}
+
+static INLINE __m512i read_coeff_32(const tran_low_t *coeff) {
+  return _mm512_packs_epi32(_mm512_loadu_si512((const void *)coeff),
+                            _mm512_loadu_si512((const void *)(coeff + 16)));
+}
+
+// Reads 16 coefficients, the upper half of the result being zero.
+static INLINE __m512i read_coeff_16(const tran_low_t *coeff) {
+  const __m256i c = _mm512_cvtsepi32_epi16(
+      _mm512_loadu_si512((const void *)coeff));
+  return _mm512_inserti64x4(_mm512_setzero_si512(), c, 0);
+}
+
+int64_t av1_block_error_avx512(const tran_low_t *coeff,
+                               const tran_low_t *dqcoeff, intptr_t block_size,
+                               int64_t *ssz) {
+  __m512i sse_reg = _mm512_setzero_si512();
+  __m512i ssz_reg = _mm512_setzero_si512();
+  intptr_t i = 0;
+
+  for (; i + 32 <= block_size; i += 32) {
+    block_error_kernel(read_coeff_32(coeff + i), read_coeff_32(dqcoeff + i),
+                       &sse_reg, &ssz_reg);
+  }
+  if (i < block_size) {
+    // 4x4 blocks have only 16 coefficients.
+    block_error_kernel(read_coeff_16(coeff + i), read_coeff_16(dqcoeff + i),
+                       &sse_reg, &ssz_reg);
+  }
+
+  *ssz = _mm512_reduce_add_epi64(ssz_reg);
+  return _mm512_reduce_add_epi64(sse_reg);
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/temporal_filter.h"
+#include "av1/encoder/x86/temporal_filter_constants.h"
+
+// Multipliers replicating the division by the number of summed values, see
+// temporal_filter_constants.h. 12 values are never summed.
+static const uint32_t highbd_neighbor_constants[14] = {
+  0,
+  0,
+  0,
+  0,
+  HIGHBD_NEIGHBOR_CONSTANT_4,
+  HIGHBD_NEIGHBOR_CONSTANT_5,
+  HIGHBD_NEIGHBOR_CONSTANT_6,
+  HIGHBD_NEIGHBOR_CONSTANT_7,
+  HIGHBD_NEIGHBOR_CONSTANT_8,
+  HIGHBD_NEIGHBOR_CONSTANT_9,
+  HIGHBD_NEIGHBOR_CONSTANT_10,
+  HIGHBD_NEIGHBOR_CONSTANT_11,
+  0,
+  HIGHBD_NEIGHBOR_CONSTANT_13,
+};
+
+// Sets the multipliers of a row of width pixels, which sum the distortions of
+// their 3x3 neighborhood plus num_extra values. mult[0] is used for the top
+// and bottom rows and mult[1] for the other rows.
+static void highbd_set_neighbor_mult(int width, int num_extra,
+                                     uint32_t mult[2][BW]) {
+  for (int j = 0; j < width; ++j) {
+    const int num_cols = 3 - (j == 0) - (j == width - 1);
+    mult[0][j] = highbd_neighbor_constants[2 * num_cols + num_extra];
+    mult[1][j] = highbd_neighbor_constants[3 * num_cols + num_extra];
+  }
+}
+
+// Computes the squared differences of a width x height block into dist, with
+// a border of zeros around them.
+static void highbd_store_dist(const uint16_t *src, int src_stride,
+                              const uint16_t *pre, int pre_stride, int width,
+                              int height, uint32_t *dist) {
+  memset(dist, 0, (width + 2) * sizeof(*dist));
+  for (int i = 0; i < height; ++i) {
+    uint32_t *const dist_row = dist + (i + 1) * DIST_STRIDE + 1;
+    for (int j = 0; j < width; j += 8) {
+      const __m256i a = _mm256_cvtepu16_epi32(xx_loadu_128(src + j));
+      const __m256i b = _mm256_cvtepu16_epi32(xx_loadu_128(pre + j));
+      const __m256i diff = _mm256_sub_epi32(a, b);
+      yy_storeu_256(dist_row + j, _mm256_mullo_epi32(diff, diff));
+    }
+    dist_row[-1] = 0;
+    dist_row[width] = 0;
+    src += src_stride;
+    pre += pre_stride;
+  }
+  memset(dist + (height + 1) * DIST_STRIDE, 0, (width + 2) * sizeof(*dist));
+}
+
+// Returns the sums of three horizontally adjacent distortions for 8 pixels.
+// dist points to the left neighbor of the first pixel.
+static INLINE __m256i highbd_sum_row_3(const uint32_t *dist) {
+  const __m256i left = yy_loadu_256(dist);
+  const __m256i center = yy_loadu_256(dist + 1);
+  const __m256i right = yy_loadu_256(dist + 2);
+  return _mm256_add_epi32(_mm256_add_epi32(left, center), right);
+}
+
+// Returns the filter weights of the 8 pixels starting at column col, in the
+// top or bottom half of a row of width pixels.
+static INLINE __m256i highbd_get_weights(const int *blk_fw, int use_whole_blk,
+                                         int bottom, int col, int width) {
+  if (use_whole_blk) return _mm256_set1_epi32(blk_fw[0]);
+  return _mm256_set1_epi32(blk_fw[2 * bottom + (col >= width / 2)]);
+}
+
+// Computes the modifiers of 8 pixels from their summed distortions as
+// highbd_mod_index() does: divide by the number of summed values, round,
+// shift by the strength, clamp to 16, invert and multiply by the filter
+// weight. The sums are small enough not to need the clamp to INT32_MAX.
+static INLINE __m256i highbd_get_modifier(__m256i sum, __m256i mult,
+                                          __m256i rounding, __m128i strength,
+                                          __m256i weight) {
+  const __m256i sixteen = _mm256_set1_epi32(16);
+  // (sum * mult) >> 32 on unsigned 32-bit lanes.
+  const __m256i prod_even = _mm256_mul_epu32(sum, mult);
+  const __m256i prod_odd = _mm256_mul_epu32(_mm256_srli_epi64(sum, 32),
+                                            _mm256_srli_epi64(mult, 32));
+  __m256i mod =
+      _mm256_blend_epi32(_mm256_srli_epi64(prod_even, 32), prod_odd, 0xaa);
+  mod = _mm256_add_epi32(mod, rounding);
+  mod = _mm256_srl_epi32(mod, strength);
+  mod = _mm256_min_epi32(mod, sixteen);
+  mod = _mm256_sub_epi32(sixteen, mod);
+  return _mm256_mullo_epi32(mod, weight);
+}
+
+// Adds the modifiers of 8 pixels to count, and the modifiers times the
+// predicted pixels to accumulator.
+static INLINE void highbd_accumulate_and_store_8(__m256i mod,
+                                                 const uint16_t *pred,
+                                                 uint16_t *count,
+                                                 uint32_t *accumulator) {
+  const __m256i pred_u32 = _mm256_cvtepu16_epi32(xx_loadu_128(pred));
+  const __m128i mod_u16 = _mm_packus_epi32(_mm256_castsi256_si128(mod),
+                                           _mm256_extracti128_si256(mod, 1));
+  xx_storeu_128(count, _mm_add_epi16(xx_loadu_128(count), mod_u16));
+  yy_storeu_256(accumulator,
+                _mm256_add_epi32(yy_loadu_256(accumulator),
+                                 _mm256_mullo_epi32(mod, pred_u32)));
+}
+
+void av1_highbd_apply_temporal_filter_avx2(
+    const uint8_t *yf, int y_src_stride, const uint8_t *yp, int y_pre_stride,
+    const uint8_t *uf, const uint8_t *vf, int uv_src_stride, const uint8_t *up,
+    const uint8_t *vp, int uv_pre_stride, unsigned int block_width,
+    unsigned int block_height, int ss_x, int ss_y, int strength,
+    const int *blk_fw, int use_whole_blk, uint32_t *y_accum,
+    uint16_t *y_count, uint32_t *u_accum, uint16_t *u_count,
+    uint32_t *v_accum, uint16_t *v_count) {
+  const uint16_t *y_src = CONVERT_TO_SHORTPTR(yf);
+  const uint16_t *u_src = CONVERT_TO_SHORTPTR(uf);
+  const uint16_t *v_src = CONVERT_TO_SHORTPTR(vf);
+  const uint16_t *y_pre = CONVERT_TO_SHORTPTR(yp);
+  const uint16_t *u_pre = CONVERT_TO_SHORTPTR(up);
+  const uint16_t *v_pre = CONVERT_TO_SHORTPTR(vp);
+  const int width = block_width, height = block_height;
+  const int uv_width = width >> ss_x, uv_height = height >> ss_y;
+
+  assert(block_width <= BW && "block width too large");
+  assert(block_height <= BH && "block height too large");
+  assert(block_width % 16 == 0 && "block width must be multiple of 16");
+  assert(block_height % 2 == 0 && "block height must be even");
+  assert((ss_x == 0 || ss_x == 1) && (ss_y == 0 || ss_y == 1) &&
+         "invalid chroma subsampling");
+  assert(strength >= 0 && strength <= 14 &&
+         "invalid adjusted temporal filter strength");
+
+  DECLARE_ALIGNED(32, uint32_t, y_dist[(BH + 2) * DIST_STRIDE]);
+  DECLARE_ALIGNED(32, uint32_t, u_dist[(BH + 2) * DIST_STRIDE]);
+  DECLARE_ALIGNED(32, uint32_t, v_dist[(BH + 2) * DIST_STRIDE]);
+  DECLARE_ALIGNED(32, uint32_t, y_mult[2][BW]);
+  DECLARE_ALIGNED(32, uint32_t, uv_mult[2][BW]);
+  const __m256i rounding = _mm256_set1_epi32((1 << strength) >> 1);
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+
+  highbd_store_dist(y_src, y_src_stride, y_pre, y_pre_stride, width, height,
+                    y_dist);
+  highbd_store_dist(u_src, uv_src_stride, u_pre, uv_pre_stride, uv_width,
+                    uv_height, u_dist);
+  highbd_store_dist(v_src, uv_src_stride, v_pre, uv_pre_stride, uv_width,
+                    uv_height, v_dist);
+  // Luma pixels also sum the u and v distortions of their chroma pixel, and
+  // chroma pixels the distortions of their luma pixels.
+  highbd_set_neighbor_mult(width, 2, y_mult);
+  highbd_set_neighbor_mult(uv_width, (1 + ss_x) * (1 + ss_y), uv_mult);
+
+  // Luma, column by column so that the sums of three distortions of each row
+  // are computed only once.
+  for (int col = 0; col < width; col += 8) {
+    const __m256i weights[2] = {
+      highbd_get_weights(blk_fw, use_whole_blk, 0, col, width),
+      highbd_get_weights(blk_fw, use_whole_blk, 1, col, width)
+    };
+    const uint32_t *dist = y_dist + col;
+    __m256i sum_above = highbd_sum_row_3(dist);
+    __m256i sum_center = highbd_sum_row_3(dist + DIST_STRIDE);
+    for (int row = 0; row < height; ++row) {
+      dist += DIST_STRIDE;
+      const __m256i sum_below = highbd_sum_row_3(dist + DIST_STRIDE);
+      __m256i sum =
+          _mm256_add_epi32(_mm256_add_epi32(sum_above, sum_center), sum_below);
+
+      const int uv_offset =
+          ((row >> ss_y) + 1) * DIST_STRIDE + (col >> ss_x) + 1;
+      if (ss_x) {
+        const __m128i uv = _mm_add_epi32(xx_loadu_128(u_dist + uv_offset),
+                                         xx_loadu_128(v_dist + uv_offset));
+        const __m256i uv_sum = _mm256_cvtepu32_epi64(uv);
+        sum = _mm256_add_epi32(
+            sum, _mm256_or_si256(uv_sum, _mm256_slli_epi64(uv_sum, 32)));
+      } else {
+        sum = _mm256_add_epi32(sum, yy_loadu_256(u_dist + uv_offset));
+        sum = _mm256_add_epi32(sum, yy_loadu_256(v_dist + uv_offset));
+      }
+
+      const __m256i mult =
+          yy_load_256(y_mult[row > 0 && row < height - 1] + col);
+      const __m256i mod = highbd_get_modifier(sum, mult, rounding, shift,
+                                              weights[row >= height / 2]);
+      highbd_accumulate_and_store_8(mod, y_pre + row * y_pre_stride + col,
+                                    y_count + row * width + col,
+                                    y_accum + row * width + col);
+
+      sum_above = sum_center;
+      sum_center = sum_below;
+    }
+  }
+
+  // Chroma.
+  for (int col = 0; col < uv_width; col += 8) {
+    const __m256i weights[2] = {
+      highbd_get_weights(blk_fw, use_whole_blk, 0, col, uv_width),
+      highbd_get_weights(blk_fw, use_whole_blk, 1, col, uv_width)
+    };
+    const uint32_t *u = u_dist + col, *v = v_dist + col;
+    __m256i u_above = highbd_sum_row_3(u), v_above = highbd_sum_row_3(v);
+    __m256i u_center = highbd_sum_row_3(u + DIST_STRIDE);
+    __m256i v_center = highbd_sum_row_3(v + DIST_STRIDE);
+    for (int row = 0; row < uv_height; ++row) {
+      u += DIST_STRIDE;
+      v += DIST_STRIDE;
+      const __m256i u_below = highbd_sum_row_3(u + DIST_STRIDE);
+      const __m256i v_below = highbd_sum_row_3(v + DIST_STRIDE);
+
+      // Distortions of the co-located luma pixels.
+      const uint32_t *y =
+          y_dist + ((row << ss_y) + 1) * DIST_STRIDE + (col << ss_x) + 1;
+      __m256i y_sum = yy_loadu_256(y);
+      if (ss_y) y_sum = _mm256_add_epi32(y_sum, yy_loadu_256(y + DIST_STRIDE));
+      if (ss_x) {
+        __m256i y_sum_hi = yy_loadu_256(y + 8);
+        if (ss_y) {
+          y_sum_hi =
+              _mm256_add_epi32(y_sum_hi, yy_loadu_256(y + DIST_STRIDE + 8));
+        }
+        // hadd works within 128-bit lanes.
+        y_sum = _mm256_permute4x64_epi64(_mm256_hadd_epi32(y_sum, y_sum_hi),
+                                         0xd8);
+      }
+
+      const __m256i u_sum = _mm256_add_epi32(
+          _mm256_add_epi32(_mm256_add_epi32(u_above, u_center), u_below),
+          y_sum);
+      const __m256i v_sum = _mm256_add_epi32(
+          _mm256_add_epi32(_mm256_add_epi32(v_above, v_center), v_below),
+          y_sum);
+
+      const __m256i mult =
+          yy_load_256(uv_mult[row > 0 && row < uv_height - 1] + col);
+      const __m256i weight = weights[(row << ss_y) >= height / 2];
+      const __m256i u_mod =
+          highbd_get_modifier(u_sum, mult, rounding, shift, weight);
+      const __m256i v_mod =
+          highbd_get_modifier(v_sum, mult, rounding, shift, weight);
+      highbd_accumulate_and_store_8(u_mod, u_pre + row * uv_pre_stride + col,
+                                    u_count + row * uv_width + col,
+                                    u_accum + row * uv_width + col);
+      highbd_accumulate_and_store_8(v_mod, v_pre + row * uv_pre_stride + col,
+                                    v_count + row * uv_width + col,
+                                    v_accum + row * uv_width + col);
+
+      u_above = u_center;
+      u_center = u_below;
+      v_above = v_center;
+      v_center = v_below;
+    }
+  }
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+#include <string.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom_ports/mem.h"
+#include "av1/encoder/ml.h"
+
+// Scales the n values of input to NN_Q_INPUT_BITS-bit integers and pads the
+// output with zeros to stride entries. Returns the factor that maps the
+// integers back to the input range. Matches nn_quantize_input() in ml.c.
+static float nn_quantize_input_avx2(const float *input, int n, int stride,
+                                    int16_t *output) {
+  DECLARE_ALIGNED(32, float, padded[NN_Q_MAX_STRIDE]);
+  const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+  memcpy(padded, input, sizeof(*input) * n);
+  memset(padded + n, 0, sizeof(*padded) * (stride - n));
+
+  __m256 max_abs8 = _mm256_setzero_ps();
+  for (int i = 0; i < stride; i += 8) {
+    const __m256 x = _mm256_load_ps(padded + i);
+    max_abs8 = _mm256_max_ps(max_abs8, _mm256_andnot_ps(sign_mask, x));
+  }
+  __m128 max_abs4 = _mm_max_ps(_mm256_castps256_ps128(max_abs8),
+                               _mm256_extractf128_ps(max_abs8, 1));
+  max_abs4 = _mm_max_ps(max_abs4, _mm_movehl_ps(max_abs4, max_abs4));
+  max_abs4 = _mm_max_ss(max_abs4, _mm_shuffle_ps(max_abs4, max_abs4, 1));
+  const float max_abs = _mm_cvtss_f32(max_abs4);
+
+  if (max_abs == 0.0f) {
+    memset(output, 0, sizeof(*output) * stride);
+    return 0.0f;
+  }
+  const float input_max = (float)((1 << NN_Q_INPUT_BITS) - 1);
+  const __m256 scale = _mm256_set1_ps(input_max / max_abs);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  for (int i = 0; i < stride; i += 16) {
+    const __m256 v0 = _mm256_mul_ps(_mm256_load_ps(padded + i), scale);
+    const __m256 v1 = _mm256_mul_ps(_mm256_load_ps(padded + i + 8), scale);
+    // Round half away from zero, as av1_nn_round_to_int() does.
+    const __m256 r0 =
+        _mm256_add_ps(v0, _mm256_or_ps(_mm256_and_ps(v0, sign_mask), half));
+    const __m256 r1 =
+        _mm256_add_ps(v1, _mm256_or_ps(_mm256_and_ps(v1, sign_mask), half));
+    const __m256i q = _mm256_packs_epi32(_mm256_cvttps_epi32(r0),
+                                         _mm256_cvttps_epi32(r1));
+    _mm256_storeu_si256((__m256i *)(output + i),
+                        _mm256_permute4x64_epi64(q, 0xd8));
+  }
+  return max_abs / input_max;
+}
+
+// Returns the partial sums of the dot product of the first stride entries of
+// input and weights.
+static INLINE __m256i dot_product_avx2(const int16_t *input,
+                                       const int16_t *weights, int stride) {
+  __m256i sum = _mm256_setzero_si256();
+  for (int i = 0; i < stride; i += 16) {
+    const __m256i x = _mm256_load_si256((const __m256i *)(input + i));
+    const __m256i w = _mm256_loadu_si256((const __m256i *)(weights + i));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(x, w));
+  }
+  return sum;
+}
+
+static void nn_fc_quantized_avx2(const int16_t *input, const int16_t *weights,
+                                 int stride, int num_outputs, int32_t *output) {
+  int node = 0;
+  // Eight nodes at a time, with the partial sums reduced together.
+  for (; node + 8 <= num_outputs; node += 8) {
+    __m256i s[8];
+    for (int j = 0; j < 8; ++j)
+      s[j] = dot_product_avx2(input, weights + (node + j) * stride, stride);
+    const __m256i s01 = _mm256_hadd_epi32(s[0], s[1]);
+    const __m256i s23 = _mm256_hadd_epi32(s[2], s[3]);
+    const __m256i s45 = _mm256_hadd_epi32(s[4], s[5]);
+    const __m256i s67 = _mm256_hadd_epi32(s[6], s[7]);
+    const __m256i s0123 = _mm256_hadd_epi32(s01, s23);
+    const __m256i s4567 = _mm256_hadd_epi32(s45, s67);
+    const __m256i lo = _mm256_permute2x128_si256(s0123, s4567, 0x20);
+    const __m256i hi = _mm256_permute2x128_si256(s0123, s4567, 0x31);
+    _mm256_storeu_si256((__m256i *)(output + node), _mm256_add_epi32(lo, hi));
+  }
+  for (; node < num_outputs; ++node) {
+    const __m256i sum =
+        dot_product_avx2(input, weights + node * stride, stride);
+    const __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                         _mm256_extracti128_si256(sum, 1));
+    const __m128i sum64 = _mm_add_epi32(sum128, _mm_srli_si128(sum128, 8));
+    const __m128i sum32 = _mm_add_epi32(sum64, _mm_srli_si128(sum64, 4));
+    output[node] = _mm_cvtsi128_si32(sum32);
+  }
+}
+
+void av1_nn_predict_quantized_avx2(const float *input_nodes,
+                                   const NN_CONFIG_Q *const nn_config_q,
+                                   int reduce_prec, float *const output) {
+  DECLARE_ALIGNED(32, int16_t, qinput[NN_Q_MAX_STRIDE]);
+  int32_t acc[NN_MAX_NODES_PER_LAYER];
+  float buf[NN_MAX_NODES_PER_LAYER];
+  const int num_layers = nn_config_q->num_hidden_layers;
+  int num_inputs = nn_config_q->num_inputs;
+
+  for (int layer = 0; layer <= num_layers; ++layer) {
+    const int is_output_layer = layer == num_layers;
+    const int num_nodes = is_output_layer
+                              ? nn_config_q->num_outputs
+                              : nn_config_q->num_hidden_nodes[layer];
+    const int stride = nn_config_q->stride[layer];
+    const float *dequant = nn_config_q->dequant[layer];
+    const float *bias = nn_config_q->bias[layer];
+    float *const output_nodes = is_output_layer ? output : buf;
+    assert(stride % 16 == 0 && stride <= NN_Q_MAX_STRIDE);
+    const float input_dequant =
+        nn_quantize_input_avx2(input_nodes, num_inputs, stride, qinput);
+    nn_fc_quantized_avx2(qinput, nn_config_q->weights[layer], stride,
+                         num_nodes, acc);
+
+    // Same operations, in the same order, as av1_nn_predict_quantized_c().
+    const __m256 in_dequant = _mm256_set1_ps(input_dequant);
+    const __m256 zero = _mm256_setzero_ps();
+    int node = 0;
+    for (; node + 8 <= num_nodes; node += 8) {
+      const __m256i a = _mm256_loadu_si256((const __m256i *)(acc + node));
+      const __m256 d =
+          _mm256_mul_ps(_mm256_loadu_ps(dequant + node), in_dequant);
+      __m256 val = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(a), d),
+                                 _mm256_loadu_ps(bias + node));
+      if (!is_output_layer) val = _mm256_max_ps(val, zero);
+      _mm256_storeu_ps(output_nodes + node, val);
+    }
+    for (; node < num_nodes; ++node) {
+      float val = acc[node] * (dequant[node] * input_dequant) + bias[node];
+      if (!is_output_layer) val = AOMMAX(val, 0.0f);
+      output_nodes[node] = val;
+    }
+    input_nodes = buf;
+    num_inputs = num_nodes;
+  }
+  if (reduce_prec)
+    av1_nn_output_prec_reduce(output, nn_config_q->num_outputs);
+}
+
+// Number of samples evaluated together by av1_nn_predict_batch_avx2().
+#define NN_BATCH_LANES 8
+
+// Computes one fully connected layer for NN_BATCH_LANES samples. The layer
+// inputs and outputs are transposed, with the samples innermost, so that each
+// weight is loaded once for all the samples. The products are accumulated in
+// the same order as in av1_nn_predict_c().
+static void nn_fc_batch_avx2(const float *input, int num_inputs,
+                             const float *weights, const float *bias,
+                             int num_outputs, int relu, float *output) {
+  const __m256 zero = _mm256_setzero_ps();
+  int node = 0;
+  // Eight nodes at a time, to hide the latency of the accumulations.
+  for (; node + 8 <= num_outputs; node += 8) {
+    const float *const w = weights + node * num_inputs;
+    __m256 acc[8];
+    for (int k = 0; k < 8; ++k) acc[k] = _mm256_broadcast_ss(bias + node + k);
+    for (int i = 0; i < num_inputs; ++i) {
+      const __m256 x = _mm256_load_ps(input + i * NN_BATCH_LANES);
+      for (int k = 0; k < 8; ++k) {
+        const __m256 wk = _mm256_broadcast_ss(w + k * num_inputs + i);
+        acc[k] = _mm256_add_ps(acc[k], _mm256_mul_ps(wk, x));
+      }
+    }
+    for (int k = 0; k < 8; ++k) {
+      if (relu) acc[k] = _mm256_max_ps(acc[k], zero);
+      _mm256_store_ps(output + (node + k) * NN_BATCH_LANES, acc[k]);
+    }
+  }
+  for (; node < num_outputs; ++node) {
+    const float *w = weights + node * num_inputs;
+    __m256 acc = _mm256_broadcast_ss(bias + node);
+    for (int i = 0; i < num_inputs; ++i) {
+      const __m256 x = _mm256_load_ps(input + i * NN_BATCH_LANES);
+      acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_broadcast_ss(w + i), x));
+    }
+    if (relu) acc = _mm256_max_ps(acc, zero);
+    _mm256_store_ps(output + node * NN_BATCH_LANES, acc);
+  }
+}
+
+void av1_nn_predict_batch_avx2(const float *input_nodes, int input_stride,
+                               int num_samples,
+                               const NN_CONFIG *const nn_config,
+                               int reduce_prec, float *output,
+                               int output_stride) {
+  DECLARE_ALIGNED(32, float, buf[2][NN_MAX_NODES_PER_LAYER * NN_BATCH_LANES]);
+  const int num_layers = nn_config->num_hidden_layers;
+  const int num_outputs = nn_config->num_outputs;
+  assert(num_layers <= NN_MAX_HIDDEN_LAYERS);
+  if (nn_config->num_inputs > NN_MAX_NODES_PER_LAYER ||
+      num_outputs > NN_MAX_NODES_PER_LAYER) {
+    av1_nn_predict_batch_c(input_nodes, input_stride, num_samples, nn_config,
+                           reduce_prec, output, output_stride);
+    return;
+  }
+
+  for (int s = 0; s < num_samples; s += NN_BATCH_LANES) {
+    const int n = AOMMIN(NN_BATCH_LANES, num_samples - s);
+    const float *const in = input_nodes + s * input_stride;
+    int num_inputs = nn_config->num_inputs;
+    int buf_index = 0;
+    // Transpose the input features. Missing samples are set to zero and their
+    // results are dropped.
+    for (int i = 0; i < num_inputs; ++i) {
+      float *const x = buf[0] + i * NN_BATCH_LANES;
+      int j = 0;
+      for (; j < n; ++j) x[j] = in[j * input_stride + i];
+      for (; j < NN_BATCH_LANES; ++j) x[j] = 0.0f;
+    }
+
+    for (int layer = 0; layer <= num_layers; ++layer) {
+      const int is_output_layer = layer == num_layers;
+      const int num_nodes =
+          is_output_layer ? num_outputs : nn_config->num_hidden_nodes[layer];
+      assert(num_nodes <= NN_MAX_NODES_PER_LAYER);
+      nn_fc_batch_avx2(buf[buf_index], num_inputs, nn_config->weights[layer],
+                       nn_config->bias[layer], num_nodes, !is_output_layer,
+                       buf[1 - buf_index]);
+      num_inputs = num_nodes;
+      buf_index = 1 - buf_index;
+    }
+
+    const float *const y = buf[buf_index];
+    for (int j = 0; j < n; ++j) {
+      float *const out = output + (s + j) * output_stride;
+      for (int node = 0; node < num_outputs; ++node)
+        out[node] = y[node * NN_BATCH_LANES + j];
+      if (reduce_prec) av1_nn_output_prec_reduce(out, num_outputs);
+    }
+  }
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+#include "aom/aom_integer.h"
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/temporal_filter.h"
+#include "av1/encoder/x86/temporal_filter_constants.h"
+
+// Multipliers replicating the division by the number of summed values, see
+// temporal_filter_constants.h. 12 values are never summed.
+static const uint16_t neighbor_constants[14] = {
+  0,
+  0,
+  0,
+  0,
+  (uint16_t)NEIGHBOR_CONSTANT_4,
+  (uint16_t)NEIGHBOR_CONSTANT_5,
+  (uint16_t)NEIGHBOR_CONSTANT_6,
+  (uint16_t)NEIGHBOR_CONSTANT_7,
+  (uint16_t)NEIGHBOR_CONSTANT_8,
+  (uint16_t)NEIGHBOR_CONSTANT_9,
+  (uint16_t)NEIGHBOR_CONSTANT_10,
+  (uint16_t)NEIGHBOR_CONSTANT_11,
+  0,
+  (uint16_t)NEIGHBOR_CONSTANT_13,
+};
+
+// Sets the multipliers of a row of width pixels, which sum the distortions of
+// their 3x3 neighborhood plus num_extra values. mult[0] is used for the top
+// and bottom rows and mult[1] for the other rows.
+static void set_neighbor_mult(int width, int num_extra, uint16_t mult[2][BW]) {
+  for (int j = 0; j < width; ++j) {
+    const int num_cols = 3 - (j == 0) - (j == width - 1);
+    mult[0][j] = neighbor_constants[2 * num_cols + num_extra];
+    mult[1][j] = neighbor_constants[3 * num_cols + num_extra];
+  }
+}
+
+// Stores the squared differences of a row of width pixels to dist, and clears
+// the entries to its left and right.
+static INLINE void store_dist_row(const uint8_t *a, const uint8_t *b,
+                                  int width, uint16_t *dist) {
+  for (int j = 0; j < width; j += 16) {
+    const __m256i a_u16 = _mm256_cvtepu8_epi16(xx_loadu_128(a + j));
+    const __m256i b_u16 = _mm256_cvtepu8_epi16(xx_loadu_128(b + j));
+    const __m256i diff = _mm256_sub_epi16(a_u16, b_u16);
+    yy_storeu_256(dist + j, _mm256_mullo_epi16(diff, diff));
+  }
+  dist[-1] = 0;
+  dist[width] = 0;
+}
+
+// Computes the squared differences of a width x height block into dist, with
+// a border of zeros around them.
+static void store_dist(const uint8_t *src, int src_stride, const uint8_t *pre,
+                       int pre_stride, int width, int height, uint16_t *dist) {
+  memset(dist, 0, (width + 2) * sizeof(*dist));
+  for (int i = 0; i < height; ++i) {
+    store_dist_row(src + i * src_stride, pre + i * pre_stride, width,
+                   dist + (i + 1) * DIST_STRIDE + 1);
+  }
+  memset(dist + (height + 1) * DIST_STRIDE, 0, (width + 2) * sizeof(*dist));
+}
+
+// Returns the sums of three horizontally adjacent distortions for 16 pixels,
+// saturated to 16 bits. dist points to the left neighbor of the first pixel.
+// Since the distortions are not negative, adding saturated sums gives the
+// clamp(sum, 0, UINT16_MAX) of the C code.
+static INLINE __m256i sum_row_3(const uint16_t *dist) {
+  const __m256i left = yy_loadu_256(dist);
+  const __m256i center = yy_loadu_256(dist + 1);
+  const __m256i right = yy_loadu_256(dist + 2);
+  return _mm256_adds_epu16(_mm256_adds_epu16(left, center), right);
+}
+
+// Returns the sums of the horizontal pairs of the 32 values in lo and hi,
+// saturated to 16 bits.
+static INLINE __m256i sum_pairs_epu16(__m256i lo, __m256i hi) {
+  const __m256i mask = _mm256_set1_epi32(0xffff);
+  const __m256i sum_lo =
+      _mm256_add_epi32(_mm256_and_si256(lo, mask), _mm256_srli_epi32(lo, 16));
+  const __m256i sum_hi =
+      _mm256_add_epi32(_mm256_and_si256(hi, mask), _mm256_srli_epi32(hi, 16));
+  // packus works within 128-bit lanes.
+  return _mm256_permute4x64_epi64(_mm256_packus_epi32(sum_lo, sum_hi), 0xd8);
+}
+
+// Returns the 8 values of x, each repeated twice.
+static INLINE __m256i dup_epu16(__m128i x) {
+  const __m256i x_u32 = _mm256_cvtepu16_epi32(x);
+  return _mm256_or_si256(x_u32, _mm256_slli_epi32(x_u32, 16));
+}
+
+// Returns the filter weights of the 16 pixels starting at column col, in the
+// top or bottom half of a row of width pixels.
+static INLINE __m256i get_weights(const int *blk_fw, int use_whole_blk,
+                                  int bottom, int col, int width) {
+  if (use_whole_blk) return _mm256_set1_epi16(blk_fw[0]);
+  const int left = blk_fw[2 * bottom], right = blk_fw[2 * bottom + 1];
+  const int half = width / 2;
+  if (col + 16 <= half) return _mm256_set1_epi16(left);
+  if (col >= half) return _mm256_set1_epi16(right);
+  assert(half - col == 8);
+  return yy_set_m128i(_mm_set1_epi16(right), _mm_set1_epi16(left));
+}
+
+// Computes the modifiers of 16 pixels from their summed distortions as
+// mod_index() does: divide by the number of summed values, round, shift by
+// the strength, clamp to 16, invert and multiply by the filter weight.
+static INLINE __m256i get_modifier(__m256i sum, __m256i mult,
+                                   __m256i rounding, __m128i strength,
+                                   __m256i weight) {
+  const __m256i sixteen = _mm256_set1_epi16(16);
+  __m256i mod = _mm256_mulhi_epu16(sum, mult);
+  mod = _mm256_adds_epu16(mod, rounding);
+  mod = _mm256_srl_epi16(mod, strength);
+  mod = _mm256_min_epu16(mod, sixteen);
+  mod = _mm256_sub_epi16(sixteen, mod);
+  return _mm256_mullo_epi16(mod, weight);
+}
+
+// Adds the modifiers of 16 pixels to count, and the modifiers times the
+// predicted pixels to accumulator.
+static INLINE void accumulate_and_store_16(__m256i mod, const uint8_t *pred,
+                                           uint16_t *count,
+                                           uint32_t *accumulator) {
+  const __m256i pred_u16 = _mm256_cvtepu8_epi16(xx_loadu_128(pred));
+  yy_storeu_256(count, _mm256_add_epi16(yy_loadu_256(count), mod));
+  const __m256i prod = _mm256_mullo_epi16(mod, pred_u16);
+  const __m256i prod_lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(prod));
+  const __m256i prod_hi =
+      _mm256_cvtepu16_epi32(_mm256_extracti128_si256(prod, 1));
+  yy_storeu_256(accumulator,
+                _mm256_add_epi32(yy_loadu_256(accumulator), prod_lo));
+  yy_storeu_256(accumulator + 8,
+                _mm256_add_epi32(yy_loadu_256(accumulator + 8), prod_hi));
+}
+
+void av1_apply_temporal_filter_avx2(
+    const uint8_t *y_src, int y_src_stride, const uint8_t *y_pre,
+    int y_pre_stride, const uint8_t *u_src, const uint8_t *v_src,
+    int uv_src_stride, const uint8_t *u_pre, const uint8_t *v_pre,
+    int uv_pre_stride, unsigned int block_width, unsigned int block_height,
+    int ss_x, int ss_y, int strength, const int *blk_fw, int use_whole_blk,
+    uint32_t *y_accum, uint16_t *y_count, uint32_t *u_accum, uint16_t *u_count,
+    uint32_t *v_accum, uint16_t *v_count) {
+  const int width = block_width, height = block_height;
+  const int uv_width = width >> ss_x, uv_height = height >> ss_y;
+
+  assert(block_width <= BW && "block width too large");
+  assert(block_height <= BH && "block height too large");
+  assert(block_width % 16 == 0 && "block width must be multiple of 16");
+  assert(block_height % 2 == 0 && "block height must be even");
+  assert((ss_x == 0 || ss_x == 1) && (ss_y == 0 || ss_y == 1) &&
+         "invalid chroma subsampling");
+  assert(strength >= 0 && strength <= 6 && "invalid temporal filter strength");
+
+  if (uv_width % 16) {
+    // The chroma rows are processed 16 pixels at a time.
+    av1_apply_temporal_filter_sse4_1(
+        y_src, y_src_stride, y_pre, y_pre_stride, u_src, v_src, uv_src_stride,
+        u_pre, v_pre, uv_pre_stride, block_width, block_height, ss_x, ss_y,
+        strength, blk_fw, use_whole_blk, y_accum, y_count, u_accum, u_count,
+        v_accum, v_count);
+    return;
+  }
+
+  DECLARE_ALIGNED(32, uint16_t, y_dist[(BH + 2) * DIST_STRIDE]);
+  DECLARE_ALIGNED(32, uint16_t, u_dist[(BH + 2) * DIST_STRIDE]);
+  DECLARE_ALIGNED(32, uint16_t, v_dist[(BH + 2) * DIST_STRIDE]);
+  DECLARE_ALIGNED(32, uint16_t, y_mult[2][BW]);
+  DECLARE_ALIGNED(32, uint16_t, uv_mult[2][BW]);
+  const __m256i rounding = _mm256_set1_epi16((1 << strength) >> 1);
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+
+  store_dist(y_src, y_src_stride, y_pre, y_pre_stride, width, height, y_dist);
+  store_dist(u_src, uv_src_stride, u_pre, uv_pre_stride, uv_width, uv_height,
+             u_dist);
+  store_dist(v_src, uv_src_stride, v_pre, uv_pre_stride, uv_width, uv_height,
+             v_dist);
+  // Luma pixels also sum the u and v distortions of their chroma pixel, and
+  // chroma pixels the distortions of their luma pixels.
+  set_neighbor_mult(width, 2, y_mult);
+  set_neighbor_mult(uv_width, (1 + ss_x) * (1 + ss_y), uv_mult);
+
+  // Luma, column by column so that the sums of three distortions of each row
+  // are computed only once.
+  for (int col = 0; col < width; col += 16) {
+    const __m256i weights[2] = { get_weights(blk_fw, use_whole_blk, 0, col,
+                                             width),
+                                 get_weights(blk_fw, use_whole_blk, 1, col,
+                                             width) };
+    const uint16_t *dist = y_dist + col;
+    __m256i sum_above = sum_row_3(dist);
+    __m256i sum_center = sum_row_3(dist + DIST_STRIDE);
+    for (int row = 0; row < height; ++row) {
+      dist += DIST_STRIDE;
+      const __m256i sum_below = sum_row_3(dist + DIST_STRIDE);
+      __m256i sum = _mm256_adds_epu16(_mm256_adds_epu16(sum_above, sum_center),
+                                      sum_below);
+
+      const int uv_offset =
+          ((row >> ss_y) + 1) * DIST_STRIDE + (col >> ss_x) + 1;
+      if (ss_x) {
+        const __m128i uv_sum = _mm_adds_epu16(xx_loadu_128(u_dist + uv_offset),
+                                              xx_loadu_128(v_dist + uv_offset));
+        sum = _mm256_adds_epu16(sum, dup_epu16(uv_sum));
+      } else {
+        sum = _mm256_adds_epu16(sum, yy_loadu_256(u_dist + uv_offset));
+        sum = _mm256_adds_epu16(sum, yy_loadu_256(v_dist + uv_offset));
+      }
+
+      const __m256i mult =
+          yy_load_256(y_mult[row > 0 && row < height - 1] + col);
+      const __m256i mod = get_modifier(sum, mult, rounding, shift,
+                                       weights[row >= height / 2]);
+      accumulate_and_store_16(mod, y_pre + row * y_pre_stride + col,
+                              y_count + row * width + col,
+                              y_accum + row * width + col);
+
+      sum_above = sum_center;
+      sum_center = sum_below;
+    }
+  }
+
+  // Chroma.
+  for (int col = 0; col < uv_width; col += 16) {
+    const __m256i weights[2] = { get_weights(blk_fw, use_whole_blk, 0, col,
+                                             uv_width),
+                                 get_weights(blk_fw, use_whole_blk, 1, col,
+                                             uv_width) };
+    const uint16_t *u = u_dist + col, *v = v_dist + col;
+    __m256i u_above = sum_row_3(u), v_above = sum_row_3(v);
+    __m256i u_center = sum_row_3(u + DIST_STRIDE);
+    __m256i v_center = sum_row_3(v + DIST_STRIDE);
+    for (int row = 0; row < uv_height; ++row) {
+      u += DIST_STRIDE;
+      v += DIST_STRIDE;
+      const __m256i u_below = sum_row_3(u + DIST_STRIDE);
+      const __m256i v_below = sum_row_3(v + DIST_STRIDE);
+
+      // Distortions of the co-located luma pixels.
+      const uint16_t *y =
+          y_dist + ((row << ss_y) + 1) * DIST_STRIDE + (col << ss_x) + 1;
+      __m256i y_sum = yy_loadu_256(y);
+      if (ss_y) y_sum = _mm256_adds_epu16(y_sum, yy_loadu_256(y + DIST_STRIDE));
+      if (ss_x) {
+        __m256i y_sum_hi = yy_loadu_256(y + 16);
+        if (ss_y) {
+          y_sum_hi =
+              _mm256_adds_epu16(y_sum_hi, yy_loadu_256(y + DIST_STRIDE + 16));
+        }
+        y_sum = sum_pairs_epu16(y_sum, y_sum_hi);
+      }
+
+      const __m256i u_sum = _mm256_adds_epu16(
+          _mm256_adds_epu16(_mm256_adds_epu16(u_above, u_center), u_below),
+          y_sum);
+      const __m256i v_sum = _mm256_adds_epu16(
+          _mm256_adds_epu16(_mm256_adds_epu16(v_above, v_center), v_below),
+          y_sum);
+
+      const __m256i mult =
+          yy_load_256(uv_mult[row > 0 && row < uv_height - 1] + col);
+      const __m256i weight = weights[(row << ss_y) >= height / 2];
+      const __m256i u_mod =
+          get_modifier(u_sum, mult, rounding, shift, weight);
+      const __m256i v_mod =
+          get_modifier(v_sum, mult, rounding, shift, weight);
+      accumulate_and_store_16(u_mod, u_pre + row * uv_pre_stride + col,
+                              u_count + row * uv_width + col,
+                              u_accum + row * uv_width + col);
+      accumulate_and_store_16(v_mod, v_pre + row * uv_pre_stride + col,
+                              v_count + row * uv_width + col,
+                              v_accum + row * uv_width + col);
+
+      u_above = u_center;
+      u_center = u_below;
+      v_above = v_center;
+      v_center = v_below;
+    }
+  }
+}
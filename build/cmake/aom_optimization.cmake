@@ -15,6 +15,11 @@ set(AOM_BUILD_CMAKE_AOM_OPTIMIZATION_CMAKE_ 1)
 
 include("${AOM_ROOT}/build/cmake/util.cmake")
 
+# The AVX-512 subsets targeted by the avx512 intrinsics: the ones shared by all
+# the AVX-512 capable x86 processors since Skylake-SP.
+set(AOM_AVX512_INTRIN_FLAGS
+    "-mavx512f -mavx512cd -mavx512bw -mavx512dq -mavx512vl")
+
 # Translate $flag to one which MSVC understands, and write the new flag to the
 # variable named by $translated_flag (or unset it, when MSVC needs no flag).
 function(get_msvc_intrinsic_flag flag translated_flag)
@@ -22,9 +27,12 @@ function(get_msvc_intrinsic_flag flag translated_flag)
     set(${translated_flag} "/arch:AVX" PARENT_SCOPE)
   elseif("${flag}" STREQUAL "-mavx2")
     set(${translated_flag} "/arch:AVX2" PARENT_SCOPE)
+  elseif("${flag}" STREQUAL "${AOM_AVX512_INTRIN_FLAGS}")
+    set(${translated_flag} "/arch:AVX512" PARENT_SCOPE)
   else()
 
-    # MSVC does not need flags for intrinsics flavors other than AVX/AVX2.
+    # MSVC does not need flags for intrinsics flavors other than
+    # AVX/AVX2/AVX-512.
     unset(${translated_flag} PARENT_SCOPE)
   endif()
 endfunction()
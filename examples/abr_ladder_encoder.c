@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+// ABR Ladder Encoder
+// ==================
+//
+// This is an example of encoding one input into several renditions, each with
+// its own resolution and target bitrate, as done for adaptive streaming. It
+// builds upon the twopass_encoder example.
+//
+// Sharing The First Pass
+// ----------------------
+// The first pass statistics are normalized by the number of macroblocks of
+// the frames, so they do not depend on the resolution. The first pass runs
+// once, at the input resolution, and all the renditions use its statistics
+// in their last pass. Since the key frames and the golden frame groups are
+// placed from these statistics, the renditions also get the same GOP
+// structure, which keeps them switchable at the same frames.
+//
+// Encoding The Renditions
+// -----------------------
+// In the last pass, each input frame is read once, scaled to the resolution
+// of each rendition, and passed to the encoders in turn. The renditions at
+// the input resolution use the input frame directly.
+//
+// Each rendition is written to its own IVF file, named after the output
+// prefix, its resolution and its bitrate.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aom/aom_encoder.h"
+#include "aom/aomcx.h"
+#include "av1/common/resize.h"
+#include "common/tools_common.h"
+#include "common/video_writer.h"
+
+#define MAX_RENDITIONS 8
+
+typedef struct {
+  int width;
+  int height;
+  int bitrate;  // kbit/s
+  // The input scaled to the resolution of the rendition.
+  aom_image_t img;
+  aom_codec_ctx_t codec;
+  // The rendition's own copy of the first pass statistics.
+  aom_fixed_buf_t stats;
+  AvxVideoWriter *writer;
+} Rendition;
+
+static const char *exec_name;
+
+void usage_exit(void) {
+  fprintf(stderr,
+          "Usage: %s <width> <height> <infile> <limit> <outfile_prefix> "
+          "<rendition> [<rendition> ...]\n"
+          "Each rendition is given as <width>x<height>:<kbit/s>, up to %d of "
+          "them.\n",
+          exec_name, MAX_RENDITIONS);
+  exit(EXIT_FAILURE);
+}
+
+static void parse_rendition(const char *arg, Rendition *r) {
+  if (sscanf(arg, "%dx%d:%d", &r->width, &r->height, &r->bitrate) != 3 ||
+      r->width <= 0 || r->height <= 0 || (r->width % 2) != 0 ||
+      (r->height % 2) != 0 || r->bitrate <= 0) {
+    die("Invalid rendition: %s", arg);
+  }
+}
+
+static int get_frame_stats(aom_codec_ctx_t *ctx, const aom_image_t *img,
+                           aom_codec_pts_t pts, aom_fixed_buf_t *stats) {
+  int got_pkts = 0;
+  aom_codec_iter_t iter = NULL;
+  const aom_codec_cx_pkt_t *pkt = NULL;
+  const aom_codec_err_t res = aom_codec_encode(ctx, img, pts, 1, 0);
+  if (res != AOM_CODEC_OK) die_codec(ctx, "Failed to get frame stats.");
+
+  while ((pkt = aom_codec_get_cx_data(ctx, &iter)) != NULL) {
+    got_pkts = 1;
+
+    if (pkt->kind == AOM_CODEC_STATS_PKT) {
+      const uint8_t *const pkt_buf = pkt->data.twopass_stats.buf;
+      const size_t pkt_size = pkt->data.twopass_stats.sz;
+      stats->buf = realloc(stats->buf, stats->sz + pkt_size);
+      if (!stats->buf) die("Failed to allocate the first pass statistics.");
+      memcpy((uint8_t *)stats->buf + stats->sz, pkt_buf, pkt_size);
+      stats->sz += pkt_size;
+    }
+  }
+
+  return got_pkts;
+}
+
+static int encode_frame(aom_codec_ctx_t *ctx, const aom_image_t *img,
+                        aom_codec_pts_t pts, AvxVideoWriter *writer) {
+  int got_pkts = 0;
+  aom_codec_iter_t iter = NULL;
+  const aom_codec_cx_pkt_t *pkt = NULL;
+  const aom_codec_err_t res = aom_codec_encode(ctx, img, pts, 1, 0);
+  if (res != AOM_CODEC_OK) die_codec(ctx, "Failed to encode frame.");
+
+  while ((pkt = aom_codec_get_cx_data(ctx, &iter)) != NULL) {
+    got_pkts = 1;
+    if (pkt->kind == AOM_CODEC_CX_FRAME_PKT) {
+      if (!aom_video_writer_write_frame(writer, pkt->data.frame.buf,
+                                        pkt->data.frame.sz,
+                                        pkt->data.frame.pts))
+        die_codec(ctx, "Failed to write compressed frame.");
+    }
+  }
+
+  return got_pkts;
+}
+
+static aom_fixed_buf_t first_pass(aom_image_t *raw, FILE *infile,
+                                  const AvxInterface *encoder,
+                                  const aom_codec_enc_cfg_t *cfg, int limit) {
+  aom_codec_ctx_t codec;
+  int frame_count = 0;
+  aom_fixed_buf_t stats = { NULL, 0 };
+
+  if (aom_codec_enc_init(&codec, encoder->codec_interface(), cfg, 0))
+    die_codec(&codec, "Failed to initialize encoder");
+
+  while (frame_count < limit && aom_img_read(raw, infile)) {
+    ++frame_count;
+    get_frame_stats(&codec, raw, frame_count, &stats);
+  }
+
+  // Flush encoder.
+  while (get_frame_stats(&codec, NULL, frame_count, &stats)) {
+  }
+
+  printf("First pass complete. Processed %d frames.\n", frame_count);
+  if (aom_codec_destroy(&codec)) die_codec(&codec, "Failed to destroy codec.");
+
+  return stats;
+}
+
+static const aom_image_t *scale_input(const aom_image_t *raw, Rendition *r) {
+  if (r->width == (int)raw->d_w && r->height == (int)raw->d_h) return raw;
+
+  av1_resize_frame420(raw->planes[AOM_PLANE_Y], raw->stride[AOM_PLANE_Y],
+                      raw->planes[AOM_PLANE_U], raw->planes[AOM_PLANE_V],
+                      raw->stride[AOM_PLANE_U], raw->d_h, raw->d_w,
+                      r->img.planes[AOM_PLANE_Y], r->img.stride[AOM_PLANE_Y],
+                      r->img.planes[AOM_PLANE_U], r->img.planes[AOM_PLANE_V],
+                      r->img.stride[AOM_PLANE_U], r->height, r->width);
+  return &r->img;
+}
+
+static void last_pass(aom_image_t *raw, FILE *infile,
+                      const AvxInterface *encoder,
+                      const aom_codec_enc_cfg_t *base_cfg,
+                      const aom_fixed_buf_t *stats, const char *prefix,
+                      Rendition *renditions, int num_renditions, int limit) {
+  int frame_count = 0;
+
+  for (int i = 0; i < num_renditions; ++i) {
+    Rendition *const r = &renditions[i];
+    aom_codec_enc_cfg_t cfg = *base_cfg;
+    char outfile_name[1024];
+
+    if (!aom_img_alloc(&r->img, AOM_IMG_FMT_I420, r->width, r->height, 1))
+      die("Failed to allocate image %dx%d", r->width, r->height);
+
+    r->stats.buf = malloc(stats->sz);
+    if (!r->stats.buf) die("Failed to allocate the first pass statistics.");
+    memcpy(r->stats.buf, stats->buf, stats->sz);
+    r->stats.sz = stats->sz;
+
+    cfg.g_w = r->width;
+    cfg.g_h = r->height;
+    cfg.rc_target_bitrate = r->bitrate;
+    cfg.g_pass = AOM_RC_LAST_PASS;
+    cfg.rc_twopass_stats_in = r->stats;
+    if (aom_codec_enc_init(&r->codec, encoder->codec_interface(), &cfg, 0))
+      die_codec(&r->codec, "Failed to initialize encoder");
+
+    const AvxVideoInfo info = { encoder->fourcc,
+                                r->width,
+                                r->height,
+                                { cfg.g_timebase.num, cfg.g_timebase.den },
+                                0 };
+    snprintf(outfile_name, sizeof(outfile_name), "%s_%dx%d_%d.ivf", prefix,
+             r->width, r->height, r->bitrate);
+    r->writer = aom_video_writer_open(outfile_name, kContainerIVF, &info);
+    if (!r->writer) die("Failed to open %s for writing", outfile_name);
+  }
+
+  // Each frame is read once for all the renditions.
+  while (frame_count < limit && aom_img_read(raw, infile)) {
+    ++frame_count;
+    for (int i = 0; i < num_renditions; ++i) {
+      Rendition *const r = &renditions[i];
+      encode_frame(&r->codec, scale_input(raw, r), frame_count, r->writer);
+    }
+  }
+
+  for (int i = 0; i < num_renditions; ++i) {
+    Rendition *const r = &renditions[i];
+    // Flush encoder.
+    while (encode_frame(&r->codec, NULL, -1, r->writer)) {
+    }
+    if (aom_codec_destroy(&r->codec))
+      die_codec(&r->codec, "Failed to destroy codec.");
+    aom_video_writer_close(r->writer);
+    aom_img_free(&r->img);
+    free(r->stats.buf);
+  }
+
+  printf("Last pass complete. Processed %d frames for %d renditions.\n",
+         frame_count, num_renditions);
+}
+
+int main(int argc, char **argv) {
+  FILE *infile = NULL;
+  aom_codec_enc_cfg_t cfg;
+  aom_image_t raw;
+  aom_fixed_buf_t stats;
+  Rendition renditions[MAX_RENDITIONS];
+  const int fps = 30;
+  exec_name = argv[0];
+
+  if (argc < 7 || argc - 6 > MAX_RENDITIONS) usage_exit();
+
+  const int w = (int)strtol(argv[1], NULL, 0);
+  const int h = (int)strtol(argv[2], NULL, 0);
+  const char *const infile_arg = argv[3];
+  int limit = (int)strtol(argv[4], NULL, 0);
+  const char *const prefix = argv[5];
+  const int num_renditions = argc - 6;
+
+  if (limit <= 0) limit = 100;
+
+  if (w <= 0 || h <= 0 || (w % 2) != 0 || (h % 2) != 0)
+    die("Invalid frame size: %dx%d", w, h);
+
+  memset(renditions, 0, sizeof(renditions));
+  for (int i = 0; i < num_renditions; ++i)
+    parse_rendition(argv[6 + i], &renditions[i]);
+
+  const AvxInterface *const encoder = get_aom_encoder_by_name("av1");
+  if (!encoder) die("Unsupported codec.");
+  if (!aom_img_alloc(&raw, AOM_IMG_FMT_I420, w, h, 1))
+    die("Failed to allocate image %dx%d", w, h);
+
+  printf("Using %s\n", aom_codec_iface_name(encoder->codec_interface()));
+
+  if (aom_codec_enc_config_default(encoder->codec_interface(), &cfg, 0))
+    die("Failed to get default codec config.");
+
+  cfg.g_w = w;
+  cfg.g_h = h;
+  cfg.g_timebase.num = 1;
+  cfg.g_timebase.den = fps;
+  cfg.rc_target_bitrate = renditions[0].bitrate;
+
+  if (!(infile = fopen(infile_arg, "rb")))
+    die("Failed to open %s for reading", infile_arg);
+
+  cfg.g_pass = AOM_RC_FIRST_PASS;
+  stats = first_pass(&raw, infile, encoder, &cfg, limit);
+
+  rewind(infile);
+  last_pass(&raw, infile, encoder, &cfg, &stats, prefix, renditions,
+            num_renditions, limit);
+  free(stats.buf);
+
+  aom_img_free(&raw);
+  fclose(infile);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+#!/bin/sh
+## Copyright (c) 2020, Alliance for Open Media. All rights reserved
+##
+## This source code is subject to the terms of the BSD 2 Clause License and
+## the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+## was not distributed with this source code in the LICENSE file, you can
+## obtain it at www.aomedia.org/license/software. If the Alliance for Open
+## Media Patent License 1.0 was not distributed with this source code in the
+## PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+##
+## This file tests the libaom abr_ladder_encoder example. To add new tests to
+## this file, do the following:
+##   1. Write a shell function (this is your test).
+##   2. Add the function to abr_ladder_encoder_tests (on a new line).
+##
+. $(dirname $0)/tools_common.sh
+
+# Environment check: $YUV_RAW_INPUT is required.
+abr_ladder_encoder_verify_environment() {
+  if [ ! -e "${YUV_RAW_INPUT}" ]; then
+    echo "Libaom test data must exist in LIBAOM_TEST_DATA_PATH."
+    return 1
+  fi
+}
+
+# Runs abr_ladder_encoder with a frame limit of 7 and two renditions: one at
+# the input resolution and one at half of it.
+abr_ladder_encoder() {
+  local encoder="$(aom_tool_path abr_ladder_encoder)"
+  local prefix="${AOM_TEST_OUTPUT_DIR}/abr_ladder_encoder"
+  local full="${YUV_RAW_INPUT_WIDTH}x${YUV_RAW_INPUT_HEIGHT}"
+  local half="$((YUV_RAW_INPUT_WIDTH / 2))x$((YUV_RAW_INPUT_HEIGHT / 2))"
+  local limit=7
+
+  if [ ! -x "${encoder}" ]; then
+    elog "${encoder} does not exist or is not executable."
+    return 1
+  fi
+
+  eval "${AOM_TEST_PREFIX}" "${encoder}" "${YUV_RAW_INPUT_WIDTH}" \
+      "${YUV_RAW_INPUT_HEIGHT}" "${YUV_RAW_INPUT}" "${limit}" "${prefix}" \
+      "${full}:400" "${half}:150" ${devnull}
+
+  [ -e "${prefix}_${full}_400.ivf" ] || return 1
+  [ -e "${prefix}_${half}_150.ivf" ] || return 1
+}
+
+abr_ladder_encoder_av1() {
+  if [ "$(av1_encode_available)" = "yes" ]; then
+    abr_ladder_encoder || return 1
+  fi
+}
+
+abr_ladder_encoder_tests="abr_ladder_encoder_av1"
+
+run_tests abr_ladder_encoder_verify_environment "${abr_ladder_encoder_tests}"
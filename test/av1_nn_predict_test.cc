@@ -9,11 +9,14 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <math.h>
+
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 
 #include "aom/aom_integer.h"
 #include "aom_ports/aom_timer.h"
 #include "av1/encoder/ml.h"
+#include "av1/encoder/partition_model_weights.h"
 #include "config/aom_config.h"
 #include "config/aom_dsp_rtcd.h"
 #include "config/av1_rtcd.h"
@@ -212,4 +215,338 @@ INSTANTIATE_TEST_CASE_P(SSE3, NnPredictTest,
                         ::testing::Values(av1_nn_predict_sse3));
 #endif
 
+typedef void (*NnPredictBatch_Func)(const float *input_nodes, int input_stride,
+                                    int num_samples,
+                                    const NN_CONFIG *const nn_config,
+                                    int reduce_prec, float *output,
+                                    int output_stride);
+
+const int kMaxBatchSamples = 20;
+
+// Checks that the SIMD versions of av1_nn_predict_batch() match the C version
+// exactly.
+class NnPredictBatchTest
+    : public ::testing::TestWithParam<NnPredictBatch_Func> {
+ public:
+  virtual void SetUp() {
+    rng_.Reset(libaom_test::ACMRandom::DeterministicSeed());
+    const int max_weights = NN_MAX_NODES_PER_LAYER * NN_MAX_NODES_PER_LAYER;
+    for (int i = 0; i < NN_MAX_HIDDEN_LAYERS + 1; ++i) {
+      weights_[i] = (float *)aom_malloc(max_weights * sizeof(*weights_[i]));
+      ASSERT_NE(weights_[i], nullptr);
+    }
+  }
+  virtual void TearDown() {
+    for (int i = 0; i < NN_MAX_HIDDEN_LAYERS + 1; ++i) aom_free(weights_[i]);
+    libaom_test::ClearSystemState();
+  }
+
+ protected:
+  float RandFloat() {
+    return ((float)rng_.Rand31() - (1 << 30)) / (1u << 30);
+  }
+
+  void SetRandomWeights(const NN_CONFIG *shape, NN_CONFIG *nn_config) {
+    *nn_config = *shape;
+    for (int layer = 0; layer <= shape->num_hidden_layers; ++layer) {
+      const int num_inputs =
+          layer ? shape->num_hidden_nodes[layer - 1] : shape->num_inputs;
+      const int num_nodes = layer < shape->num_hidden_layers
+                                ? shape->num_hidden_nodes[layer]
+                                : shape->num_outputs;
+      for (int i = 0; i < num_inputs * num_nodes; ++i)
+        weights_[layer][i] = RandFloat();
+      for (int i = 0; i < num_nodes; ++i) bias_[layer][i] = RandFloat();
+      nn_config->weights[layer] = weights_[layer];
+      nn_config->bias[layer] = bias_[layer];
+    }
+  }
+
+  void RunCheckOutput(const NN_CONFIG *shape) {
+    const NnPredictBatch_Func test_func = GetParam();
+    NN_CONFIG nn_config;
+    SetRandomWeights(shape, &nn_config);
+    const int input_stride = shape->num_inputs + 3;
+    const int output_stride = shape->num_outputs + 1;
+    float inputs[kMaxBatchSamples * (NN_MAX_NODES_PER_LAYER + 3)];
+    float outputs_ref[kMaxBatchSamples * (NN_MAX_NODES_PER_LAYER + 1)];
+    float outputs_test[kMaxBatchSamples * (NN_MAX_NODES_PER_LAYER + 1)];
+
+    for (int iter = 0; iter < 200 && !HasFatalFailure(); ++iter) {
+      const int num_samples = 1 + iter % kMaxBatchSamples;
+      for (int i = 0; i < num_samples * input_stride; ++i)
+        inputs[i] = RandFloat();
+      memset(outputs_ref, 0, sizeof(outputs_ref));
+      memset(outputs_test, 0, sizeof(outputs_test));
+      av1_nn_predict_batch_c(inputs, input_stride, num_samples, &nn_config,
+                             iter & 1, outputs_ref, output_stride);
+      ASM_REGISTER_STATE_CHECK(test_func(inputs, input_stride, num_samples,
+                                         &nn_config, iter & 1, outputs_test,
+                                         output_stride));
+      for (int i = 0; i < num_samples * output_stride; ++i)
+        ASSERT_EQ(outputs_ref[i], outputs_test[i])
+            << "iter " << iter << ", i " << i;
+    }
+  }
+
+  void RunSpeedTest(const NN_CONFIG *shape, int num_samples) {
+    const NnPredictBatch_Func test_func = GetParam();
+    NN_CONFIG nn_config;
+    SetRandomWeights(shape, &nn_config);
+    float inputs[kMaxBatchSamples * NN_MAX_NODES_PER_LAYER];
+    float outputs[kMaxBatchSamples * NN_MAX_NODES_PER_LAYER];
+    const int stride = shape->num_inputs;
+    const int num_loops = 1000000 / num_samples;
+    for (int i = 0; i < num_samples * stride; ++i) inputs[i] = RandFloat();
+
+    aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    for (int i = 0; i < num_loops; ++i) {
+      for (int j = 0; j < num_samples; ++j) {
+        av1_nn_predict(inputs + j * stride, &nn_config, 1,
+                       outputs + j * shape->num_outputs);
+      }
+    }
+    aom_usec_timer_mark(&timer);
+    const int single_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+    aom_usec_timer_start(&timer);
+    for (int i = 0; i < num_loops; ++i) {
+      test_func(inputs, stride, num_samples, &nn_config, 1, outputs,
+                shape->num_outputs);
+    }
+    aom_usec_timer_mark(&timer);
+    const int batch_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+    printf("%dx%dx%d, %d samples: single_time=%d \t batch_time=%d \t "
+           "gain=%f\n",
+           shape->num_inputs, shape->num_hidden_nodes[0], shape->num_outputs,
+           num_samples, single_time, batch_time,
+           static_cast<double>(single_time) / static_cast<double>(batch_time));
+  }
+
+  libaom_test::ACMRandom rng_;
+  float *weights_[NN_MAX_HIDDEN_LAYERS + 1];
+  float bias_[NN_MAX_HIDDEN_LAYERS + 1][NN_MAX_NODES_PER_LAYER];
+};
+
+TEST_P(NnPredictBatchTest, RandomValues) {
+  for (size_t i = 0; i < sizeof(shapes) / sizeof(*shapes); ++i)
+    RunCheckOutput(&shapes[i]);
+  const NN_CONFIG large_shapes[] = {
+    { 100, 10, 2, { 127, 64 }, { 0 }, { 0 } },
+    { 25, 10, 3, { 32, 9, 17 }, { 0 }, { 0 } },
+    { 7, 3, 0, { 0 }, { 0 }, { 0 } },
+  };
+  for (size_t i = 0; i < sizeof(large_shapes) / sizeof(*large_shapes); ++i)
+    RunCheckOutput(&large_shapes[i]);
+}
+
+TEST_P(NnPredictBatchTest, DISABLED_Speed) {
+  for (size_t i = 0; i < sizeof(shapes) / sizeof(*shapes); ++i) {
+    RunSpeedTest(&shapes[i], 4);
+    RunSpeedTest(&shapes[i], 16);
+  }
+}
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, NnPredictBatchTest,
+                        ::testing::Values(av1_nn_predict_batch_avx2));
+#endif
+
+typedef void (*NnPredictQuantized_Func)(const float *input_nodes,
+                                        const NN_CONFIG_Q *const nn_config_q,
+                                        int reduce_prec, float *const output);
+
+// Checks that the SIMD versions of av1_nn_predict_quantized() match the C
+// version exactly.
+class NnPredictQuantizedSimdTest
+    : public ::testing::TestWithParam<NnPredictQuantized_Func> {
+ public:
+  virtual void SetUp() {
+    rng_.Reset(libaom_test::ACMRandom::DeterministicSeed());
+    const int max_weights = NN_MAX_NODES_PER_LAYER * NN_MAX_NODES_PER_LAYER;
+    for (int i = 0; i < NN_MAX_HIDDEN_LAYERS + 1; ++i) {
+      weights_[i] = (float *)aom_malloc(max_weights * sizeof(*weights_[i]));
+      ASSERT_NE(weights_[i], nullptr);
+    }
+  }
+  virtual void TearDown() {
+    for (int i = 0; i < NN_MAX_HIDDEN_LAYERS + 1; ++i) aom_free(weights_[i]);
+    libaom_test::ClearSystemState();
+  }
+
+ protected:
+  float RandFloat() {
+    return ((float)rng_.Rand31() - (1 << 30)) / (1u << 30);
+  }
+
+  void RunCheckOutput(const NN_CONFIG *shape) {
+    const NnPredictQuantized_Func test_func = GetParam();
+    NN_CONFIG nn_config = *shape;
+    for (int layer = 0; layer <= shape->num_hidden_layers; ++layer) {
+      const int num_inputs =
+          layer ? shape->num_hidden_nodes[layer - 1] : shape->num_inputs;
+      const int num_nodes = layer < shape->num_hidden_layers
+                                ? shape->num_hidden_nodes[layer]
+                                : shape->num_outputs;
+      for (int i = 0; i < num_inputs * num_nodes; ++i)
+        weights_[layer][i] = RandFloat();
+      for (int i = 0; i < num_nodes; ++i) bias_[layer][i] = RandFloat();
+      nn_config.weights[layer] = weights_[layer];
+      nn_config.bias[layer] = bias_[layer];
+    }
+    NN_CONFIG_Q nn_config_q;
+    ASSERT_TRUE(av1_nn_quantize_config(&nn_config, &nn_config_q));
+
+    for (int iter = 0; iter < 1000 && !HasFatalFailure(); ++iter) {
+      float inputs[NN_MAX_NODES_PER_LAYER];
+      float outputs_ref[NN_MAX_NODES_PER_LAYER];
+      float outputs_test[NN_MAX_NODES_PER_LAYER];
+      const float range = (iter & 1) ? 1.0f : 1000.0f;
+      for (int i = 0; i < shape->num_inputs; ++i)
+        inputs[i] = (iter % 16 == 0) ? 0.0f : RandFloat() * range;
+      av1_nn_predict_quantized_c(inputs, &nn_config_q, iter & 2, outputs_ref);
+      ASM_REGISTER_STATE_CHECK(
+          test_func(inputs, &nn_config_q, iter & 2, outputs_test));
+      for (int i = 0; i < shape->num_outputs; ++i)
+        ASSERT_EQ(outputs_ref[i], outputs_test[i]) << "iter " << iter;
+    }
+    av1_nn_free_quantized_config(&nn_config_q);
+  }
+
+  libaom_test::ACMRandom rng_;
+  float *weights_[NN_MAX_HIDDEN_LAYERS + 1];
+  float bias_[NN_MAX_HIDDEN_LAYERS + 1][NN_MAX_NODES_PER_LAYER];
+};
+
+TEST_P(NnPredictQuantizedSimdTest, RandomValues) {
+  for (size_t i = 0; i < sizeof(shapes) / sizeof(*shapes); ++i)
+    RunCheckOutput(&shapes[i]);
+  const NN_CONFIG large_shapes[] = {
+    { 100, 10, 2, { 127, 64 }, { 0 }, { 0 } },
+    { 25, 10, 3, { 32, 9, 17 }, { 0 }, { 0 } },
+  };
+  for (size_t i = 0; i < sizeof(large_shapes) / sizeof(*large_shapes); ++i)
+    RunCheckOutput(&large_shapes[i]);
+}
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, NnPredictQuantizedSimdTest,
+                        ::testing::Values(av1_nn_predict_quantized_avx2));
+#endif
+
+const double kPi = 3.14159265358979323846;
+
+// Checks how often the fixed-point simple motion search models take the same
+// decisions as their float versions, on normalized features.
+class NnPredictQuantizedTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    rng_.Reset(libaom_test::ACMRandom::DeterministicSeed());
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+  // Returns a sample of the standard normal distribution.
+  float RandNormal() {
+    const double u1 = (rng_.Rand31() + 1.0) / (1u << 31);
+    const double u2 = rng_.Rand31() / static_cast<double>(1u << 31);
+    return static_cast<float>(sqrt(-2.0 * log(u1)) * cos(2 * kPi * u2));
+  }
+
+  libaom_test::ACMRandom rng_;
+};
+
+const int kNumAgreementSamples = 20000;
+const double kMinAgreementRate = 0.99;
+
+TEST_F(NnPredictQuantizedTest, SimpleMotionSearchSplitAgreement) {
+  for (int bsize_idx = 0; bsize_idx < 5; ++bsize_idx) {
+    const NN_CONFIG *nn_config =
+        av1_simple_motion_search_split_nn_config[bsize_idx];
+    NN_CONFIG_Q nn_config_q;
+    ASSERT_TRUE(av1_nn_quantize_config(nn_config, &nn_config_q));
+    // Thresholds of the least aggressive pruning at 720p and above.
+    const float split_only_thresh =
+        av1_simple_motion_search_split_thresh[0][2][bsize_idx];
+    const float no_split_thresh =
+        av1_simple_motion_search_no_split_thresh[0][2][bsize_idx];
+    int num_agreements = 0;
+    for (int n = 0; n < kNumAgreementSamples; ++n) {
+      float features[NN_MAX_NODES_PER_LAYER];
+      for (int i = 0; i < nn_config->num_inputs; ++i)
+        features[i] = RandNormal();
+      float score, score_q;
+      av1_nn_predict(features, nn_config, 1, &score);
+      av1_nn_predict_quantized(features, &nn_config_q, 1, &score_q);
+      const int agree_split_only =
+          (score > split_only_thresh) == (score_q > split_only_thresh);
+      const int agree_no_split =
+          (score < no_split_thresh) == (score_q < no_split_thresh);
+      num_agreements += agree_split_only && agree_no_split;
+    }
+    av1_nn_free_quantized_config(&nn_config_q);
+    EXPECT_GE(num_agreements, kMinAgreementRate * kNumAgreementSamples)
+        << "bsize_idx " << bsize_idx;
+  }
+}
+
+TEST_F(NnPredictQuantizedTest, SimpleMotionSearchPruneRectAgreement) {
+  for (int bsize_idx = 0; bsize_idx < 5; ++bsize_idx) {
+    const NN_CONFIG *nn_config =
+        av1_simple_motion_search_prune_rect_nn_config[bsize_idx];
+    if (!nn_config) continue;
+    NN_CONFIG_Q nn_config_q;
+    ASSERT_TRUE(av1_nn_quantize_config(nn_config, &nn_config_q));
+    int num_agreements = 0;
+    for (int n = 0; n < kNumAgreementSamples; ++n) {
+      float features[NN_MAX_NODES_PER_LAYER];
+      for (int i = 0; i < nn_config->num_inputs; ++i)
+        features[i] = RandNormal();
+      float scores[EXT_PARTITION_TYPES], scores_q[EXT_PARTITION_TYPES];
+      av1_nn_predict(features, nn_config, 1, scores);
+      av1_nn_predict_quantized(features, &nn_config_q, 1, scores_q);
+      int best = 0, best_q = 0;
+      for (int i = 1; i < nn_config->num_outputs; ++i) {
+        if (scores[i] > scores[best]) best = i;
+        if (scores_q[i] > scores_q[best_q]) best_q = i;
+      }
+      num_agreements += best == best_q;
+    }
+    av1_nn_free_quantized_config(&nn_config_q);
+    EXPECT_GE(num_agreements, kMinAgreementRate * kNumAgreementSamples)
+        << "bsize_idx " << bsize_idx;
+  }
+}
+
+TEST_F(NnPredictQuantizedTest, DISABLED_Speed) {
+  const int num_loops = 1000000;
+  for (int bsize_idx = 0; bsize_idx < 5; ++bsize_idx) {
+    const NN_CONFIG *nn_config =
+        av1_simple_motion_search_prune_rect_nn_config[bsize_idx];
+    if (!nn_config) continue;
+    NN_CONFIG_Q nn_config_q;
+    ASSERT_TRUE(av1_nn_quantize_config(nn_config, &nn_config_q));
+    float features[NN_MAX_NODES_PER_LAYER];
+    float scores[NN_MAX_NODES_PER_LAYER];
+    for (int i = 0; i < nn_config->num_inputs; ++i) features[i] = RandNormal();
+    aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    for (int i = 0; i < num_loops; ++i)
+      av1_nn_predict(features, nn_config, 1, scores);
+    aom_usec_timer_mark(&timer);
+    const int float_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+    aom_usec_timer_start(&timer);
+    for (int i = 0; i < num_loops; ++i)
+      av1_nn_predict_quantized(features, &nn_config_q, 1, scores);
+    aom_usec_timer_mark(&timer);
+    const int quantized_time =
+        static_cast<int>(aom_usec_timer_elapsed(&timer));
+    av1_nn_free_quantized_config(&nn_config_q);
+    printf("prune rect model %d: float_time=%d \t quantized_time=%d \t "
+           "gain=%f\n",
+           bsize_idx, float_time, quantized_time,
+           static_cast<double>(float_time) /
+               static_cast<double>(quantized_time));
+  }
+}
+
 }  // namespace
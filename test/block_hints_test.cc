@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "config/aom_config.h"
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "aom/aom_encoder.h"
+#include "aom/aomcx.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+const int kFrames = 10;
+
+struct HintParam {
+  // Size of the frame the hints describe.
+  unsigned int width;
+  unsigned int height;
+  uint8_t block_size;
+  int16_t mv;
+};
+
+// The hints of a frame twice as large as the one coded, with 8x8 blocks
+// scaled down to 4x4, and those of 64x64 blocks at the coded size.
+const HintParam kHintParams[] = { { 2 * kWidth, 2 * kHeight, 8, 16 },
+                                  { kWidth, kHeight, 64, 0 } };
+
+class BlockHintsTest
+    : public ::libaom_test::CodecTestWith2Params<libaom_test::TestMode,
+                                                 HintParam>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  BlockHintsTest()
+      : EncoderTest(GET_PARAM(0)), use_hints_(false), size_(0) {}
+  virtual ~BlockHintsTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(GET_PARAM(1));
+
+    const HintParam &param = GET_PARAM(2);
+    hint_map_.width = param.width;
+    hint_map_.height = param.height;
+    hint_map_.rows = (param.height + 3) / 4;
+    hint_map_.cols = (param.width + 3) / 4;
+    aom_block_hint_t hint;
+    hint.mv_row = param.mv;
+    hint.mv_col = -param.mv;
+    hint.ref_frame = 1;  // LAST_FRAME
+    hint.block_width = param.block_size;
+    hint.block_height = param.block_size;
+    hints_.assign(hint_map_.rows * hint_map_.cols, hint);
+    hint_map_.hints = &hints_[0];
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 4);
+      encoder->Control(AOME_SET_CQ_LEVEL, 40);
+    }
+    if (use_hints_ && video->img() != NULL)
+      encoder->Control(AV1E_SET_BLOCK_HINTS, &hint_map_);
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    size_ += pkt->data.frame.sz;
+  }
+
+  void Encode(bool use_hints) {
+    use_hints_ = use_hints;
+    size_ = 0;
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", kWidth,
+                                         kHeight, 30, 1, 0, kFrames);
+    cfg_.rc_end_usage = AOM_Q;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  }
+
+  bool use_hints_;
+  size_t size_;
+  aom_block_hint_map_t hint_map_;
+  std::vector<aom_block_hint_t> hints_;
+};
+
+// The hints change the coding decisions, without any mismatch between the
+// encoder and the decoder.
+TEST_P(BlockHintsTest, FollowsHints) {
+  ASSERT_NO_FATAL_FAILURE(Encode(false));
+  const size_t size = size_;
+  ASSERT_NO_FATAL_FAILURE(Encode(true));
+  EXPECT_NE(size, size_);
+}
+
+AV1_INSTANTIATE_TEST_CASE(BlockHintsTest,
+                          ::testing::Values(::libaom_test::kOnePassGood,
+                                            ::libaom_test::kTwoPassGood),
+                          ::testing::ValuesIn(kHintParams));
+
+TEST(BlockHintsControlTest, RejectsInvalidMaps) {
+  aom_codec_iface_t *const iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  aom_codec_ctx_t enc;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_config_default(iface, &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_init(&enc, iface, &cfg, 0));
+
+  std::vector<aom_block_hint_t> hints((kWidth / 4) * (kHeight / 4));
+  aom_block_hint_map_t map = { &hints[0], kHeight / 4, kWidth / 4, kWidth,
+                               kHeight };
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_control(&enc, AV1E_SET_BLOCK_HINTS, &map));
+  map.rows = kHeight / 8;
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_BLOCK_HINTS, &map));
+  map.rows = kHeight / 4;
+  map.width = 0;
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_BLOCK_HINTS, &map));
+  // No hints clear them.
+  map.hints = NULL;
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_control(&enc, AV1E_SET_BLOCK_HINTS, &map));
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_BLOCK_HINTS,
+                              static_cast<aom_block_hint_map_t *>(NULL)));
+
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&enc));
+}
+
+class AnalysisHintsTest
+    : public ::libaom_test::CodecTestWithParam<libaom_test::TestMode>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AnalysisHintsTest()
+      : EncoderTest(GET_PARAM(0)), use_hints_(false), scene_cut_(-1),
+        size_(0) {}
+  virtual ~AnalysisHintsTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(GET_PARAM(1));
+
+    hints_.mv_rows = (kHeight + 15) / 16;
+    hints_.mv_cols = (kWidth + 15) / 16;
+    // Motion of up to 2 pixels, different from one block to the next.
+    for (unsigned int i = 0; i < hints_.mv_rows * hints_.mv_cols; ++i) {
+      aom_analysis_mv_t mv;
+      mv.row = static_cast<int16_t>((static_cast<int>(i % 5) - 2) * 8);
+      mv.col = static_cast<int16_t>((static_cast<int>(i % 3) - 1) * 8);
+      mvs_.push_back(mv);
+    }
+    hints_.mvs = &mvs_[0];
+    hints_.depth_rows = (kHeight + 63) / 64;
+    hints_.depth_cols = (kWidth + 63) / 64;
+    for (unsigned int i = 0; i < hints_.depth_rows * hints_.depth_cols; ++i)
+      depths_.push_back(i % 4);
+    hints_.depths = &depths_[0];
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      // Real-time mode uses the variance based partitioning from speed 6.
+      encoder->Control(AOME_SET_CPUUSED,
+                       GET_PARAM(1) == ::libaom_test::kRealTime ? 7 : 4);
+      encoder->Control(AOME_SET_CQ_LEVEL, 40);
+    }
+    if (use_hints_ && video->img() != NULL) {
+      hints_.scene_cut = static_cast<int>(video->frame()) == scene_cut_;
+      encoder->Control(AV1E_SET_ANALYSIS_HINTS, &hints_);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    size_ += pkt->data.frame.sz;
+    if (pkt->data.frame.flags & AOM_FRAME_IS_KEY)
+      key_frames_.push_back(pkt->data.frame.pts);
+  }
+
+  void Encode(bool use_hints) {
+    use_hints_ = use_hints;
+    size_ = 0;
+    key_frames_.clear();
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", kWidth,
+                                         kHeight, 30, 1, 0, kFrames);
+    cfg_.rc_end_usage = AOM_Q;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  }
+
+  bool use_hints_;
+  int scene_cut_;
+  size_t size_;
+  std::vector<aom_codec_pts_t> key_frames_;
+  aom_analysis_hints_t hints_;
+  std::vector<aom_analysis_mv_t> mvs_;
+  std::vector<uint8_t> depths_;
+};
+
+// The depths change the real-time partitioning and the motion vectors the
+// first pass statistics. The motion search only starts from the motion
+// vectors when they are the better start, and may well end up where it would
+// have, so the one pass good quality encode can be the same.
+TEST_P(AnalysisHintsTest, FollowsHints) {
+  ASSERT_NO_FATAL_FAILURE(Encode(false));
+  const size_t size = size_;
+  ASSERT_NO_FATAL_FAILURE(Encode(true));
+  if (GET_PARAM(1) != ::libaom_test::kOnePassGood) EXPECT_NE(size, size_);
+}
+
+TEST_P(AnalysisHintsTest, SceneCutForcesKeyFrame) {
+  scene_cut_ = kFrames / 2;
+  ASSERT_NO_FATAL_FAILURE(Encode(true));
+  EXPECT_NE(key_frames_.end(),
+            std::find(key_frames_.begin(), key_frames_.end(),
+                      static_cast<aom_codec_pts_t>(scene_cut_)));
+}
+
+AV1_INSTANTIATE_TEST_CASE(AnalysisHintsTest,
+                          ::testing::Values(::libaom_test::kRealTime,
+                                            ::libaom_test::kOnePassGood,
+                                            ::libaom_test::kTwoPassGood));
+
+TEST(AnalysisHintsControlTest, RejectsInvalidHints) {
+  aom_codec_iface_t *const iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  aom_codec_ctx_t enc;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_config_default(iface, &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_init(&enc, iface, &cfg, 0));
+
+  const unsigned int mv_rows = (kHeight + 15) / 16;
+  const unsigned int mv_cols = (kWidth + 15) / 16;
+  const unsigned int depth_rows = (kHeight + 63) / 64;
+  const unsigned int depth_cols = (kWidth + 63) / 64;
+  std::vector<aom_analysis_mv_t> mvs(mv_rows * mv_cols);
+  std::vector<uint8_t> depths(depth_rows * depth_cols, AOM_ANALYSIS_NO_DEPTH);
+  aom_analysis_hints_t hints = { &mvs[0],   mv_rows,    mv_cols, &depths[0],
+                                 depth_rows, depth_cols, 0 };
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&enc, AV1E_SET_ANALYSIS_HINTS, &hints));
+  hints.mv_rows = mv_rows + 1;
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_ANALYSIS_HINTS, &hints));
+  // The sizes of missing arrays are not checked.
+  hints.mvs = NULL;
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&enc, AV1E_SET_ANALYSIS_HINTS, &hints));
+  depths[0] = 4;
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_ANALYSIS_HINTS, &hints));
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_ANALYSIS_HINTS,
+                              static_cast<aom_analysis_hints_t *>(NULL)));
+
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&enc));
+}
+
+}  // namespace
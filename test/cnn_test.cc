@@ -12,12 +12,19 @@
 #include <assert.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 
+#include "config/aom_config.h"
 #include "config/av1_rtcd.h"
 
+#include "aom_mem/aom_mem.h"
+#include "aom_ports/aom_timer.h"
 #include "av1/encoder/cnn.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/util.h"
 
 #define SQR(x) ((x) * (x))
 
@@ -2494,3 +2501,204 @@ TEST_F(CNNTest, TestMultiOutput) {
 
   aom_free(output_);
 }
+
+namespace {
+
+using libaom_test::ACMRandom;
+
+typedef void (*CNNConvolveFunc)(const float **input, int in_width,
+                                int in_height, int in_stride,
+                                const CNN_LAYER_CONFIG *layer_config,
+                                float **output, int out_stride, int start_idx,
+                                int step);
+
+const int kMaxConvolveDim = 72;
+const int kMaxConvolveChannels = 24;
+
+// Compares av1_cnn_convolve() versions against av1_cnn_convolve_c(). The
+// results must be bit-exact, since they drive encoder decisions.
+class CNNConvolveTest : public ::testing::TestWithParam<CNNConvolveFunc> {
+ public:
+  virtual void SetUp() {
+    rnd_.Reset(ACMRandom::DeterministicSeed());
+    const size_t plane_size = kMaxConvolveDim * kMaxConvolveDim;
+    const size_t num_weights =
+        kMaxConvolveChannels * kMaxConvolveChannels * 7 * 7;
+    input_ = (float *)aom_malloc(sizeof(*input_) * plane_size *
+                                 kMaxConvolveChannels);
+    ref_output_ = (float *)aom_malloc(sizeof(*ref_output_) * plane_size *
+                                      kMaxConvolveChannels);
+    output_ = (float *)aom_malloc(sizeof(*output_) * plane_size *
+                                  kMaxConvolveChannels);
+    weights_ = (float *)aom_malloc(sizeof(*weights_) * num_weights);
+    bias_ = (float *)aom_malloc(sizeof(*bias_) * kMaxConvolveChannels);
+    ASSERT_NE(input_, nullptr);
+    ASSERT_NE(ref_output_, nullptr);
+    ASSERT_NE(output_, nullptr);
+    ASSERT_NE(weights_, nullptr);
+    ASSERT_NE(bias_, nullptr);
+    for (int c = 0; c < kMaxConvolveChannels; ++c) {
+      input_ptrs_[c] = input_ + c * plane_size;
+      ref_output_ptrs_[c] = ref_output_ + c * plane_size;
+      output_ptrs_[c] = output_ + c * plane_size;
+    }
+  }
+
+  virtual void TearDown() {
+    aom_free(input_);
+    aom_free(ref_output_);
+    aom_free(output_);
+    aom_free(weights_);
+    aom_free(bias_);
+    libaom_test::ClearSystemState();
+  }
+
+ protected:
+  // Returns a random float in [-1, 1).
+  float RandFloat() { return (rnd_.Rand16() - 32768) / 32768.0f; }
+
+  void InitLayer(CNN_LAYER_CONFIG *layer, int in_channels, int out_channels,
+                 int filter_width, int filter_height, int skip_width,
+                 int skip_height, PADDING_TYPE pad) {
+    memset(layer, 0, sizeof(*layer));
+    layer->in_channels = in_channels;
+    layer->out_channels = out_channels;
+    layer->filter_width = filter_width;
+    layer->filter_height = filter_height;
+    layer->skip_width = skip_width;
+    layer->skip_height = skip_height;
+    layer->pad = pad;
+    layer->weights = weights_;
+    layer->bias = bias_;
+    const int num_weights =
+        in_channels * out_channels * filter_width * filter_height;
+    for (int i = 0; i < num_weights; ++i) weights_[i] = RandFloat();
+    for (int i = 0; i < out_channels; ++i) bias_[i] = RandFloat();
+    for (int i = 0; i < kMaxConvolveDim * kMaxConvolveDim * in_channels; ++i)
+      input_[i] = RandFloat() * 255.0f;
+  }
+
+  // Runs the convolution as a pool of step threads would: each call with
+  // start_idx in [0, step) computes a disjoint part of the output.
+  static void Convolve(CNNConvolveFunc func, const float **input, int width,
+                       int height, const CNN_LAYER_CONFIG *layer,
+                       float **output, int step) {
+    if (step <= 1) {
+      func(input, width, height, kMaxConvolveDim, layer, output,
+           kMaxConvolveDim, 0, step);
+      return;
+    }
+    for (int start_idx = 0; start_idx < step; ++start_idx) {
+      func(input, width, height, kMaxConvolveDim, layer, output,
+           kMaxConvolveDim, start_idx, step);
+    }
+  }
+
+  void RunCheckOutput() {
+    const CNNConvolveFunc test_func = GetParam();
+    const int plane_size = kMaxConvolveDim * kMaxConvolveDim;
+    const PADDING_TYPE pads[] = { PADDING_SAME_ZERO, PADDING_SAME_REPLICATE,
+                                  PADDING_VALID };
+    for (int iter = 0; iter < 500; ++iter) {
+      CNN_LAYER_CONFIG layer;
+      const int filter_width = 1 + rnd_(7);
+      const int filter_height = (iter & 1) ? filter_width : 1 + rnd_(7);
+      const PADDING_TYPE pad = pads[rnd_(3)];
+      InitLayer(&layer, 1 + rnd_(12), 1 + rnd_(kMaxConvolveChannels),
+                filter_width, filter_height, 1 + rnd_(4), 1 + rnd_(4), pad);
+      // Non-strided max pooling goes through the regular convolution.
+      layer.maxpool = rnd_(4) == 0;
+      if (layer.maxpool) layer.skip_width = layer.skip_height = 1;
+      const int width = filter_width + rnd_(kMaxConvolveDim - filter_width);
+      const int height =
+          filter_height + rnd_(kMaxConvolveDim - filter_height);
+      const int step = rnd_(5);
+
+      for (int i = 0; i < plane_size * layer.out_channels; ++i)
+        ref_output_[i] = output_[i] = -1234.5f;
+      Convolve(av1_cnn_convolve_c, const_cast<const float **>(input_ptrs_),
+               width, height, &layer, ref_output_ptrs_, step);
+      Convolve(test_func, const_cast<const float **>(input_ptrs_), width,
+               height, &layer, output_ptrs_, step);
+      for (int i = 0; i < plane_size * layer.out_channels; ++i) {
+        ASSERT_EQ(ref_output_[i], output_[i])
+            << "iter " << iter << ": " << width << "x" << height << ", "
+            << layer.in_channels << "->" << layer.out_channels << " channels, "
+            << filter_width << "x" << filter_height << " filter, skip "
+            << layer.skip_width << "x" << layer.skip_height << ", pad " << pad
+            << ", step " << step << ", index " << i;
+      }
+    }
+  }
+
+  void RunSpeedTest() {
+    const CNNConvolveFunc test_func = GetParam();
+    // Layer shapes of the intra partition CNN, followed by a generic 3x3
+    // convolution.
+    const struct {
+      int dim, in_channels, out_channels, filter, skip;
+      PADDING_TYPE pad;
+    } shapes[] = {
+      { 68, 1, 20, 5, 4, PADDING_VALID },
+      { 16, 20, 20, 2, 2, PADDING_VALID },
+      { 8, 20, 20, 2, 2, PADDING_VALID },
+      { 4, 20, 20, 2, 2, PADDING_VALID },
+      { 2, 20, 4, 2, 2, PADDING_VALID },
+      { 64, 16, 16, 3, 1, PADDING_SAME_ZERO },
+    };
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); ++s) {
+      CNN_LAYER_CONFIG layer;
+      InitLayer(&layer, shapes[s].in_channels, shapes[s].out_channels,
+                shapes[s].filter, shapes[s].filter, shapes[s].skip,
+                shapes[s].skip, shapes[s].pad);
+      const int dim = shapes[s].dim;
+      const int num_loops = 20000000 / (dim * dim * shapes[s].in_channels *
+                                        shapes[s].out_channels);
+      const float **input = const_cast<const float **>(input_ptrs_);
+      aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
+      for (int i = 0; i < num_loops; ++i)
+        av1_cnn_convolve_c(input, dim, dim, kMaxConvolveDim, &layer,
+                           ref_output_ptrs_, kMaxConvolveDim, 0, 0);
+      aom_usec_timer_mark(&timer);
+      const int ref_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+      aom_usec_timer_start(&timer);
+      for (int i = 0; i < num_loops; ++i)
+        test_func(input, dim, dim, kMaxConvolveDim, &layer, output_ptrs_,
+                  kMaxConvolveDim, 0, 0);
+      aom_usec_timer_mark(&timer);
+      const int simd_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+      printf("%dx%d, %d->%d channels, %dx%d filter, skip %d: c_time=%d \t "
+             "simd_time=%d \t gain=%f\n",
+             dim, dim, shapes[s].in_channels, shapes[s].out_channels,
+             shapes[s].filter, shapes[s].filter, shapes[s].skip, ref_time,
+             simd_time,
+             static_cast<double>(ref_time) / static_cast<double>(simd_time));
+    }
+  }
+
+  ACMRandom rnd_;
+  float *input_;
+  float *ref_output_;
+  float *output_;
+  float *weights_;
+  float *bias_;
+  float *input_ptrs_[kMaxConvolveChannels];
+  float *ref_output_ptrs_[kMaxConvolveChannels];
+  float *output_ptrs_[kMaxConvolveChannels];
+};
+
+TEST_P(CNNConvolveTest, CheckOutput) { RunCheckOutput(); }
+TEST_P(CNNConvolveTest, DISABLED_Speed) { RunSpeedTest(); }
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(SSE2, CNNConvolveTest,
+                        ::testing::Values(av1_cnn_convolve_sse2));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, CNNConvolveTest,
+                        ::testing::Values(av1_cnn_convolve_avx2));
+#endif  // HAVE_AVX2
+
+}  // namespace
@@ -16,6 +16,7 @@ using libaom_test::AV1DISTWTDCOMPAVG::AV1DISTWTDCOMPAVGTest;
 using libaom_test::AV1DISTWTDCOMPAVG::AV1DISTWTDCOMPAVGUPSAMPLEDTest;
 #if CONFIG_AV1_HIGHBITDEPTH
 using libaom_test::AV1DISTWTDCOMPAVG::AV1HighBDDISTWTDCOMPAVGTest;
+using libaom_test::AV1DISTWTDCOMPAVG::AV1HighBDCOMPAVGTest;
 using libaom_test::AV1DISTWTDCOMPAVG::AV1HighBDDISTWTDCOMPAVGUPSAMPLEDTest;
 #endif
 using ::testing::make_tuple;
@@ -62,6 +63,12 @@ INSTANTIATE_TEST_CASE_P(SSE2, AV1HighBDDISTWTDCOMPAVGTest,
                             aom_highbd_dist_wtd_comp_avg_pred_sse2, 1));
 #endif
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, AV1HighBDDISTWTDCOMPAVGTest,
+                        libaom_test::AV1DISTWTDCOMPAVG::BuildParams(
+                            aom_highbd_dist_wtd_comp_avg_pred_avx2, 1));
+#endif
+
 TEST_P(AV1HighBDDISTWTDCOMPAVGUPSAMPLEDTest, DISABLED_Speed) {
   RunSpeedTest(GET_PARAM(1));
 }
@@ -75,6 +82,16 @@ INSTANTIATE_TEST_CASE_P(SSE2, AV1HighBDDISTWTDCOMPAVGUPSAMPLEDTest,
                         libaom_test::AV1DISTWTDCOMPAVG::BuildParams(
                             aom_highbd_dist_wtd_comp_avg_upsampled_pred_sse2));
 #endif
+
+TEST_P(AV1HighBDCOMPAVGTest, DISABLED_Speed) { RunSpeedTest(GET_PARAM(1)); }
+
+TEST_P(AV1HighBDCOMPAVGTest, CheckOutput) { RunCheckOutput(GET_PARAM(1)); }
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, AV1HighBDCOMPAVGTest,
+                        libaom_test::AV1DISTWTDCOMPAVG::BuildParams(
+                            aom_highbd_comp_avg_pred_avx2));
+#endif
 #endif  // CONFIG_AV1_HIGHBITDEPTH
 
 }  // namespace
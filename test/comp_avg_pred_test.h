@@ -57,6 +57,13 @@ typedef ::testing::tuple<int, highbddistwtdcompavgupsampled_func, BLOCK_SIZE>
 typedef ::testing::tuple<int, distwtdcompavg_func, BLOCK_SIZE>
     HighbdDISTWTDCOMPAVGParam;
 
+typedef void (*highbdcompavg_func)(uint8_t *comp_pred8, const uint8_t *pred8,
+                                   int width, int height, const uint8_t *ref8,
+                                   int ref_stride);
+
+typedef ::testing::tuple<int, highbdcompavg_func, BLOCK_SIZE>
+    HighbdCOMPAVGParam;
+
 ::testing::internal::ParamGenerator<HighbdDISTWTDCOMPAVGParam> BuildParams(
     distwtdcompavg_func filter, int is_hbd) {
   (void)is_hbd;
@@ -71,6 +78,13 @@ BuildParams(highbddistwtdcompavgupsampled_func filter) {
                             ::testing::Values(filter),
                             ::testing::Range(BLOCK_4X4, BLOCK_SIZES_ALL));
 }
+
+::testing::internal::ParamGenerator<HighbdCOMPAVGParam> BuildParams(
+    highbdcompavg_func filter) {
+  return ::testing::Combine(::testing::Range(8, 13, 2),
+                            ::testing::Values(filter),
+                            ::testing::Range(BLOCK_4X4, BLOCK_SIZES_ALL));
+}
 #endif  // CONFIG_AV1_HIGHBITDEPTH
 
 ::testing::internal::ParamGenerator<DISTWTDCOMPAVGParam> BuildParams(
@@ -559,6 +573,102 @@ class AV1HighBDDISTWTDCOMPAVGUPSAMPLEDTest
 
   libaom_test::ACMRandom rnd_;
 };      // class AV1HighBDDISTWTDCOMPAVGUPSAMPLEDTest
+
+class AV1HighBDCOMPAVGTest
+    : public ::testing::TestWithParam<HighbdCOMPAVGParam> {
+ public:
+  ~AV1HighBDCOMPAVGTest() {}
+  void SetUp() { rnd_.Reset(ACMRandom::DeterministicSeed()); }
+
+  void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RunCheckOutput(highbdcompavg_func test_impl) {
+    const int w = kMaxSize, h = kMaxSize;
+    const int block_idx = GET_PARAM(2);
+    const int bd = GET_PARAM(0);
+    uint16_t pred8[kMaxSize * kMaxSize];
+    uint16_t ref8[kMaxSize * kMaxSize];
+    uint16_t output[kMaxSize * kMaxSize];
+    uint16_t output2[kMaxSize * kMaxSize];
+
+    for (int i = 0; i < h; ++i)
+      for (int j = 0; j < w; ++j) {
+        pred8[i * w + j] = rnd_.Rand16() & ((1 << bd) - 1);
+        ref8[i * w + j] = rnd_.Rand16() & ((1 << bd) - 1);
+      }
+    const int in_w = block_size_wide[block_idx];
+    const int in_h = block_size_high[block_idx];
+
+    for (int n = 0; n < 8; n++) {
+      const int offset_r = 3 + rnd_.PseudoUniform(h - in_h - 7);
+      const int offset_c = 3 + rnd_.PseudoUniform(w - in_w - 7);
+      // The prediction is contiguous while the reference has a stride.
+      aom_highbd_comp_avg_pred_c(
+          CONVERT_TO_BYTEPTR(output),
+          CONVERT_TO_BYTEPTR(pred8) + offset_r * w + offset_c, in_w, in_h,
+          CONVERT_TO_BYTEPTR(ref8) + offset_r * w + offset_c, w);
+      test_impl(CONVERT_TO_BYTEPTR(output2),
+                CONVERT_TO_BYTEPTR(pred8) + offset_r * w + offset_c, in_w,
+                in_h, CONVERT_TO_BYTEPTR(ref8) + offset_r * w + offset_c, w);
+
+      for (int i = 0; i < in_h; ++i) {
+        for (int j = 0; j < in_w; ++j) {
+          int idx = i * in_w + j;
+          ASSERT_EQ(output[idx], output2[idx])
+              << "Mismatch at unit tests for AV1HighBDCOMPAVGTest\n"
+              << in_w << "x" << in_h << " Pixel mismatch at index " << idx
+              << " = (" << i << ", " << j << ")";
+        }
+      }
+    }
+  }
+  void RunSpeedTest(highbdcompavg_func test_impl) {
+    const int w = kMaxSize, h = kMaxSize;
+    const int block_idx = GET_PARAM(2);
+    const int bd = GET_PARAM(0);
+    uint16_t pred8[kMaxSize * kMaxSize];
+    uint16_t ref8[kMaxSize * kMaxSize];
+    uint16_t output[kMaxSize * kMaxSize];
+    uint16_t output2[kMaxSize * kMaxSize];
+
+    for (int i = 0; i < h; ++i)
+      for (int j = 0; j < w; ++j) {
+        pred8[i * w + j] = rnd_.Rand16() & ((1 << bd) - 1);
+        ref8[i * w + j] = rnd_.Rand16() & ((1 << bd) - 1);
+      }
+    const int in_w = block_size_wide[block_idx];
+    const int in_h = block_size_high[block_idx];
+
+    const int num_loops = 1000000000 / (in_w + in_h);
+    aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+
+    for (int i = 0; i < num_loops; ++i)
+      aom_highbd_comp_avg_pred_c(CONVERT_TO_BYTEPTR(output),
+                                 CONVERT_TO_BYTEPTR(pred8), in_w, in_h,
+                                 CONVERT_TO_BYTEPTR(ref8), in_w);
+
+    aom_usec_timer_mark(&timer);
+    const int elapsed_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+    printf("highbdcompavg c_code %3dx%-3d: %7.2f us\n", in_w, in_h,
+           1000.0 * elapsed_time / num_loops);
+
+    aom_usec_timer timer1;
+    aom_usec_timer_start(&timer1);
+
+    for (int i = 0; i < num_loops; ++i)
+      test_impl(CONVERT_TO_BYTEPTR(output2), CONVERT_TO_BYTEPTR(pred8), in_w,
+                in_h, CONVERT_TO_BYTEPTR(ref8), in_w);
+
+    aom_usec_timer_mark(&timer1);
+    const int elapsed_time1 = static_cast<int>(aom_usec_timer_elapsed(&timer1));
+    printf("highbdcompavg test_code %3dx%-3d: %7.2f us\n", in_w, in_h,
+           1000.0 * elapsed_time1 / num_loops);
+  }
+
+  libaom_test::ACMRandom rnd_;
+};  // class AV1HighBDCOMPAVGTest
 #endif  // CONFIG_AV1_HIGHBITDEPTH
 
 }  // namespace AV1DISTWTDCOMPAVG
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+namespace {
+
+// Decodes the same stream with and without AV1D_SET_LOW_MEMORY and checks
+// that the output is identical and that the low-memory decoder peaks lower.
+class AV1DecodeLowMemoryTest
+    : public ::libaom_test::CodecTestWith2Params<unsigned int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecodeLowMemoryTest()
+      : EncoderTest(GET_PARAM(0)), sb_size_(GET_PARAM(1)),
+        threads_(GET_PARAM(2)) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 704;
+    cfg.h = 576;
+    cfg.threads = threads_;
+    cfg.allow_lowbitdepth = 1;
+    ref_dec_ = codec_->CreateDecoder(cfg, 0);
+    low_mem_dec_ = codec_->CreateDecoder(cfg, 0);
+    low_mem_dec_->Control(AV1D_SET_LOW_MEMORY, 1);
+  }
+
+  virtual ~AV1DecodeLowMemoryTest() {
+    delete ref_dec_;
+    delete low_mem_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(libaom_test::kTwoPassGood);
+  }
+
+  virtual void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                                  libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AV1E_SET_SUPERBLOCK_SIZE, sb_size_);
+    }
+  }
+
+  void UpdateMD5(::libaom_test::Decoder *dec, const aom_codec_cx_pkt_t *pkt,
+                 ::libaom_test::MD5 *md5) {
+    const aom_codec_err_t res = dec->DecodeFrame(
+        reinterpret_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res);
+    }
+    const aom_image_t *img = dec->GetDxData().Next();
+    md5->Add(img);
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    UpdateMD5(ref_dec_, pkt, &md5_ref_);
+    UpdateMD5(low_mem_dec_, pkt, &md5_low_mem_);
+  }
+
+  unsigned int sb_size_;
+  int threads_;
+  ::libaom_test::MD5 md5_ref_;
+  ::libaom_test::MD5 md5_low_mem_;
+  ::libaom_test::Decoder *ref_dec_;
+  ::libaom_test::Decoder *low_mem_dec_;
+};
+
+TEST_P(AV1DecodeLowMemoryTest, MD5MatchAndPeakMemory) {
+  const aom_rational timebase = { 33333333, 1000000000 };
+  cfg_.g_timebase = timebase;
+  cfg_.rc_target_bitrate = 500;
+  cfg_.g_lag_in_frames = 12;
+  cfg_.rc_end_usage = AOM_VBR;
+
+  libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 704, 576,
+                                     timebase.den, timebase.num, 0, 10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  ASSERT_STREQ(md5_ref_.Get(), md5_low_mem_.Get());
+
+  uint64_t ref_peak = 0;
+  uint64_t low_mem_peak = 0;
+  ASSERT_EQ(AOM_CODEC_OK,
+            aom_codec_control(ref_dec_->GetDecoder(), AV1D_GET_PEAK_MEM_USAGE,
+                              &ref_peak));
+  ASSERT_EQ(AOM_CODEC_OK,
+            aom_codec_control(low_mem_dec_->GetDecoder(),
+                              AV1D_GET_PEAK_MEM_USAGE, &low_mem_peak));
+  EXPECT_GT(low_mem_peak, 0u);
+  EXPECT_LE(low_mem_peak, ref_peak);
+  // With 64x64 superblocks the low-memory decoder also uses smaller borders.
+  if (sb_size_ == AOM_SUPERBLOCK_SIZE_64X64) EXPECT_LT(low_mem_peak, ref_peak);
+}
+
+AV1_INSTANTIATE_TEST_CASE(AV1DecodeLowMemoryTest,
+                          ::testing::Values(AOM_SUPERBLOCK_SIZE_64X64,
+                                            AOM_SUPERBLOCK_SIZE_128X128),
+                          ::testing::Values(1, 4));
+
+}  // namespace
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+
+// Checks AV1D_SET_OUTPUT_DOWNSCALE and AV1D_SET_KEYFRAMES_ONLY: a decoder
+// with both set must output exactly the key frames, with the same content as
+// a decoder that only downscales.
+class AV1DecodeThumbnailTest
+    : public ::libaom_test::CodecTestWithParam<unsigned int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecodeThumbnailTest()
+      : EncoderTest(GET_PARAM(0)), downscale_(GET_PARAM(1)),
+        num_key_frames_(0), num_thumbnails_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.allow_lowbitdepth = 1;
+    scaled_dec_ = codec_->CreateDecoder(cfg, 0);
+    scaled_dec_->Control(AV1D_SET_OUTPUT_DOWNSCALE, downscale_);
+    thumbnail_dec_ = codec_->CreateDecoder(cfg, 0);
+    thumbnail_dec_->Control(AV1D_SET_OUTPUT_DOWNSCALE, downscale_);
+    thumbnail_dec_->Control(AV1D_SET_KEYFRAMES_ONLY, 1);
+  }
+
+  virtual ~AV1DecodeThumbnailTest() {
+    delete scaled_dec_;
+    delete thumbnail_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(libaom_test::kOnePassGood);
+  }
+
+  virtual void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                                  libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) encoder->Control(AOME_SET_CPUUSED, 6);
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    uint8_t *const buf = reinterpret_cast<uint8_t *>(pkt->data.frame.buf);
+    const bool is_key = (pkt->data.frame.flags & AOM_FRAME_IS_KEY) != 0;
+
+    ASSERT_EQ(AOM_CODEC_OK, scaled_dec_->DecodeFrame(buf, pkt->data.frame.sz));
+    ::libaom_test::DxDataIterator scaled_iter = scaled_dec_->GetDxData();
+    const aom_image_t *scaled_img = scaled_iter.Next();
+
+    ASSERT_EQ(AOM_CODEC_OK,
+              thumbnail_dec_->DecodeFrame(buf, pkt->data.frame.sz));
+    ::libaom_test::DxDataIterator thumbnail_iter = thumbnail_dec_->GetDxData();
+    const aom_image_t *thumbnail = thumbnail_iter.Next();
+
+    if (!is_key) {
+      EXPECT_TRUE(thumbnail == NULL);
+      return;
+    }
+    ++num_key_frames_;
+    ASSERT_TRUE(scaled_img != NULL);
+    ASSERT_TRUE(thumbnail != NULL);
+    ++num_thumbnails_;
+    const unsigned int w = (kWidth + downscale_ - 1) / downscale_;
+    const unsigned int h = (kHeight + downscale_ - 1) / downscale_;
+    EXPECT_EQ(w, thumbnail->d_w);
+    EXPECT_EQ(h, thumbnail->d_h);
+
+    ::libaom_test::MD5 scaled_md5;
+    ::libaom_test::MD5 thumbnail_md5;
+    scaled_md5.Add(scaled_img);
+    thumbnail_md5.Add(thumbnail);
+    EXPECT_STREQ(scaled_md5.Get(), thumbnail_md5.Get());
+  }
+
+  unsigned int downscale_;
+  int num_key_frames_;
+  int num_thumbnails_;
+  ::libaom_test::Decoder *scaled_dec_;
+  ::libaom_test::Decoder *thumbnail_dec_;
+};
+
+TEST_P(AV1DecodeThumbnailTest, KeyFramesOnly) {
+  cfg_.g_lag_in_frames = 0;
+  cfg_.kf_min_dist = 4;
+  cfg_.kf_max_dist = 4;
+  cfg_.rc_target_bitrate = 300;
+
+  libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", kWidth,
+                                     kHeight, 30, 1, 0, 10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(3, num_key_frames_);
+  EXPECT_EQ(num_key_frames_, num_thumbnails_);
+}
+
+AV1_INSTANTIATE_TEST_CASE(AV1DecodeThumbnailTest, ::testing::Values(2, 4, 8));
+
+}  // namespace
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "config/aom_config.h"
+#include "config/av1_rtcd.h"
+
+#include "aom_mem/aom_mem.h"
+#include "aom_ports/aom_timer.h"
+#include "aom_scale/yv12config.h"
+#include "aom_util/aom_thread.h"
+#include "av1/common/resize.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+
+namespace {
+
+using libaom_test::ACMRandom;
+
+const int kMaxWidth = 1024;
+const int kNumTaps = 8;
+
+// Returns one of the normative 8-tap upscaling filters.
+const int16_t *RandomFilter(ACMRandom *rnd) {
+  return av1_resize_filter_normative[rnd->Rand8() & RS_SUBPEL_MASK];
+}
+
+typedef void (*ResizeVert8tapFunc)(const uint8_t *const *src, uint8_t *dst,
+                                   int w, const int16_t *filter);
+
+class ResizeVert8tapTest : public ::testing::TestWithParam<ResizeVert8tapFunc> {
+ public:
+  virtual void SetUp() { rnd_.Reset(ACMRandom::DeterministicSeed()); }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RunCheckOutput() {
+    const ResizeVert8tapFunc test_func = GetParam();
+    DECLARE_ALIGNED(32, uint8_t, rows[kNumTaps][kMaxWidth]);
+    DECLARE_ALIGNED(32, uint8_t, ref_dst[kMaxWidth]);
+    DECLARE_ALIGNED(32, uint8_t, dst[kMaxWidth]);
+    const uint8_t *src[kNumTaps];
+
+    for (int iter = 0; iter < 1000; ++iter) {
+      const int w = 1 + rnd_(kMaxWidth);
+      const int16_t *filter = RandomFilter(&rnd_);
+      for (int k = 0; k < kNumTaps; ++k) {
+        // Repeat rows from time to time, as at the plane edges.
+        src[k] = rows[(k > 0 && rnd_.Rand8() < 32) ? k - 1 : k];
+        for (int x = 0; x < w; ++x)
+          rows[k][x] = (iter & 1) ? rnd_.Rand8() : (rnd_.Rand8() & 1) * 255;
+      }
+      memset(ref_dst, 0, sizeof(ref_dst));
+      memset(dst, 0, sizeof(dst));
+      av1_resize_vert_8tap_c(src, ref_dst, w, filter);
+      ASM_REGISTER_STATE_CHECK(test_func(src, dst, w, filter));
+      for (int x = 0; x < kMaxWidth; ++x)
+        ASSERT_EQ(ref_dst[x], dst[x]) << "w = " << w << ", x = " << x;
+    }
+  }
+
+  void RunSpeedTest() {
+    const ResizeVert8tapFunc test_func = GetParam();
+    DECLARE_ALIGNED(32, uint8_t, rows[kNumTaps][kMaxWidth]);
+    DECLARE_ALIGNED(32, uint8_t, dst[kMaxWidth]);
+    const uint8_t *src[kNumTaps];
+    const int16_t *filter = RandomFilter(&rnd_);
+    const int num_loops = 100000;
+
+    for (int k = 0; k < kNumTaps; ++k) {
+      src[k] = rows[k];
+      for (int x = 0; x < kMaxWidth; ++x) rows[k][x] = rnd_.Rand8();
+    }
+    aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    for (int i = 0; i < num_loops; ++i)
+      av1_resize_vert_8tap_c(src, dst, kMaxWidth, filter);
+    aom_usec_timer_mark(&timer);
+    const int ref_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+    aom_usec_timer_start(&timer);
+    for (int i = 0; i < num_loops; ++i)
+      test_func(src, dst, kMaxWidth, filter);
+    aom_usec_timer_mark(&timer);
+    const int simd_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+    printf("resize vert 8-tap: c_time=%d \t simd_time=%d \t gain=%f\n",
+           ref_time, simd_time,
+           static_cast<double>(ref_time) / static_cast<double>(simd_time));
+  }
+
+  ACMRandom rnd_;
+};
+
+TEST_P(ResizeVert8tapTest, CheckOutput) { RunCheckOutput(); }
+TEST_P(ResizeVert8tapTest, DISABLED_Speed) { RunSpeedTest(); }
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(SSE2, ResizeVert8tapTest,
+                        ::testing::Values(av1_resize_vert_8tap_sse2));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, ResizeVert8tapTest,
+                        ::testing::Values(av1_resize_vert_8tap_avx2));
+#endif  // HAVE_AVX2
+
+#if CONFIG_AV1_HIGHBITDEPTH
+typedef void (*HighbdResizeVert8tapFunc)(const uint16_t *const *src,
+                                         uint16_t *dst, int w,
+                                         const int16_t *filter, int bd);
+
+class HighbdResizeVert8tapTest
+    : public ::testing::TestWithParam<HighbdResizeVert8tapFunc> {
+ public:
+  virtual void SetUp() { rnd_.Reset(ACMRandom::DeterministicSeed()); }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RunCheckOutput() {
+    const HighbdResizeVert8tapFunc test_func = GetParam();
+    DECLARE_ALIGNED(32, uint16_t, rows[kNumTaps][kMaxWidth]);
+    DECLARE_ALIGNED(32, uint16_t, ref_dst[kMaxWidth]);
+    DECLARE_ALIGNED(32, uint16_t, dst[kMaxWidth]);
+    const uint16_t *src[kNumTaps];
+
+    for (int bd = 10; bd <= 12; bd += 2) {
+      const int mask = (1 << bd) - 1;
+      for (int iter = 0; iter < 1000; ++iter) {
+        const int w = 1 + rnd_(kMaxWidth);
+        const int16_t *filter = RandomFilter(&rnd_);
+        for (int k = 0; k < kNumTaps; ++k) {
+          src[k] = rows[(k > 0 && rnd_.Rand8() < 32) ? k - 1 : k];
+          for (int x = 0; x < w; ++x)
+            rows[k][x] = (iter & 1) ? rnd_.Rand16() & mask
+                                    : (rnd_.Rand8() & 1) * mask;
+        }
+        memset(ref_dst, 0, sizeof(ref_dst));
+        memset(dst, 0, sizeof(dst));
+        av1_highbd_resize_vert_8tap_c(src, ref_dst, w, filter, bd);
+        ASM_REGISTER_STATE_CHECK(test_func(src, dst, w, filter, bd));
+        for (int x = 0; x < kMaxWidth; ++x)
+          ASSERT_EQ(ref_dst[x], dst[x])
+              << "bd = " << bd << ", w = " << w << ", x = " << x;
+      }
+    }
+  }
+
+  ACMRandom rnd_;
+};
+
+TEST_P(HighbdResizeVert8tapTest, CheckOutput) { RunCheckOutput(); }
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(SSE2, HighbdResizeVert8tapTest,
+                        ::testing::Values(av1_highbd_resize_vert_8tap_sse2));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, HighbdResizeVert8tapTest,
+                        ::testing::Values(av1_highbd_resize_vert_8tap_avx2));
+#endif  // HAVE_AVX2
+#endif  // CONFIG_AV1_HIGHBITDEPTH
+
+// Checks that av1_resize_and_extend_frame_mt() matches the single-threaded
+// av1_resize_and_extend_frame().
+class ResizeFrameMTTest
+    : public ::testing::TestWithParam< ::testing::tuple<int, int> > {
+ public:
+  virtual void SetUp() {
+    rnd_.Reset(ACMRandom::DeterministicSeed());
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    for (int i = 0; i < kNumWorkers; ++i) {
+      winterface->init(&workers_[i]);
+      // Worker 0 runs on the calling thread.
+      if (i > 0) {
+        ASSERT_TRUE(winterface->reset(&workers_[i]));
+      }
+    }
+  }
+
+  virtual void TearDown() {
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    for (int i = 0; i < kNumWorkers; ++i) winterface->end(&workers_[i]);
+    libaom_test::ClearSystemState();
+  }
+
+ protected:
+  static const int kNumWorkers = 4;
+
+  void RunCheck(int use_highbitdepth) {
+    const int src_width = 1280, src_height = 720;
+    const int dst_width = ::testing::get<0>(GetParam());
+    const int dst_height = ::testing::get<1>(GetParam());
+    const int bd = use_highbitdepth ? 10 : 8;
+    const int mask = (1 << bd) - 1;
+    YV12_BUFFER_CONFIG src, dst_ref, dst;
+    memset(&src, 0, sizeof(src));
+    memset(&dst_ref, 0, sizeof(dst_ref));
+    memset(&dst, 0, sizeof(dst));
+    ASSERT_EQ(0, aom_alloc_frame_buffer(&src, src_width, src_height, 1, 1,
+                                        use_highbitdepth, 32, 16));
+    ASSERT_EQ(0, aom_alloc_frame_buffer(&dst_ref, dst_width, dst_height, 1, 1,
+                                        use_highbitdepth, 32, 16));
+    ASSERT_EQ(0, aom_alloc_frame_buffer(&dst, dst_width, dst_height, 1, 1,
+                                        use_highbitdepth, 32, 16));
+    memset(dst_ref.buffer_alloc, 0, dst_ref.frame_size);
+    memset(dst.buffer_alloc, 0, dst.frame_size);
+
+    for (int plane = 0; plane < 3; ++plane) {
+      const int is_uv = plane > 0;
+      for (int r = 0; r < src.crop_heights[is_uv]; ++r) {
+        for (int c = 0; c < src.crop_widths[is_uv]; ++c) {
+          const int offset = r * src.strides[is_uv] + c;
+          if (use_highbitdepth)
+            CONVERT_TO_SHORTPTR(src.buffers[plane])[offset] =
+                rnd_.Rand16() & mask;
+          else
+            src.buffers[plane][offset] = rnd_.Rand8();
+        }
+      }
+    }
+
+    av1_resize_and_extend_frame(&src, &dst_ref, bd, 3);
+    av1_resize_and_extend_frame_mt(&src, &dst, bd, 3, workers_, kNumWorkers);
+    ASSERT_EQ(dst_ref.frame_size, dst.frame_size);
+    EXPECT_EQ(0,
+              memcmp(dst_ref.buffer_alloc, dst.buffer_alloc, dst.frame_size));
+
+    aom_free_frame_buffer(&src);
+    aom_free_frame_buffer(&dst_ref);
+    aom_free_frame_buffer(&dst);
+  }
+
+  ACMRandom rnd_;
+  AVxWorker workers_[kNumWorkers];
+};
+
+TEST_P(ResizeFrameMTTest, MatchesSingleThread) { RunCheck(0); }
+
+#if CONFIG_AV1_HIGHBITDEPTH
+TEST_P(ResizeFrameMTTest, HighbdMatchesSingleThread) { RunCheck(1); }
+#endif  // CONFIG_AV1_HIGHBITDEPTH
+
+INSTANTIATE_TEST_CASE_P(
+    AV1, ResizeFrameMTTest,
+    ::testing::Values(::testing::make_tuple(640, 360),
+                      ::testing::make_tuple(320, 180),
+                      ::testing::make_tuple(960, 540),
+                      ::testing::make_tuple(1920, 1080)));
+
+}  // namespace
@@ -229,6 +229,13 @@ INSTANTIATE_TEST_CASE_P(
                                           av1_filter_intra_edge_sse4_1)));
 #endif  // HAVE_SSE4_1
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, FilterEdgeTest8B,
+    ::testing::Values(FilterEdgeTestFuncs(av1_filter_intra_edge_c,
+                                          av1_filter_intra_edge_avx2)));
+#endif  // HAVE_AVX2
+
 //////////////////////////////////////////////////////////////////////////////
 // High bit-depth version
 //////////////////////////////////////////////////////////////////////////////
@@ -274,6 +281,13 @@ INSTANTIATE_TEST_CASE_P(SSE4_1, FilterEdgeTestHB,
                             av1_filter_intra_edge_high_sse4_1)));
 #endif  // HAVE_SSE4_1
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, FilterEdgeTestHB,
+                        ::testing::Values(FilterEdgeTestFuncsHBD(
+                            av1_filter_intra_edge_high_c,
+                            av1_filter_intra_edge_high_avx2)));
+#endif  // HAVE_AVX2
+
 // Speed tests
 
 TEST_P(UpsampleTest8B, DISABLED_Speed) {
@@ -201,6 +201,19 @@ TEST_P(LowbdIntraPredTest, Bitexact) {
       highbd_entry(type, 16, 32, opt, bd),                                    \
       highbd_entry(type, 32, 16, opt, bd), highbd_entry(type, 32, 32, opt, bd)
 #endif
+
+#define highbd_intrapred_wide(type, opt, bd)                              \
+  highbd_entry(type, 16, 4, opt, bd), highbd_entry(type, 16, 8, opt, bd), \
+      highbd_entry(type, 16, 16, opt, bd),                                \
+      highbd_entry(type, 16, 32, opt, bd),                                \
+      highbd_entry(type, 16, 64, opt, bd),                                \
+      highbd_entry(type, 32, 8, opt, bd),                                 \
+      highbd_entry(type, 32, 16, opt, bd),                                \
+      highbd_entry(type, 32, 32, opt, bd),                                \
+      highbd_entry(type, 32, 64, opt, bd),                                \
+      highbd_entry(type, 64, 16, opt, bd),                                \
+      highbd_entry(type, 64, 32, opt, bd),                                \
+      highbd_entry(type, 64, 64, opt, bd)
 #endif  // CONFIG_AV1_HIGHBITDEPTH
 // ---------------------------------------------------------------------------
 // Low Bit Depth Tests
@@ -269,5 +282,29 @@ INSTANTIATE_TEST_CASE_P(NEON, HighbdIntraPredTest,
                         ::testing::ValuesIn(HighbdIntraPredTestVectorNeon));
 
 #endif  // HAVE_NEON
+
+#if HAVE_AVX2
+#define highbd_intrapred_avx2(bd)                \
+  highbd_intrapred_wide(dc, avx2, bd),           \
+      highbd_intrapred_wide(dc_top, avx2, bd),   \
+      highbd_intrapred_wide(dc_left, avx2, bd),  \
+      highbd_intrapred_wide(dc_128, avx2, bd),   \
+      highbd_intrapred_wide(v, avx2, bd),        \
+      highbd_intrapred_wide(h, avx2, bd),        \
+      highbd_intrapred_wide(paeth, avx2, bd),    \
+      highbd_intrapred_wide(smooth, avx2, bd),   \
+      highbd_intrapred_wide(smooth_v, avx2, bd), \
+      highbd_intrapred_wide(smooth_h, avx2, bd)
+
+const IntraPredFunc<HighbdIntraPred> HighbdIntraPredTestVectorAvx2[] = {
+  highbd_intrapred_avx2(8),
+  highbd_intrapred_avx2(10),
+  highbd_intrapred_avx2(12),
+};
+
+INSTANTIATE_TEST_CASE_P(AVX2, HighbdIntraPredTest,
+                        ::testing::ValuesIn(HighbdIntraPredTestVectorAvx2));
+
+#endif  // HAVE_AVX2
 #endif  // CONFIG_AV1_HIGHBITDEPTH
 }  // namespace
@@ -63,6 +63,22 @@ void highbd_quan64x64_wrapper(QUAN_PARAM_LIST) {
   HBD_QUAN_FUNC;
 }
 
+typedef void (*QuantizeFuncQm)(QUAN_PARAM_LIST, const qm_val_t *qm_ptr,
+                               const qm_val_t *iqm_ptr, int log_scale);
+
+// Quantization matrices used by qm_quan_wrapper(), filled with random weights
+// in QuantizeTest::SetUp().
+const int kMaxQmSize = 1024;
+qm_val_t qm_table[kMaxQmSize];
+qm_val_t iqm_table[kMaxQmSize];
+
+template <QuantizeFuncQm fn, int log_scale>
+void qm_quan_wrapper(QUAN_PARAM_LIST) {
+  fn(coeff_ptr, n_coeffs, zbin_ptr, round_ptr, quant_ptr, quant_shift_ptr,
+     qcoeff_ptr, dqcoeff_ptr, dequant_ptr, eob_ptr, scan, iscan, qm_table,
+     iqm_table, log_scale);
+}
+
 enum QuantType { TYPE_B, TYPE_DC, TYPE_FP };
 
 using ::testing::tuple;
@@ -90,6 +106,10 @@ class QuantizeTest : public ::testing::TestWithParam<QuantizeParam> {
     coeff_ = reinterpret_cast<tran_low_t *>(
         aom_memalign(32, 6 * n_coeffs * sizeof(tran_low_t)));
     InitQuantizer();
+    for (int i = 0; i < kMaxQmSize; ++i) {
+      qm_table[i] = 1 + rnd_(255);
+      iqm_table[i] = 1 + rnd_(255);
+    }
   }
 
   virtual void TearDown() {
@@ -403,7 +423,87 @@ const QuantizeParam kQParamArrayAvx2[] = {
   make_tuple(&aom_quantize_b_adaptive_c, &aom_quantize_b_adaptive_avx2,
              static_cast<TX_SIZE>(TX_8X8), TYPE_B, AOM_BITS_8),
   make_tuple(&aom_quantize_b_adaptive_c, &aom_quantize_b_adaptive_avx2,
-             static_cast<TX_SIZE>(TX_4X4), TYPE_B, AOM_BITS_8)
+             static_cast<TX_SIZE>(TX_4X4), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_b_c, 0>,
+             &qm_quan_wrapper<av1_quantize_b_avx2, 0>,
+             static_cast<TX_SIZE>(TX_4X4), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_b_c, 0>,
+             &qm_quan_wrapper<av1_quantize_b_avx2, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_b_c, 1>,
+             &qm_quan_wrapper<av1_quantize_b_avx2, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_b_c, 2>,
+             &qm_quan_wrapper<av1_quantize_b_avx2, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_fp_qm_c, 0>,
+             &qm_quan_wrapper<av1_quantize_fp_qm_avx2, 0>,
+             static_cast<TX_SIZE>(TX_4X4), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_fp_qm_c, 0>,
+             &qm_quan_wrapper<av1_quantize_fp_qm_avx2, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_fp_qm_c, 1>,
+             &qm_quan_wrapper<av1_quantize_fp_qm_avx2, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_fp_qm_c, 2>,
+             &qm_quan_wrapper<av1_quantize_fp_qm_avx2, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_FP, AOM_BITS_8),
+#if CONFIG_AV1_HIGHBITDEPTH
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_avx2, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_avx2, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_B, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_avx2, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_B, AOM_BITS_12),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_avx2, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_avx2, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_B, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_avx2, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_B, AOM_BITS_12),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_avx2, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_avx2, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_B, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_avx2, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_B, AOM_BITS_12),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_avx2, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_avx2, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_FP, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_avx2, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_FP, AOM_BITS_12),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_avx2, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_avx2, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_FP, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_avx2, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_FP, AOM_BITS_12),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_avx2, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_avx2, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_FP, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_avx2, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_FP, AOM_BITS_12),
+#endif  // CONFIG_AV1_HIGHBITDEPTH
 };
 
 INSTANTIATE_TEST_CASE_P(AVX2, QuantizeTest,
@@ -501,6 +601,94 @@ INSTANTIATE_TEST_CASE_P(SSE2, QuantizeTest,
                         ::testing::ValuesIn(kQParamArraySSE2));
 #endif
 
+#if HAVE_SSE4_1
+const QuantizeParam kQParamArraySSE4_1[] = {
+  make_tuple(&qm_quan_wrapper<av1_quantize_b_c, 0>,
+             &qm_quan_wrapper<av1_quantize_b_sse4_1, 0>,
+             static_cast<TX_SIZE>(TX_4X4), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_b_c, 0>,
+             &qm_quan_wrapper<av1_quantize_b_sse4_1, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_b_c, 1>,
+             &qm_quan_wrapper<av1_quantize_b_sse4_1, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_b_c, 2>,
+             &qm_quan_wrapper<av1_quantize_b_sse4_1, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_fp_qm_c, 0>,
+             &qm_quan_wrapper<av1_quantize_fp_qm_sse4_1, 0>,
+             static_cast<TX_SIZE>(TX_4X4), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_fp_qm_c, 0>,
+             &qm_quan_wrapper<av1_quantize_fp_qm_sse4_1, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_fp_qm_c, 1>,
+             &qm_quan_wrapper<av1_quantize_fp_qm_sse4_1, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_quantize_fp_qm_c, 2>,
+             &qm_quan_wrapper<av1_quantize_fp_qm_sse4_1, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_FP, AOM_BITS_8),
+#if CONFIG_AV1_HIGHBITDEPTH
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_sse4_1, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_sse4_1, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_B, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_sse4_1, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_B, AOM_BITS_12),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_sse4_1, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_sse4_1, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_B, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_sse4_1, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_B, AOM_BITS_12),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_sse4_1, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_B, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_sse4_1, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_B, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_b_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_b_sse4_1, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_B, AOM_BITS_12),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_sse4_1, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_sse4_1, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_FP, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 0>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_sse4_1, 0>,
+             static_cast<TX_SIZE>(TX_16X16), TYPE_FP, AOM_BITS_12),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_sse4_1, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_sse4_1, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_FP, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 1>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_sse4_1, 1>,
+             static_cast<TX_SIZE>(TX_32X32), TYPE_FP, AOM_BITS_12),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_sse4_1, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_FP, AOM_BITS_8),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_sse4_1, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_FP, AOM_BITS_10),
+  make_tuple(&qm_quan_wrapper<av1_highbd_quantize_fp_qm_c, 2>,
+             &qm_quan_wrapper<av1_highbd_quantize_fp_qm_sse4_1, 2>,
+             static_cast<TX_SIZE>(TX_64X64), TYPE_FP, AOM_BITS_12),
+#endif  // CONFIG_AV1_HIGHBITDEPTH
+};
+
+INSTANTIATE_TEST_CASE_P(SSE4_1, QuantizeTest,
+                        ::testing::ValuesIn(kQParamArraySSE4_1));
+#endif  // HAVE_SSE4_1
+
 #if HAVE_NEON
 const QuantizeParam kQParamArrayNEON[] = {
   make_tuple(&av1_quantize_fp_c, &av1_quantize_fp_neon,
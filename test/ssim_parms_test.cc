@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "test/acm_random.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom/aom_integer.h"
+#include "aom_ports/mem.h"
+
+using libaom_test::ACMRandom;
+
+namespace {
+
+const int kStride = 48;
+const int kIterations = 1000;
+
+// The sums of the reference and the tested functions, which both accumulate
+// into their outputs.
+struct SsimSums {
+  uint32_t sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr;
+};
+
+void ExpectSumsEqual(const SsimSums &ref, const SsimSums &test) {
+  EXPECT_EQ(ref.sum_s, test.sum_s);
+  EXPECT_EQ(ref.sum_r, test.sum_r);
+  EXPECT_EQ(ref.sum_sq_s, test.sum_sq_s);
+  EXPECT_EQ(ref.sum_sq_r, test.sum_sq_r);
+  EXPECT_EQ(ref.sum_sxr, test.sum_sxr);
+}
+
+SsimSums RandomSums(ACMRandom *rnd) {
+  SsimSums sums = { rnd->Rand16(), rnd->Rand16(), rnd->Rand16(), rnd->Rand16(),
+                    rnd->Rand16() };
+  return sums;
+}
+
+typedef void (*SsimParmsFunc)(const uint8_t *s, int sp, const uint8_t *r,
+                              int rp, uint32_t *sum_s, uint32_t *sum_r,
+                              uint32_t *sum_sq_s, uint32_t *sum_sq_r,
+                              uint32_t *sum_sxr);
+typedef ::testing::tuple<SsimParmsFunc, SsimParmsFunc> SsimParmsParam;
+
+class SsimParmsTest : public ::testing::TestWithParam<SsimParmsParam> {
+ protected:
+  void RunTest(bool extreme) {
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    const SsimParmsFunc ref_func = GET_PARAM(0);
+    const SsimParmsFunc test_func = GET_PARAM(1);
+    for (int iter = 0; iter < kIterations && !HasFailure(); ++iter) {
+      for (int i = 0; i < kStride * kStride; ++i) {
+        src_[i] = extreme ? 255 : rnd.Rand8();
+        ref_[i] = extreme ? 255 : rnd.Rand8();
+      }
+      const int offset = rnd(16);
+      SsimSums ref_sums = RandomSums(&rnd);
+      SsimSums test_sums = ref_sums;
+      ref_func(src_ + offset, kStride, ref_ + offset, kStride, &ref_sums.sum_s,
+               &ref_sums.sum_r, &ref_sums.sum_sq_s, &ref_sums.sum_sq_r,
+               &ref_sums.sum_sxr);
+      ASM_REGISTER_STATE_CHECK(test_func(
+          src_ + offset, kStride, ref_ + offset, kStride, &test_sums.sum_s,
+          &test_sums.sum_r, &test_sums.sum_sq_s, &test_sums.sum_sq_r,
+          &test_sums.sum_sxr));
+      ExpectSumsEqual(ref_sums, test_sums);
+    }
+  }
+
+  uint8_t src_[kStride * kStride];
+  uint8_t ref_[kStride * kStride];
+};
+
+TEST_P(SsimParmsTest, RandomValues) { RunTest(false); }
+
+TEST_P(SsimParmsTest, ExtremeValues) { RunTest(true); }
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, SsimParmsTest,
+    ::testing::Values(::testing::make_tuple(&aom_ssim_parms_8x8_c,
+                                            &aom_ssim_parms_8x8_avx2),
+                      ::testing::make_tuple(&aom_ssim_parms_16x16_c,
+                                            &aom_ssim_parms_16x16_avx2)));
+#endif  // HAVE_AVX2
+
+#if CONFIG_AV1_HIGHBITDEPTH
+typedef void (*HighbdSsimParmsFunc)(const uint16_t *s, int sp,
+                                    const uint16_t *r, int rp, uint32_t *sum_s,
+                                    uint32_t *sum_r, uint32_t *sum_sq_s,
+                                    uint32_t *sum_sq_r, uint32_t *sum_sxr);
+typedef ::testing::tuple<HighbdSsimParmsFunc, int> HighbdSsimParmsParam;
+
+class HighbdSsimParmsTest
+    : public ::testing::TestWithParam<HighbdSsimParmsParam> {
+ protected:
+  void RunTest(bool extreme) {
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    const HighbdSsimParmsFunc test_func = GET_PARAM(0);
+    const int bd = GET_PARAM(1);
+    const uint16_t mask = (1 << bd) - 1;
+    for (int iter = 0; iter < kIterations && !HasFailure(); ++iter) {
+      for (int i = 0; i < kStride * kStride; ++i) {
+        src_[i] = extreme ? mask : rnd.Rand16() & mask;
+        ref_[i] = extreme ? mask : rnd.Rand16() & mask;
+      }
+      const int offset = rnd(16);
+      SsimSums ref_sums = RandomSums(&rnd);
+      SsimSums test_sums = ref_sums;
+      aom_highbd_ssim_parms_8x8_c(src_ + offset, kStride, ref_ + offset,
+                                  kStride, &ref_sums.sum_s, &ref_sums.sum_r,
+                                  &ref_sums.sum_sq_s, &ref_sums.sum_sq_r,
+                                  &ref_sums.sum_sxr);
+      ASM_REGISTER_STATE_CHECK(test_func(
+          src_ + offset, kStride, ref_ + offset, kStride, &test_sums.sum_s,
+          &test_sums.sum_r, &test_sums.sum_sq_s, &test_sums.sum_sq_r,
+          &test_sums.sum_sxr));
+      ExpectSumsEqual(ref_sums, test_sums);
+    }
+  }
+
+  uint16_t src_[kStride * kStride];
+  uint16_t ref_[kStride * kStride];
+};
+
+TEST_P(HighbdSsimParmsTest, RandomValues) { RunTest(false); }
+
+TEST_P(HighbdSsimParmsTest, ExtremeValues) { RunTest(true); }
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, HighbdSsimParmsTest,
+    ::testing::Combine(::testing::Values(&aom_highbd_ssim_parms_8x8_avx2),
+                       ::testing::Values(8, 10, 12)));
+#endif  // HAVE_AVX2
+#endif  // CONFIG_AV1_HIGHBITDEPTH
+
+}  // namespace
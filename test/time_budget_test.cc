@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "config/aom_config.h"
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+
+namespace {
+
+// Same as TIME_BUDGET_MAX_LEVEL.
+const int kMaxLevel = 3;
+
+class TimeBudgetTest
+    : public ::libaom_test::CodecTestWithParam<unsigned int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  TimeBudgetTest() : EncoderTest(GET_PARAM(0)), budget_(0), stats_() {}
+  virtual ~TimeBudgetTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_threads = GET_PARAM(1);
+    cfg_.g_lag_in_frames = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AV1E_SET_ROW_MT, 1);
+      encoder->Control(AV1E_SET_FRAME_TIME_BUDGET, budget_);
+    } else {
+      // The hook is called once more to flush the encoder, so the last
+      // statistics cover all the frames.
+      encoder->Control(AV1E_GET_TIME_BUDGET_STATS, &stats_);
+    }
+  }
+
+  void DoTest(unsigned int budget) {
+    budget_ = budget;
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352,
+                                         288, 30, 1, 0, 8);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    EXPECT_EQ(8u, stats_.frames);
+  }
+
+  unsigned int budget_;
+  aom_time_budget_stats_t stats_;
+};
+
+TEST_P(TimeBudgetTest, OverBudget) {
+  DoTest(1);
+  EXPECT_EQ(stats_.frames, stats_.frames_over_budget);
+  EXPECT_EQ(kMaxLevel, stats_.level);
+  EXPECT_EQ(static_cast<unsigned int>(kMaxLevel), stats_.escalations);
+  EXPECT_EQ(0u, stats_.relaxations);
+  // Only a single thread raises the level between the superblock rows.
+  if (GET_PARAM(1) == 1) {
+    EXPECT_GT(stats_.mid_frame_escalations, 0u);
+  } else {
+    EXPECT_EQ(0u, stats_.mid_frame_escalations);
+  }
+}
+
+TEST_P(TimeBudgetTest, WithinBudget) {
+  DoTest(1000000000);
+  EXPECT_EQ(0u, stats_.frames_over_budget);
+  EXPECT_EQ(0, stats_.level);
+  EXPECT_EQ(0u, stats_.escalations);
+}
+
+AV1_INSTANTIATE_TEST_CASE(TimeBudgetTest, ::testing::Values(1u, 2u));
+}  // namespace
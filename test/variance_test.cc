@@ -2289,6 +2289,27 @@ INSTANTIATE_TEST_CASE_P(
                                 0)));
 #endif  // HAVE_AVX2
 
+#if HAVE_AVX512
+INSTANTIATE_TEST_CASE_P(
+    AVX512, AvxVarianceTest,
+    ::testing::Values(VarianceParams(7, 7, &aom_variance128x128_avx512),
+                      VarianceParams(7, 6, &aom_variance128x64_avx512),
+                      VarianceParams(6, 7, &aom_variance64x128_avx512),
+                      VarianceParams(6, 6, &aom_variance64x64_avx512),
+                      VarianceParams(6, 5, &aom_variance64x32_avx512),
+                      VarianceParams(6, 4, &aom_variance64x16_avx512)));
+
+INSTANTIATE_TEST_CASE_P(
+    AVX512, AvxSubpelVarianceTest,
+    ::testing::Values(
+        SubpelVarianceParams(7, 7, &aom_sub_pixel_variance128x128_avx512, 0),
+        SubpelVarianceParams(7, 6, &aom_sub_pixel_variance128x64_avx512, 0),
+        SubpelVarianceParams(6, 7, &aom_sub_pixel_variance64x128_avx512, 0),
+        SubpelVarianceParams(6, 6, &aom_sub_pixel_variance64x64_avx512, 0),
+        SubpelVarianceParams(6, 5, &aom_sub_pixel_variance64x32_avx512, 0),
+        SubpelVarianceParams(6, 4, &aom_sub_pixel_variance64x16_avx512, 0)));
+#endif  // HAVE_AVX512
+
 #if HAVE_NEON
 INSTANTIATE_TEST_CASE_P(NEON, AvxSseTest,
                         ::testing::Values(SseParams(2, 2,
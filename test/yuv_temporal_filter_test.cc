@@ -723,4 +723,13 @@ INSTANTIATE_TEST_CASE_P(
         TemporalFilterWithBd(&av1_highbd_apply_temporal_filter_sse4_1, 12)));
 #endif  // HAVE_SSE4_1
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, YUVTemporalFilterTest,
+    ::testing::Values(
+        TemporalFilterWithBd(&av1_apply_temporal_filter_avx2, 8),
+        TemporalFilterWithBd(&av1_highbd_apply_temporal_filter_avx2, 10),
+        TemporalFilterWithBd(&av1_highbd_apply_temporal_filter_avx2, 12)));
+#endif  // HAVE_AVX2
+
 }  // namespace